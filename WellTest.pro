@@ -1,7 +1,7 @@
 ######################################################################
 # Automatically generated by qmake (3.1) Mon May 19 10:02:11 2025
 ######################################################################
-QT += core gui axcontainer svg printsupport core5compat concurrent
+QT += core gui axcontainer svg printsupport core5compat concurrent network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -34,15 +34,19 @@ HEADERS += dataeditorwidget.h \
            datacalculate.h \
            datacolumndialog.h \
            dataimportdialog.h \
+           dualnumber.h \
+           doubledouble.h \
            fittingdatadialog.h \
            fittingpage.h \
            fittingparameterchart.h \
+           initialguesssearch.h \
            modelenums.h \
            modelmanager.h \
            modelparameter.h \
            modelselect.h \
            modelsolver01_06.h \
            mousezoom.h \
+           scatterlod.h \
            newprojectdialog.h \
            paramselectdialog.h \
            mainwindow.h \
@@ -55,6 +59,26 @@ HEADERS += dataeditorwidget.h \
            plottingdialog4.h \
            pressurederivativecalculator.h \
            pressurederivativecalculator1.h \
+           parameterschema.h \
+           sensitivityengine.h \
+           uncertaintyanalysis.h \
+           ratesuperposition.h \
+           deconvolution.h \
+           deconvolutiondialog.h \
+           splinecurveevaluator.h \
+           stehfestprecision.h \
+           stehfestbenchmark.h \
+           bourdetbenchmark.h \
+           cancellationtoken.h \
+           progressmailbox.h \
+           plotdatasource.h \
+           livecurvepreview.h \
+           spscringbuffer.h \
+           gaugeacquisition.h \
+           livegaugewidget.h \
+           typecurveatlas.h \
+           reportgenerator.h \
+           numericexport.h \
            settingswidget.h \
            qcustomplot.h \
            wt_fittingwidget.h \
@@ -100,11 +124,13 @@ SOURCES += \
            fittingdatadialog.cpp \
            fittingpage.cpp \
            fittingparameterchart.cpp \
+           initialguesssearch.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
            modelselect.cpp \
            modelsolver01_06.cpp \
            mousezoom.cpp \
+           scatterlod.cpp \
            newprojectdialog.cpp \
            paramselectdialog.cpp \
            main.cpp \
@@ -118,6 +144,23 @@ SOURCES += \
            plottingdialog4.cpp \
            pressurederivativecalculator.cpp \
            pressurederivativecalculator1.cpp \
+           parameterschema.cpp \
+           sensitivityengine.cpp \
+           uncertaintyanalysis.cpp \
+           ratesuperposition.cpp \
+           deconvolution.cpp \
+           deconvolutiondialog.cpp \
+           splinecurveevaluator.cpp \
+           stehfestprecision.cpp \
+           plotdatasource.cpp \
+           livecurvepreview.cpp \
+           gaugeacquisition.cpp \
+           livegaugewidget.cpp \
+           stehfestbenchmark.cpp \
+           bourdetbenchmark.cpp \
+           reportgenerator.cpp \
+           numericexport.cpp \
+           typecurveatlas.cpp \
            settingswidget.cpp \
            qcustomplot.cpp \
            wt_fittingwidget.cpp \
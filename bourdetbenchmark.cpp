@@ -0,0 +1,202 @@
+/*
+ * bourdetbenchmark.cpp
+ * 文件作用: 增量 Bourdet 导数一致性与耗时的微基准实现文件
+ * 功能描述:
+ * 1. 对照实现为 PressureDerivativeCalculator::signedBourdetDerivative (逐点搜索) 取绝对值，
+ *    比较时按 double 的位模式逐点比较，不设容差。
+ * 2. 压差为 ln t 与 √t 的组合加随机噪声，噪声使部分点的导数变号，同时覆盖取绝对值的分支。
+ * 3. 随机数只由 --seed 决定，同一种子的结果可复现。
+ */
+
+#include "bourdetbenchmark.h"
+#include "pressurederivativecalculator.h"
+
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QVector>
+#include <random>
+#include <cstring>
+#include <cmath>
+
+namespace {
+
+enum TimeLayout {
+    Layout_Log,         // 对数均匀 (试井数据的常见采样)
+    Layout_Linear,      // 线性均匀 (早期点在 L 间距内不足，走相邻差分保底)
+    Layout_Clustered    // 疏密交替 (左右点跨越多个采样)
+};
+
+const char* layoutName(TimeLayout layout)
+{
+    switch (layout) {
+    case Layout_Log: return "对数均匀";
+    case Layout_Linear: return "线性均匀";
+    default: return "疏密交替";
+    }
+}
+
+// 严格递增的正时间序列 (对数类采样跨约 8 个十倍程，与点数无关)
+QVector<double> makeTime(int n, TimeLayout layout, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    const double meanLogStep = std::log(1e8) / n;
+    QVector<double> t(n);
+    double cur = 1e-3 * (0.5 + u(rng));
+    for (int i = 0; i < n; ++i) {
+        t[i] = cur;
+        double step = 0.0;
+        switch (layout) {
+        case Layout_Log: step = cur * std::expm1(meanLogStep * (0.1 + 1.8 * u(rng))); break;
+        case Layout_Linear: step = (100.0 / n) * (0.5 + u(rng)); break;
+        default: step = cur * std::expm1(meanLogStep * (((i / 50) % 2) ? 1.9 : 0.1) * (0.5 + u(rng))); break;
+        }
+        cur += step;
+    }
+    return t;
+}
+
+QVector<double> makePressure(const QVector<double>& t, double noise, std::mt19937& rng)
+{
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    QVector<double> p(t.size());
+    for (int i = 0; i < t.size(); ++i) p[i] = 2.0 * std::log(t[i] / t[0] + 1.0) + 0.3 * std::sqrt(t[i]) + noise * gauss(rng);
+    return p;
+}
+
+QVector<double> reference(const QVector<double>& t, const QVector<double>& p, double lSpacing)
+{
+    QVector<double> d = PressureDerivativeCalculator::signedBourdetDerivative(t, p, lSpacing);
+    for (double& v : d) v = std::abs(v);
+    return d;
+}
+
+// 位模式不同的点数
+int countMismatch(const QVector<double>& a, const QVector<double>& b, int n)
+{
+    if (a.size() < n || b.size() < n) return n;
+    int bad = 0;
+    for (int i = 0; i < n; ++i) {
+        if (std::memcmp(&a[i], &b[i], sizeof(double)) != 0) ++bad;
+    }
+    return bad;
+}
+
+} // namespace
+
+int BourdetBenchmark::runCli(const QStringList& args)
+{
+    QTextStream out(stdout);
+    quint32 seed = 12345;
+    int nTiming = 200000;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--seed" && i + 1 < args.size()) seed = args[++i].toUInt();
+        else if (args[i] == "--points" && i + 1 < args.size()) nTiming = args[++i].toInt();
+    }
+    if (nTiming < 10) {
+        out << "用法: WellTest --bench-bourdet [--seed <随机种子>] [--points <耗时测试点数>]\n";
+        return 1;
+    }
+
+    std::mt19937 rng(seed);
+    const QVector<TimeLayout> layouts = {Layout_Log, Layout_Linear, Layout_Clustered};
+    const QVector<double> spacings = {0.05, 0.1, 0.15, 0.3};
+    bool allPassed = true;
+
+    // 1. 批量建立 / 逐点追加与逐点搜索逐位比较
+    out << "一致性 (种子 " << seed << "): 与逐点搜索结果位模式不同的点数 (批量 / 追加)\n";
+    for (TimeLayout layout : layouts) {
+        for (int n : {3, 50, 2000, 20000}) {
+            const QVector<double> t = makeTime(n, layout, rng);
+            const QVector<double> p = makePressure(t, n > 3 ? 0.02 : 0.0, rng);
+            QString line = QString("  %1 n=%2 ").arg(layoutName(layout)).arg(n, 5);
+            for (double L : spacings) {
+                const QVector<double> ref = reference(t, p, L);
+                IncrementalBourdetDerivative batch(L);
+                int badBatch = batch.assign(t, p) ? countMismatch(batch.derivative(), ref, n) : n;
+                IncrementalBourdetDerivative stream(L);
+                for (int i = 0; i < n; ++i) stream.append(t[i], p[i]);
+                int badStream = countMismatch(stream.derivative(), ref, n);
+                allPassed = allPassed && badBatch == 0 && badStream == 0;
+                line += QString(" L=%1: %2/%3").arg(L).arg(badBatch).arg(badStream);
+            }
+            out << line << "\n";
+            out.flush();
+        }
+    }
+
+    // 2. 追加过程中每个前缀的结果
+    {
+        int badPrefixes = 0, checked = 0;
+        for (TimeLayout layout : layouts) {
+            const QVector<double> t = makeTime(300, layout, rng);
+            const QVector<double> p = makePressure(t, 0.02, rng);
+            for (double L : spacings) {
+                IncrementalBourdetDerivative stream(L);
+                for (int i = 0; i < t.size(); ++i) {
+                    stream.append(t[i], p[i]);
+                    const QVector<double> ref = reference(t.mid(0, i + 1), p.mid(0, i + 1), L);
+                    if (countMismatch(stream.derivative(), ref, i + 1) != 0) ++badPrefixes;
+                    ++checked;
+                }
+            }
+        }
+        allPassed = allPassed && badPrefixes == 0;
+        out << QString("逐点追加: 检查 %1 个前缀，%2 个与逐点搜索不同\n").arg(checked).arg(badPrefixes);
+    }
+
+    // 3. 导数偏导与中心差分 (导数对压差分段线性，差分只有舍入误差)
+    {
+        double worst = 0.0;
+        for (TimeLayout layout : layouts) {
+            const QVector<double> t = makeTime(500, layout, rng);
+            const QVector<double> p = makePressure(t, 0.02, rng);
+            const QVector<double> dp = makePressure(t, 0.5, rng);
+            const double h = 1e-5;
+            QVector<double> plus(p.size()), minus(p.size());
+            for (int i = 0; i < p.size(); ++i) { plus[i] = p[i] + h * dp[i]; minus[i] = p[i] - h * dp[i]; }
+            const QVector<double> base = PressureDerivativeCalculator::calculateBourdetDerivative(t, p, 0.1);
+            const QVector<double> dPlus = PressureDerivativeCalculator::calculateBourdetDerivative(t, plus, 0.1);
+            const QVector<double> dMinus = PressureDerivativeCalculator::calculateBourdetDerivative(t, minus, 0.1);
+            const QVector<double> sens = PressureDerivativeCalculator::calculateBourdetSensitivity(t, p, {dp}, 0.1).first();
+            for (int i = 0; i < p.size(); ++i) {
+                // 导数接近 0 的点在扰动内可能变号 (绝对值的折点)，不参与比较
+                if (base[i] < 1e-4) continue;
+                double fd = (dPlus[i] - dMinus[i]) / (2.0 * h);
+                worst = qMax(worst, std::abs(sens[i] - fd) / qMax(1.0, std::abs(fd)));
+            }
+        }
+        allPassed = allPassed && worst < 1e-6;
+        out << QString("导数偏导与中心差分的最大偏差: %1\n").arg(worst, 0, 'e', 2);
+    }
+
+    // 4. 耗时
+    {
+        const QVector<double> t = makeTime(nTiming, Layout_Log, rng);
+        const QVector<double> p = makePressure(t, 0.02, rng);
+        const double L = 0.15;
+        QElapsedTimer timer;
+
+        timer.start();
+        QVector<double> ref = reference(t, p, L);
+        const double msSearch = timer.nsecsElapsed() / 1e6;
+
+        timer.start();
+        IncrementalBourdetDerivative batch(L);
+        batch.assign(t, p);
+        const double msBatch = timer.nsecsElapsed() / 1e6;
+
+        timer.start();
+        IncrementalBourdetDerivative stream(L);
+        for (int i = 0; i < t.size(); ++i) stream.append(t[i], p[i]);
+        const double msStream = timer.nsecsElapsed() / 1e6;
+
+        out << QString("耗时 (%1 点, L=%2):\n").arg(nTiming).arg(L);
+        out << QString("  逐点搜索  %1 ms\n").arg(msSearch, 0, 'f', 2);
+        out << QString("  批量建立  %1 ms\n").arg(msBatch, 0, 'f', 2);
+        out << QString("  逐点追加  %1 ms (每点 %2 ns)\n").arg(msStream, 0, 'f', 2).arg(msStream * 1e6 / nTiming, 0, 'f', 1);
+        if (countMismatch(batch.derivative(), ref, nTiming) != 0) allPassed = false;
+    }
+
+    out << (allPassed ? "结果: 全部一致\n" : "结果: 存在不一致\n");
+    return allPassed ? 0 : 2;
+}
@@ -0,0 +1,25 @@
+/*
+ * bourdetbenchmark.h
+ * 文件作用: 增量 Bourdet 导数一致性与耗时的微基准头文件 (命令行 --bench-bourdet)
+ * 功能描述:
+ * 1. 一致性: 随机生成多组严格递增时间序列 (对数均匀 / 线性均匀 / 疏密交替) 与压差，
+ *    比较 IncrementalBourdetDerivative (批量建立与逐点追加) 与逐点搜索实现的结果是否逐位相同；
+ *    小规模算例另外逐点检查追加过程中每个前缀的结果。
+ * 2. 偏导: calculateBourdetSensitivity 与中心差分的最大相对偏差 (拟合雅可比使用)。
+ * 3. 耗时: 大规模序列上逐点搜索、批量建立与逐点追加三种方式的耗时。
+ */
+
+#ifndef BOURDETBENCHMARK_H
+#define BOURDETBENCHMARK_H
+
+#include <QStringList>
+
+class BourdetBenchmark
+{
+public:
+    // 用法: WellTest --bench-bourdet [--seed <随机种子>] [--points <耗时测试点数>]
+    // 全部一致性检查通过时返回 0，否则返回 2
+    static int runCli(const QStringList& args);
+};
+
+#endif // BOURDETBENCHMARK_H
@@ -0,0 +1,40 @@
+/*
+ * cancellationtoken.h
+ * 文件作用: 协作式取消令牌
+ * 功能描述:
+ * 1. 令牌的拷贝共享同一个原子标志，界面线程调用 cancel() 后，
+ *    持有拷贝的全部工作线程 (含 QtConcurrent 并行任务) 都能立即观察到。
+ * 2. 求解器在每个时间点、拟合在每次曲线计算与雅可比列之间检查令牌，
+ *    使停止操作在一个时间点的计算量内得到响应，而不必等待整轮迭代结束。
+ * 3. 默认构造的令牌不可取消 (不分配标志)，作为各计算接口的缺省实参，开销可忽略。
+ * 4. 每次启动新任务时用 create() 生成新令牌，旧任务仍持有已取消的旧令牌，互不干扰。
+ */
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QAtomicInt>
+#include <QSharedPointer>
+
+class CancellationToken
+{
+public:
+    CancellationToken() {}
+
+    // 生成一个可取消的新令牌
+    static CancellationToken create() {
+        CancellationToken token;
+        token.m_flag.reset(new QAtomicInt(0));
+        return token;
+    }
+
+    // 请求取消 (任意线程可调用)
+    void cancel() const { if (m_flag) m_flag->storeRelease(1); }
+
+    bool isCancelled() const { return m_flag && m_flag->loadAcquire() != 0; }
+
+private:
+    QSharedPointer<QAtomicInt> m_flag;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -662,8 +662,45 @@ void DataEditorWidget::onDeleteCol()
     updateButtonsState();
 }
 
-void DataEditorWidget::onModelDataChanged()
+// 单元格编辑: 修改压力值时同步更新压降列。压降只依赖本行压力与首个有效压力，
+// 一般只改写本行；修改的是首个有效压力 (压降基准) 时才整列重算。
+void DataEditorWidget::onModelDataChanged(QStandardItem* item)
 {
+    if (!item) return;
+
+    int pIdx = -1, dropIdx = -1;
+    for (int i = 0; i < m_columnDefinitions.size() && i < m_dataModel->columnCount(); ++i) {
+        if (m_columnDefinitions[i].type == WellTestColumnType::Pressure && pIdx < 0) pIdx = i;
+        if (m_columnDefinitions[i].type == WellTestColumnType::PressureDrop) dropIdx = i;
+    }
+    if (pIdx < 0 || dropIdx < 0 || item->column() != pIdx) return;
+
+    // 首个有效压力所在行
+    int baseRow = -1;
+    double basePressure = 0.0;
+    for (int i = 0; i < m_dataModel->rowCount() && baseRow < 0; ++i) {
+        QStandardItem* pItem = m_dataModel->item(i, pIdx);
+        bool ok = false;
+        if (pItem) basePressure = pItem->text().toDouble(&ok);
+        if (ok) baseRow = i;
+    }
+
+    auto updateRow = [&](int row) {
+        QStandardItem* pItem = m_dataModel->item(row, pIdx);
+        bool ok = false;
+        const double p = pItem ? pItem->text().toDouble(&ok) : 0.0;
+        const QString text = ok ? QString::number(basePressure - p, 'f', 3) : QString();
+        QStandardItem* dropItem = m_dataModel->item(row, dropIdx);
+        if (!dropItem) m_dataModel->setItem(row, dropIdx, new QStandardItem(text));
+        else if (dropItem->text() != text) dropItem->setText(text);
+    };
+
+    const int row = item->row();
+    if (row <= baseRow || baseRow < 0) {
+        for (int i = 0; i < m_dataModel->rowCount(); ++i) updateRow(i);
+    } else {
+        updateRow(row);
+    }
 }
 
 
@@ -124,8 +124,8 @@ private slots:
     // 删除选中列
     void onDeleteCol();
 
-    // 模型数据变化时的通用处理槽
-    void onModelDataChanged();
+    // 单元格数据变化: 编辑压力值时同步更新压降列 (只改写受影响的行)
+    void onModelDataChanged(QStandardItem* item);
 
 private:
     Ui::DataEditorWidget *ui;
@@ -0,0 +1,527 @@
+/*
+ * deconvolution.cpp
+ * 文件作用: 压力-产量反褶积实现文件
+ * 功能描述:
+ * 1. 节点模型: σ_k = ln(t_0) + k·h，z 在节点间对 σ 线性，
+ *    p_u(σ_k) = P_k = e^{z_0} + Σ_{s≤k} I_s，段积分 I_s = h·(e^{z_s} - e^{z_{s-1}})/(z_s - z_{s-1})。
+ * 2. 第 i 个压力点的压差 Δp_i = Σ_j Δq_j·p_u(t_i - τ_j)，对 z 的偏导由
+ *    "落在各节点区间的 Δq 之和" 的后缀和乘以段积分偏导得到，逐行并行累加 JᵀJ 与 Jᵀr。
+ * 3. 产量修正步: Δp = V·D·q (V_ij = p_u(t_i - τ_j)，D 为差分)，共轭梯度只用到 V 的矩阵-向量乘积。
+ *    V 为下三角阶段结构 (第 i 行只有 t_i 之前开始的阶段)，不显式保存: V·d 按行分块、Vᵀ·v 按阶段分块
+ *    (第 j 列只含 t_i > τ_j 的后缀行) 并行即时求值，内存与阶段数无关。
+ */
+
+#include "deconvolution.h"
+
+#include <QtConcurrent>
+#include <Eigen/Dense>
+#include <numeric>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// φ(x) = (e^x - 1)/x 及其导数 (小 x 时用级数避免相消)
+inline double phi(double x)
+{
+    return std::abs(x) < 1e-3 ? 1.0 + x * (0.5 + x / 6.0) : std::expm1(x) / x;
+}
+
+inline double phiPrime(double x)
+{
+    return std::abs(x) < 1e-3 ? 0.5 + x * (1.0 / 3.0 + x / 8.0) : (std::exp(x) * (x - 1.0) + 1.0) / (x * x);
+}
+
+// 节点模型 (z → P_k 及段积分偏导)
+struct NodeModel {
+    double sigma0 = 0.0;
+    double h = 1.0;
+    int n = 0;
+    std::vector<double> z, ez, P;
+    std::vector<double> dIa, dIb;   // ∂I_s/∂z_{s-1}、∂I_s/∂z_s (s = 1..n-1)
+
+    void update(const double* zv)
+    {
+        z.assign(zv, zv + n);
+        ez.resize(n); P.resize(n); dIa.assign(n, 0.0); dIb.assign(n, 0.0);
+        for (int k = 0; k < n; ++k) ez[k] = std::exp(z[k]);
+        P[0] = ez[0];
+        for (int s = 1; s < n; ++s) {
+            double d = z[s] - z[s - 1];
+            double I = h * ez[s - 1] * phi(d);
+            dIb[s] = h * ez[s - 1] * phiPrime(d);
+            dIa[s] = I - dIb[s];
+            P[s] = P[s - 1] + I;
+        }
+    }
+
+    // 时滞 u 处的 p_u；cum/local 非空时累加权重 w 的偏导信息:
+    // cum[k] += w 表示该项含 P_k，local 为段内部分对 z 的直接偏导
+    double value(double u, double w, double* cum, double* local) const
+    {
+        double x = std::log(u);
+        if (x < sigma0) {
+            double v = ez[0] * std::exp(x - sigma0);
+            if (local) local[0] += w * v;
+            return v;
+        }
+        double pos = (x - sigma0) / h;
+        int k = int(pos);
+        if (k >= n - 1) {
+            double dx = x - (sigma0 + (n - 1) * h);
+            if (cum) { cum[n - 1] += w; local[n - 1] += w * ez[n - 1] * dx; }
+            return P[n - 1] + ez[n - 1] * dx;
+        }
+        double s = pos - k;
+        double sd = s * (z[k + 1] - z[k]);
+        double J = h * ez[k] * s * phi(sd);
+        if (cum) {
+            double dJb = h * ez[k] * s * s * phiPrime(sd);
+            cum[k] += w;
+            local[k] += w * (J - dJb);
+            local[k + 1] += w * dJb;
+        }
+        return P[k] + J;
+    }
+
+    // 把 cum (含 P_k 的权重) 展开为对 z 的偏导并加到 grad
+    void expand(const double* cum, double* grad) const
+    {
+        double suffix = 0.0;
+        for (int s = n - 1; s >= 1; --s) {
+            suffix += cum[s];
+            grad[s - 1] += suffix * dIa[s];
+            grad[s] += suffix * dIb[s];
+        }
+        suffix += cum[0];
+        grad[0] += suffix * ez[0];
+    }
+};
+
+// 行分块
+struct RowBlock {
+    int begin = 0;
+    int end = 0;
+    Eigen::MatrixXd H;
+    Eigen::VectorXd b;
+    double sse = 0.0;
+};
+
+QVector<RowBlock> makeBlocks(int rows, int blockSize)
+{
+    QVector<RowBlock> blocks;
+    for (int r = 0; r < rows; r += blockSize) {
+        RowBlock blk;
+        blk.begin = r;
+        blk.end = qMin(rows, r + blockSize);
+        blocks.append(blk);
+    }
+    return blocks;
+}
+
+} // namespace
+
+QVector<int> Deconvolution::decimate(const QVector<double>& t, const RateHistory& rates, int maxPoints)
+{
+    const int n = t.size();
+    QVector<int> result;
+    if (n <= maxPoints || rates.isEmpty()) {
+        result.resize(n);
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+
+    QVector<char> selected(n, 0);
+    const QVector<double>& tau = rates.startTime;
+    const int nStages = rates.size();
+
+    // 首次变产量之前的点只用于确定初始压力，均匀保留少量
+    int nPre = int(std::upper_bound(t.constBegin(), t.constEnd(), tau[0]) - t.constBegin());
+    int preBudget = qMin(nPre, qMax(2, maxPoints / 50));
+    for (int k = 0; k < preBudget; ++k) selected[int((double)k * (nPre - 1) / qMax(1, preBudget - 1))] = 1;
+
+    // 各阶段内按时滞对数等间距取点
+    const int budget = qMax(3, (maxPoints - preBudget) / nStages);
+    for (int j = 0; j < nStages; ++j) {
+        int lo = int(std::upper_bound(t.constBegin(), t.constEnd(), tau[j]) - t.constBegin());
+        int hi = (j + 1 < nStages) ? int(std::upper_bound(t.constBegin(), t.constEnd(), tau[j + 1]) - t.constBegin()) : n;
+        if (hi <= lo) continue;
+        if (hi - lo <= budget) {
+            for (int i = lo; i < hi; ++i) selected[i] = 1;
+            continue;
+        }
+        double uMin = t[lo] - tau[j];
+        double uMax = t[hi - 1] - tau[j];
+        for (int k = 0; k < budget; ++k) {
+            double target = tau[j] + uMin * std::pow(uMax / uMin, (double)k / (budget - 1));
+            int idx = int(std::lower_bound(t.constBegin() + lo, t.constBegin() + hi, target) - t.constBegin());
+            selected[qMin(idx, hi - 1)] = 1;
+        }
+    }
+
+    for (int i = 0; i < n; ++i) {
+        if (selected[i]) result.append(i);
+    }
+    return result;
+}
+
+DeconvolutionResult Deconvolution::run(const QVector<double>& tIn, const QVector<double>& pIn,
+                                       const RateHistory& rates, const DeconvolutionOptions& options,
+                                       const CancellationToken& cancel,
+                                       std::function<void(int, int)> progress)
+{
+    DeconvolutionResult result;
+    result.correctedRates = rates;
+    result.initialPressure = options.initialPressure;
+
+    // 1. 数据整理: 剔除无效值并按时间排序
+    QVector<int> order;
+    for (int i = 0; i < qMin(tIn.size(), pIn.size()); ++i) {
+        if (std::isfinite(tIn[i]) && std::isfinite(pIn[i]) && tIn[i] >= 0.0) order.append(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return tIn[a] < tIn[b]; });
+    QVector<double> tAll, pAll;
+    tAll.reserve(order.size()); pAll.reserve(order.size());
+    for (int i : order) { tAll.append(tIn[i]); pAll.append(pIn[i]); }
+
+    const int nStages = rates.size();
+    if (nStages == 0) { result.message = "产量历史为空。"; return result; }
+    if (tAll.size() < 10) { result.message = "有效压力点不足。"; return result; }
+    if (tAll.last() <= rates.startTime[0]) { result.message = "压力数据均早于首次产量变化。"; return result; }
+
+    QVector<int> keep = decimate(tAll, rates, qMax(50, options.maxPoints));
+    QVector<double> t, p;
+    for (int i : keep) { t.append(tAll[i]); p.append(pAll[i]); }
+    const int m = t.size();
+    const QVector<double>& tau = rates.startTime;
+
+    // 2. 对数节点网格
+    QVector<int> active(m);
+    double uMin = std::numeric_limits<double>::max(), uMax = 0.0;
+    for (int i = 0; i < m; ++i) {
+        active[i] = int(std::lower_bound(tau.constBegin(), tau.constEnd(), t[i]) - tau.constBegin());
+        if (active[i] == 0) continue;
+        uMin = qMin(uMin, t[i] - tau[active[i] - 1]);
+        uMax = qMax(uMax, t[i] - tau[0]);
+    }
+    uMin = qMax(uMin, uMax * 1e-8);
+    if (uMax <= uMin * 1.0001) uMin = uMax / 10.0;
+
+    NodeModel model;
+    model.n = qMax(4, int(std::ceil(std::log10(uMax / uMin) * qMax(2, options.nodesPerDecade))) + 1);
+    model.sigma0 = std::log(uMin);
+    model.h = std::log(uMax / uMin) / (model.n - 1);
+    const int n = model.n;
+
+    // 3. 量纲归一化: E = Σ(r/σp)²/m + λ·Σ曲率²/(n-2) + ν·Σ((q - q_m)/σq)²/N
+    QVector<double> qMeas = rates.rate;
+    QVector<double> q = qMeas;
+    const double qScale = qMax(rates.maxAbsRate(), 1e-12);
+    double meanRate = std::accumulate(qMeas.constBegin(), qMeas.constEnd(), 0.0);
+    const bool producer = meanRate >= 0.0;
+
+    double pMax = *std::max_element(p.constBegin(), p.constEnd());
+    double pMin = *std::min_element(p.constBegin(), p.constEnd());
+    const bool estP0 = options.estimateInitialPressure;
+    double p0 = estP0 ? (producer ? pMax : pMin) : options.initialPressure;
+    double pScale = estP0 ? (pMax - pMin) : qMax(std::abs(p0 - pMax), std::abs(p0 - pMin));
+    if (!(pScale > 0.0)) { result.message = "压力数据没有变化。"; return result; }
+
+    const double wD2 = 1.0 / (pScale * pScale * m);
+    const double wR2 = qMax(0.0, options.regularization) / qMax(1, n - 2);
+    const double wQ2 = qMax(0.0, options.rateWeight) / (qScale * qScale * nStages);
+    const double invH2 = 1.0 / (model.h * model.h);
+
+    QVector<double> dq(nStages);
+    auto updateChanges = [&]() {
+        for (int j = 0; j < nStages; ++j) dq[j] = q[j] - (j > 0 ? q[j - 1] : 0.0);
+    };
+    updateChanges();
+
+    // 初值: 常数 z，使末时刻压差量级与实测一致
+    const int nx = n + (estP0 ? 1 : 0);
+    Eigen::VectorXd x(nx);
+    x.head(n).setConstant(std::log(pScale / (qScale * (1.0 + std::log(uMax / uMin)))));
+    if (estP0) x(n) = p0;
+
+    const QVector<RowBlock> blockTemplate = makeBlocks(m, 64);
+    const QVector<RowBlock> stageBlocks = makeBlocks(nStages, 16);
+    // 第 j 阶段起作用的第一行 (t_i > τ_j)
+    QVector<int> firstRow(nStages);
+    for (int j = 0; j < nStages; ++j) firstRow[j] = int(std::upper_bound(t.constBegin(), t.constEnd(), tau[j]) - t.constBegin());
+
+    // 4. (z, p0) 的目标函数与法方程，按行分块并行累加
+    auto assemble = [&](const Eigen::VectorXd& xv, bool wantNormal, Eigen::MatrixXd* H, Eigen::VectorXd* b) -> double {
+        NodeModel nm = model;
+        nm.update(xv.data());
+        const double p0v = estP0 ? xv(n) : p0;
+        QVector<RowBlock> blocks = blockTemplate;
+
+        QtConcurrent::blockingMap(blocks, [&](RowBlock& blk) {
+            if (cancel.isCancelled()) return;
+            std::vector<double> cum, local;
+            Eigen::VectorXd g;
+            if (wantNormal) {
+                blk.H = Eigen::MatrixXd::Zero(nx, nx);
+                blk.b = Eigen::VectorXd::Zero(nx);
+                cum.resize(n); local.resize(n);
+                g.resize(nx);
+            }
+            for (int i = blk.begin; i < blk.end; ++i) {
+                if (wantNormal) {
+                    std::fill(cum.begin(), cum.end(), 0.0);
+                    std::fill(local.begin(), local.end(), 0.0);
+                }
+                double dp = 0.0;
+                for (int j = 0; j < active[i]; ++j) {
+                    if (dq[j] == 0.0) continue;
+                    dp += dq[j] * nm.value(t[i] - tau[j], dq[j],
+                                           wantNormal ? cum.data() : nullptr,
+                                           wantNormal ? local.data() : nullptr);
+                }
+                double r = p0v - dp - p[i];
+                blk.sse += r * r;
+                if (!wantNormal) continue;
+
+                // ∂r/∂z = -∂Δp/∂z，∂r/∂p0 = 1
+                g.setZero();
+                nm.expand(cum.data(), g.data());
+                for (int k = 0; k < n; ++k) g(k) = -(g(k) + local[k]);
+                if (estP0) g(n) = 1.0;
+                blk.H.selfadjointView<Eigen::Lower>().rankUpdate(g);
+                blk.b.noalias() += g * r;
+            }
+        });
+
+        if (cancel.isCancelled()) return std::numeric_limits<double>::infinity();
+        double sse = 0.0;
+        if (wantNormal) { H->setZero(nx, nx); b->setZero(nx); }
+        for (const RowBlock& blk : blocks) {
+            sse += blk.sse;
+            if (wantNormal) { *H += blk.H; *b += blk.b; }
+        }
+        double energy = wD2 * sse;
+        if (wantNormal) {
+            Eigen::MatrixXd full = H->selfadjointView<Eigen::Lower>();
+            *H = wD2 * full;
+            *b *= wD2;
+        }
+
+        // 曲率正则化 (带状)
+        for (int k = 1; k < n - 1; ++k) {
+            double c = (xv(k - 1) - 2.0 * xv(k) + xv(k + 1)) * invH2;
+            energy += wR2 * c * c;
+            if (!wantNormal) continue;
+            const int idx[3] = {k - 1, k, k + 1};
+            const double e[3] = {invH2, -2.0 * invH2, invH2};
+            for (int a = 0; a < 3; ++a) {
+                (*b)(idx[a]) += wR2 * e[a] * c;
+                for (int bb = 0; bb < 3; ++bb) (*H)(idx[a], idx[bb]) += wR2 * e[a] * e[bb];
+            }
+        }
+        return energy;
+    };
+
+    // 产量惩罚项 (z 步中为常数)
+    auto rateEnergy = [&]() {
+        double e = 0.0;
+        for (int j = 0; j < nStages; ++j) e += (q[j] - qMeas[j]) * (q[j] - qMeas[j]);
+        return wQ2 * e;
+    };
+
+    // 5. 产量修正步: 固定 z，对 y = [q; p0] 解线性最小二乘 (共轭梯度)
+    auto correctRates = [&]() {
+        NodeModel nm = model;
+        nm.update(x.data());
+        auto V = [&](int i, int j) { return nm.value(t[i] - tau[j], 0.0, nullptr, nullptr); };
+
+        // V·d: 按行分块，第 i 行只含 j < active[i]
+        auto applyV = [&](const Eigen::VectorXd& d) -> Eigen::VectorXd {
+            Eigen::VectorXd out(m);
+            QVector<RowBlock> blocks = blockTemplate;
+            QtConcurrent::blockingMap(blocks, [&](RowBlock& blk) {
+                for (int i = blk.begin; i < blk.end; ++i) {
+                    double s = 0.0;
+                    for (int j = 0; j < active[i]; ++j) s += V(i, j) * d(j);
+                    out(i) = s;
+                }
+            });
+            return out;
+        };
+        // Vᵀ·v: 按阶段分块，第 j 列只含 i ≥ firstRow[j]
+        auto applyVt = [&](const Eigen::VectorXd& v) -> Eigen::VectorXd {
+            Eigen::VectorXd out(nStages);
+            QVector<RowBlock> blocks = stageBlocks;
+            QtConcurrent::blockingMap(blocks, [&](RowBlock& blk) {
+                for (int j = blk.begin; j < blk.end; ++j) {
+                    double s = 0.0;
+                    for (int i = firstRow[j]; i < m; ++i) s += V(i, j) * v(i);
+                    out(j) = s;
+                }
+            });
+            return out;
+        };
+
+        const int ny = nStages + (estP0 ? 1 : 0);
+        Eigen::Map<const Eigen::VectorXd> pv(p.constData(), m);
+        Eigen::VectorXd target = estP0 ? Eigen::VectorXd(pv) : Eigen::VectorXd(pv.array() - p0);
+
+        // B·y = -V·D·q (+ p0)，Bᵀ·v = [-Dᵀ·Vᵀ·v; Σv]
+        auto applyB = [&](const Eigen::VectorXd& y) -> Eigen::VectorXd {
+            Eigen::VectorXd d(nStages);
+            for (int j = 0; j < nStages; ++j) d(j) = y(j) - (j > 0 ? y(j - 1) : 0.0);
+            Eigen::VectorXd out = -applyV(d);
+            if (estP0) out.array() += y(nStages);
+            return out;
+        };
+        auto applyBt = [&](const Eigen::VectorXd& v) -> Eigen::VectorXd {
+            Eigen::VectorXd w = applyVt(v);
+            Eigen::VectorXd out(ny);
+            for (int j = 0; j < nStages; ++j) out(j) = -(w(j) - (j + 1 < nStages ? w(j + 1) : 0.0));
+            if (estP0) out(nStages) = v.sum();
+            return out;
+        };
+        auto applyM = [&](const Eigen::VectorXd& y) -> Eigen::VectorXd {
+            Eigen::VectorXd out = wD2 * applyBt(applyB(y));
+            out.head(nStages) += wQ2 * y.head(nStages);
+            return out;
+        };
+
+        Eigen::VectorXd rhs = wD2 * applyBt(target);
+        for (int j = 0; j < nStages; ++j) rhs(j) += wQ2 * qMeas[j];
+
+        // Jacobi 预条件: diag(BᵀB)_j = ||V_j - V_{j+1}||² (第 j+1 列在 firstRow[j+1] 之前为 0)
+        Eigen::VectorXd diag(ny);
+        {
+            QVector<RowBlock> blocks = stageBlocks;
+            QtConcurrent::blockingMap(blocks, [&](RowBlock& blk) {
+                for (int j = blk.begin; j < blk.end && !cancel.isCancelled(); ++j) {
+                    const int next = (j + 1 < nStages) ? firstRow[j + 1] : m;
+                    double s2 = 0.0;
+                    for (int i = firstRow[j]; i < m; ++i) {
+                        double e = V(i, j) - (i >= next ? V(i, j + 1) : 0.0);
+                        s2 += e * e;
+                    }
+                    diag(j) = wD2 * s2 + wQ2;
+                }
+            });
+        }
+        if (cancel.isCancelled()) return;
+        if (estP0) diag(nStages) = wD2 * m;
+        for (int j = 0; j < ny; ++j) if (!(diag(j) > 0.0)) diag(j) = 1.0;
+
+        Eigen::VectorXd y(ny);
+        for (int j = 0; j < nStages; ++j) y(j) = q[j];
+        if (estP0) y(nStages) = x(n);
+
+        Eigen::VectorXd r = rhs - applyM(y);
+        Eigen::VectorXd zv = r.cwiseQuotient(diag);
+        Eigen::VectorXd dir = zv;
+        double rz = r.dot(zv);
+        const double tol2 = 1e-20 * rhs.squaredNorm();
+        for (int it = 0; it < qMin(4 * ny, 500) && r.squaredNorm() > tol2; ++it) {
+            if (cancel.isCancelled()) return;
+            Eigen::VectorXd Md = applyM(dir);
+            double alpha = rz / dir.dot(Md);
+            y += alpha * dir;
+            r -= alpha * Md;
+            zv = r.cwiseQuotient(diag);
+            double rzNew = r.dot(zv);
+            dir = zv + (rzNew / rz) * dir;
+            rz = rzNew;
+        }
+
+        for (int j = 0; j < nStages; ++j) q[j] = y(j);
+        if (estP0) x(n) = y(nStages);
+        updateChanges();
+    };
+
+    // 6. 交替迭代
+    Eigen::MatrixXd H;
+    Eigen::VectorXd b;
+    double mu = 1e-3;
+    double energy = assemble(x, true, &H, &b) + rateEnergy();
+    const int maxOuter = qMax(1, options.maxIterations);
+    int outer = 0;
+    for (; outer < maxOuter; ++outer) {
+        if (cancel.isCancelled()) break;
+        const double energyStart = energy;
+        mu = qMin(mu, 1e2);
+
+        // (z, p0) 的 Levenberg-Marquardt 步
+        for (int inner = 0; inner < 5; ++inner) {
+            const double base = energy - rateEnergy();
+            bool accepted = false;
+            while (mu < 1e10 && !cancel.isCancelled()) {
+                Eigen::MatrixXd A = H;
+                A.diagonal() += mu * H.diagonal().cwiseMax(1e-12);
+                Eigen::VectorXd delta = A.ldlt().solve(-b);
+                // 单步 z 变化限制在 ±2 (导数变化不超过 e² 倍)
+                double maxDz = delta.head(n).cwiseAbs().maxCoeff();
+                if (maxDz > 2.0) delta *= 2.0 / maxDz;
+                Eigen::VectorXd xTrial = x + delta;
+                Eigen::MatrixXd Ht;
+                Eigen::VectorXd bt;
+                double eTrial = assemble(xTrial, true, &Ht, &bt);
+                if (std::isfinite(eTrial) && eTrial < base) {
+                    accepted = (base - eTrial) > 1e-10 * base;
+                    x = xTrial; H = Ht; b = bt;
+                    energy = eTrial + rateEnergy();
+                    mu = qMax(mu / 3.0, 1e-9);
+                    break;
+                }
+                mu *= 4.0;
+            }
+            if (!accepted) break;
+        }
+
+        if (options.correctRates && !cancel.isCancelled()) {
+            correctRates();
+            energy = assemble(x, true, &H, &b) + rateEnergy();
+        }
+
+        if (progress) progress(outer + 1, maxOuter);
+        if (std::abs(energyStart - energy) <= 1e-7 * qMax(energy, 1e-30)) { outer++; break; }
+    }
+    if (cancel.isCancelled()) { result.message = "反褶积已停止。"; return result; }
+
+    // 7. 输出: 参考产量下的响应与导数、修正产量、质量检查数据
+    model.update(x.data());
+    if (estP0) p0 = x(n);
+
+    double qRef = 0.0;
+    for (double v : q) qRef = qMax(qRef, std::abs(v));
+    if (!(qRef > 0.0)) qRef = 1.0;
+
+    result.lag.resize(n);
+    result.pressure.resize(n);
+    result.derivative.resize(n);
+    for (int k = 0; k < n; ++k) {
+        result.lag[k] = std::exp(model.sigma0 + k * model.h);
+        result.pressure[k] = qRef * model.P[k];
+        result.derivative[k] = qRef * model.ez[k];
+    }
+    result.referenceRate = qRef;
+    result.initialPressure = p0;
+    result.correctedRates.rate = q;
+    for (int j = 0; j < nStages; ++j) result.maxRateChange = qMax(result.maxRateChange, std::abs(q[j] - qMeas[j]) / qScale);
+
+    result.fitTime = t;
+    result.fitPressure = p;
+    result.modelPressure.resize(m);
+    double sse = 0.0;
+    for (int i = 0; i < m; ++i) {
+        double dp = 0.0;
+        for (int j = 0; j < active[i]; ++j) {
+            if (dq[j] != 0.0) dp += dq[j] * model.value(t[i] - tau[j], 0.0, nullptr, nullptr);
+        }
+        result.modelPressure[i] = p0 - dp;
+        sse += (result.modelPressure[i] - p[i]) * (result.modelPressure[i] - p[i]);
+    }
+    result.rmsError = std::sqrt(sse / m);
+    result.iterations = outer;
+    result.pointsUsed = m;
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+ * deconvolution.h
+ * 文件作用: 压力-产量反褶积 (deconvolution) 头文件
+ * 功能描述:
+ * 1. 由长时间变产量的实测压力与阶梯产量历史反求定产量单位响应 p_u(t)，
+ *    方法为 von Schroeter / Levitan 类型的总体最小二乘 (TLS):
+ *    - 未知量为对数时滞节点上的 z = ln(dp_u/dln t) (保证导数为正)、初始压力 p0 (可选) 与各阶段产量；
+ *    - 节点间 z 对 ln t 线性，p_u 为其闭式积分，首节点之前按单位斜率 (井储) 外推；
+ *    - 目标函数 = 压力拟合误差 + λ·z 曲率平方 + ν·产量修正量平方 (各项按点数与量纲归一化)。
+ * 2. 求解为交替迭代: 固定产量对 (z, p0) 做 Levenberg-Marquardt；
+ *    固定 z 时 (q, p0) 为线性最小二乘，用共轭梯度在结构化算子 A = V·D 上求解 (不形成法方程矩阵)。
+ * 3. 结构化计算:
+ *    - 压力数据先按 "各产量阶段内时滞对数等间距" 抽稀到 maxPoints 个以内；
+ *    - p_u 对 z 的导数为累加 (下三角) 结构，每行雅可比用后缀和在 O(产量阶段数 + 节点数) 内得到；
+ *    - 褶积算子按行分块在线程池中并行计算，各块独立累加法方程后再合并。
+ * 4. 约定: 产量为正表示生产 (压力下降)；注入井请输入负产量。
+ */
+
+#ifndef DECONVOLUTION_H
+#define DECONVOLUTION_H
+
+#include <QVector>
+#include <QString>
+#include <functional>
+
+#include "ratesuperposition.h"
+#include "cancellationtoken.h"
+
+// 反褶积设置
+struct DeconvolutionOptions {
+    int nodesPerDecade = 8;                 // 每十倍程节点数
+    double regularization = 1e-4;           // 曲率正则化权重 λ
+    bool estimateInitialPressure = true;    // 是否把初始压力作为未知量
+    double initialPressure = 0.0;           // 已知的初始压力 (estimateInitialPressure = false 时使用)
+    bool correctRates = true;               // 是否修正产量 (总体最小二乘)
+    double rateWeight = 1e-3;               // 产量偏离实测值的惩罚权重 ν
+    int maxPoints = 3000;                   // 抽稀后参与计算的最多压力点数
+    int maxIterations = 30;                 // 外层交替迭代次数上限
+};
+
+// 反褶积结果
+struct DeconvolutionResult {
+    bool valid = false;
+    QString message;                // 失败原因
+    QVector<double> lag;            // 节点时滞
+    QVector<double> pressure;       // 参考产量下的定产量压差响应 q_ref·p_u
+    QVector<double> derivative;     // 对应的对数导数 q_ref·dp_u/dln t
+    double referenceRate = 0.0;     // 参考产量 (修正后产量绝对值的最大值)
+    double initialPressure = 0.0;   // 初始压力 (估计值或给定值)
+    RateHistory correctedRates;     // 修正后的产量历史 (未修正时与输入相同)
+    double maxRateChange = 0.0;     // 产量最大修正量 (相对最大产量)
+
+    QVector<double> fitTime;        // 抽稀后的时刻及其实测、重构压力 (质量检查)
+    QVector<double> fitPressure;
+    QVector<double> modelPressure;
+    double rmsError = 0.0;          // 压力拟合均方根误差
+    int iterations = 0;
+    int pointsUsed = 0;
+};
+
+class Deconvolution
+{
+public:
+    // t、p 为实测压力 (t 升序)，rates 为产量历史。progress(已完成迭代, 最大迭代) 在调用线程中回调。
+    static DeconvolutionResult run(const QVector<double>& t, const QVector<double>& p,
+                                   const RateHistory& rates, const DeconvolutionOptions& options,
+                                   const CancellationToken& cancel = CancellationToken(),
+                                   std::function<void(int, int)> progress = nullptr);
+
+    // 按产量阶段抽稀: 每个阶段内按时滞对数等间距取点，另保留少量首次变产量前的点；返回升序下标
+    static QVector<int> decimate(const QVector<double>& t, const RateHistory& rates, int maxPoints);
+};
+
+#endif // DECONVOLUTION_H
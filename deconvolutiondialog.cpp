@@ -0,0 +1,114 @@
+/*
+ * 文件名: deconvolutiondialog.cpp
+ * 文件作用: 反褶积参数设置弹窗实现文件
+ * 功能描述:
+ * 1. 构建参数表单，默认值取自 DeconvolutionOptions。
+ * 2. 初始压力作为未知量时禁用输入框；不修正产量时禁用产量权重。
+ */
+
+#include "deconvolutiondialog.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QGroupBox>
+#include <QPushButton>
+#include <QDoubleValidator>
+
+DeconvolutionDialog::DeconvolutionDialog(double initialPressureGuess, QWidget* parent)
+    : QDialog(parent), m_initialPressureGuess(initialPressureGuess)
+{
+    setupUI();
+    updateUIState();
+}
+
+void DeconvolutionDialog::setupUI()
+{
+    setWindowTitle("反褶积分析设置");
+    resize(460, 420);
+
+    const DeconvolutionOptions defaults;
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // 数据组
+    QGroupBox* dataGroup = new QGroupBox("数据");
+    QFormLayout* dataLayout = new QFormLayout(dataGroup);
+    m_timeMeaningCombo = new QComboBox;
+    m_timeMeaningCombo->addItem("阶段时长 (与阶梯图一致)");
+    m_timeMeaningCombo->addItem("阶段结束时刻");
+    m_estimateP0Check = new QCheckBox("作为未知量估计");
+    m_estimateP0Check->setChecked(defaults.estimateInitialPressure);
+    m_p0Spin = new QDoubleSpinBox;
+    m_p0Spin->setRange(-1e9, 1e9);
+    m_p0Spin->setDecimals(3);
+    m_p0Spin->setValue(m_initialPressureGuess);
+    m_maxPointsSpin = new QSpinBox;
+    m_maxPointsSpin->setRange(200, 20000);
+    m_maxPointsSpin->setSingleStep(500);
+    m_maxPointsSpin->setValue(defaults.maxPoints);
+    dataLayout->addRow("产量时间列:", m_timeMeaningCombo);
+    dataLayout->addRow("初始压力:", m_estimateP0Check);
+    dataLayout->addRow("初始压力值:", m_p0Spin);
+    dataLayout->addRow("最多计算点数:", m_maxPointsSpin);
+    mainLayout->addWidget(dataGroup);
+
+    // 求解组
+    QGroupBox* solveGroup = new QGroupBox("求解参数");
+    QFormLayout* solveLayout = new QFormLayout(solveGroup);
+    m_nodesSpin = new QSpinBox;
+    m_nodesSpin->setRange(4, 20);
+    m_nodesSpin->setValue(defaults.nodesPerDecade);
+    m_regularizationEdit = new QLineEdit(QString::number(defaults.regularization));
+    m_regularizationEdit->setValidator(new QDoubleValidator(0.0, 1e6, 12, m_regularizationEdit));
+    m_correctRatesCheck = new QCheckBox("修正产量 (总体最小二乘)");
+    m_correctRatesCheck->setChecked(defaults.correctRates);
+    m_rateWeightEdit = new QLineEdit(QString::number(defaults.rateWeight));
+    m_rateWeightEdit->setValidator(new QDoubleValidator(0.0, 1e6, 12, m_rateWeightEdit));
+    solveLayout->addRow("每十倍程节点数:", m_nodesSpin);
+    solveLayout->addRow("平滑正则化 λ:", m_regularizationEdit);
+    solveLayout->addRow("产量:", m_correctRatesCheck);
+    solveLayout->addRow("产量偏离权重 ν:", m_rateWeightEdit);
+    mainLayout->addWidget(solveGroup);
+
+    QLabel* hint = new QLabel("λ 越大导数曲线越平滑；ν 越大修正后的产量越接近实测值。\n产量为正表示生产，注入井请使用负产量。");
+    hint->setStyleSheet("color: #666;");
+    hint->setWordWrap(true);
+    mainLayout->addWidget(hint);
+
+    connect(m_estimateP0Check, &QCheckBox::toggled, this, &DeconvolutionDialog::updateUIState);
+    connect(m_correctRatesCheck, &QCheckBox::toggled, this, &DeconvolutionDialog::updateUIState);
+
+    // 底部按钮
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    btnLayout->addStretch();
+    QPushButton* btnOk = new QPushButton("开始计算");
+    QPushButton* btnCancel = new QPushButton("取消");
+    connect(btnOk, &QPushButton::clicked, this, &QDialog::accept);
+    connect(btnCancel, &QPushButton::clicked, this, &QDialog::reject);
+    btnLayout->addWidget(btnOk);
+    btnLayout->addWidget(btnCancel);
+    mainLayout->addLayout(btnLayout);
+}
+
+void DeconvolutionDialog::updateUIState()
+{
+    m_p0Spin->setEnabled(!m_estimateP0Check->isChecked());
+    m_rateWeightEdit->setEnabled(m_correctRatesCheck->isChecked());
+}
+
+bool DeconvolutionDialog::isDurationColumn() const
+{
+    return m_timeMeaningCombo->currentIndex() == 0;
+}
+
+DeconvolutionOptions DeconvolutionDialog::getOptions() const
+{
+    DeconvolutionOptions o;
+    o.nodesPerDecade = m_nodesSpin->value();
+    o.regularization = m_regularizationEdit->text().toDouble();
+    o.estimateInitialPressure = m_estimateP0Check->isChecked();
+    o.initialPressure = m_p0Spin->value();
+    o.correctRates = m_correctRatesCheck->isChecked();
+    o.rateWeight = m_rateWeightEdit->text().toDouble();
+    o.maxPoints = m_maxPointsSpin->value();
+    return o;
+}
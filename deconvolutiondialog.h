@@ -0,0 +1,51 @@
+/*
+ * 文件名: deconvolutiondialog.h
+ * 文件作用: 反褶积参数设置弹窗头文件
+ * 功能描述:
+ * 1. 代码构建的参数弹窗，用于图表分析界面的 "反褶积分析"。
+ * 2. 设置产量时间列的含义 (阶段时长或阶段结束时刻)、初始压力是否已知、
+ *    节点密度、正则化强度、产量修正及抽稀点数等。
+ */
+
+#ifndef DECONVOLUTIONDIALOG_H
+#define DECONVOLUTIONDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLineEdit>
+#include <QLabel>
+
+#include "deconvolution.h"
+
+class DeconvolutionDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    // initialPressureGuess 用于初始压力输入框的默认值 (通常取首个压力点)
+    explicit DeconvolutionDialog(double initialPressureGuess, QWidget* parent = nullptr);
+
+    DeconvolutionOptions getOptions() const;
+    // true: 产量时间列为各阶段时长 (与压力产量阶梯图一致)；false: 为各阶段结束时刻
+    bool isDurationColumn() const;
+
+private slots:
+    void updateUIState();
+
+private:
+    void setupUI();
+
+    double m_initialPressureGuess;
+    QComboBox* m_timeMeaningCombo;
+    QCheckBox* m_estimateP0Check;
+    QDoubleSpinBox* m_p0Spin;
+    QSpinBox* m_nodesSpin;
+    QLineEdit* m_regularizationEdit;
+    QCheckBox* m_correctRatesCheck;
+    QLineEdit* m_rateWeightEdit;
+    QSpinBox* m_maxPointsSpin;
+};
+
+#endif // DECONVOLUTIONDIALOG_H
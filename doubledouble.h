@@ -0,0 +1,98 @@
+/*
+ * doubledouble.h
+ * 文件作用: 双双精度 (double-double) 浮点类型
+ * 功能描述:
+ * 1. DoubleDouble 以两个 double 的未求值和 hi + lo (|lo| ≤ ulp(hi)/2) 表示一个数，
+ *    有效位约 106 位 (相对精度约 1e-32)，只用 double 运算实现，不依赖 long double 或软件大数库。
+ * 2. 基本构件为无误差变换: twoSum (Knuth) 给出 a + b 的精确舍入误差，
+ *    twoProd 借助 fma 给出 a·b 的精确舍入误差。
+ * 3. 供 Stehfest 反演在高项数下计算权重与加权求和使用: 权重随 N 组合增长且正负交替，
+ *    双精度求和的舍入误差会被放大到结果中。
+ * 4. 依赖严格的 IEEE 运算顺序，不可在启用 -ffast-math 的编译单元中使用。
+ */
+
+#ifndef DOUBLEDOUBLE_H
+#define DOUBLEDOUBLE_H
+
+#include <cmath>
+
+class DoubleDouble
+{
+public:
+    double hi;  // 主部
+    double lo;  // 余项
+
+    DoubleDouble(double value = 0.0) : hi(value), lo(0.0) {}
+    DoubleDouble(double h, double l) : hi(h), lo(l) {}
+
+    double toDouble() const { return hi + lo; }
+
+    // a + b = s + e (精确)
+    static DoubleDouble twoSum(double a, double b) {
+        double s = a + b;
+        double bb = s - a;
+        return DoubleDouble(s, (a - (s - bb)) + (b - bb));
+    }
+    // 要求 |a| ≥ |b|
+    static DoubleDouble quickTwoSum(double a, double b) {
+        double s = a + b;
+        return DoubleDouble(s, b - (s - a));
+    }
+    // a · b = p + e (精确)
+    static DoubleDouble twoProd(double a, double b) {
+        double p = a * b;
+        return DoubleDouble(p, std::fma(a, b, -p));
+    }
+
+    DoubleDouble operator-() const { return DoubleDouble(-hi, -lo); }
+
+    DoubleDouble& operator+=(const DoubleDouble& o) {
+        DoubleDouble s = twoSum(hi, o.hi);
+        DoubleDouble t = twoSum(lo, o.lo);
+        s.lo += t.hi;
+        s = quickTwoSum(s.hi, s.lo);
+        s.lo += t.lo;
+        *this = quickTwoSum(s.hi, s.lo);
+        return *this;
+    }
+    DoubleDouble& operator-=(const DoubleDouble& o) { return (*this) += -o; }
+
+    DoubleDouble& operator*=(const DoubleDouble& o) {
+        DoubleDouble p = twoProd(hi, o.hi);
+        p.lo += hi * o.lo + lo * o.hi;
+        *this = quickTwoSum(p.hi, p.lo);
+        return *this;
+    }
+    DoubleDouble& operator*=(double c) {
+        DoubleDouble p = twoProd(hi, c);
+        p.lo += lo * c;
+        *this = quickTwoSum(p.hi, p.lo);
+        return *this;
+    }
+
+    // 长除法: 三次取商并修正余数
+    DoubleDouble& operator/=(const DoubleDouble& o) {
+        double q1 = hi / o.hi;
+        DoubleDouble r = *this;
+        r -= scaled(o, q1);
+        double q2 = r.hi / o.hi;
+        r -= scaled(o, q2);
+        double q3 = r.hi / o.hi;
+        DoubleDouble q = quickTwoSum(q1, q2);
+        q += DoubleDouble(q3);
+        *this = q;
+        return *this;
+    }
+
+private:
+    static DoubleDouble scaled(DoubleDouble a, double c) { return a *= c; }
+};
+
+inline DoubleDouble operator+(DoubleDouble a, const DoubleDouble& b) { return a += b; }
+inline DoubleDouble operator-(DoubleDouble a, const DoubleDouble& b) { return a -= b; }
+inline DoubleDouble operator*(DoubleDouble a, const DoubleDouble& b) { return a *= b; }
+inline DoubleDouble operator/(DoubleDouble a, const DoubleDouble& b) { return a /= b; }
+inline DoubleDouble operator*(DoubleDouble a, double c) { return a *= c; }
+inline DoubleDouble operator*(double c, DoubleDouble a) { return a *= c; }
+
+#endif // DOUBLEDOUBLE_H
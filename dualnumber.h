@@ -0,0 +1,143 @@
+/*
+ * dualnumber.h
+ * 文件作用: 前向模式自动微分所用的多分量对偶数类型
+ * 功能描述:
+ * 1. DualNumber 同时携带函数值 v 与对若干参数的偏导数 d[0..n-1]。
+ * 2. 重载了四则运算及 sqrt/exp/log/pow/abs 等基本函数，按链式法则传播导数。
+ * 3. 供 ModelSolver01_06 的模板化拉普拉斯核函数使用，一次计算即可得到
+ *    无因次压力及其对全部拟合参数的解析偏导（替代有限差分雅可比）。
+ * 4. 导数分量个数 n 为运行期值（上限 MaxDerivs），常数的 n = 0，
+ *    二元运算时取两者的较大值，因此未参与求导的中间量不会产生额外开销。
+ */
+
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include <cmath>
+#include <algorithm>
+
+class DualNumber
+{
+public:
+    // 单次可同时求导的最大参数个数
+    static constexpr int MaxDerivs = 16;
+
+    double v;               // 函数值
+    int n;                  // 有效导数分量个数
+    double d[MaxDerivs];    // 偏导数分量
+
+    DualNumber(double value = 0.0) : v(value), n(0) {}
+
+    // 构造第 index 个自变量 (导数种子为 1)，count 为本次求导的参数总数
+    static DualNumber variable(double value, int index, int count) {
+        DualNumber x(value);
+        x.n = std::min(count, (int)MaxDerivs);
+        for (int k = 0; k < x.n; ++k) x.d[k] = 0.0;
+        if (index >= 0 && index < x.n) x.d[index] = 1.0;
+        return x;
+    }
+
+    double deriv(int k) const { return (k < n) ? d[k] : 0.0; }
+
+    // 按链式法则构造 f(x)：值为 fv，导数为 dfdx * x'
+    static DualNumber chain(const DualNumber& x, double fv, double dfdx) {
+        DualNumber r(fv);
+        r.n = x.n;
+        for (int k = 0; k < r.n; ++k) r.d[k] = dfdx * x.d[k];
+        return r;
+    }
+
+    DualNumber operator-() const {
+        DualNumber r(-v);
+        r.n = n;
+        for (int k = 0; k < n; ++k) r.d[k] = -d[k];
+        return r;
+    }
+
+    DualNumber& operator+=(const DualNumber& o) {
+        widen(o.n);
+        v += o.v;
+        for (int k = 0; k < o.n; ++k) d[k] += o.d[k];
+        return *this;
+    }
+    DualNumber& operator-=(const DualNumber& o) {
+        widen(o.n);
+        v -= o.v;
+        for (int k = 0; k < o.n; ++k) d[k] -= o.d[k];
+        return *this;
+    }
+    DualNumber& operator*=(const DualNumber& o) {
+        widen(o.n);
+        for (int k = 0; k < n; ++k) d[k] = d[k] * o.v + v * o.deriv(k);
+        v *= o.v;
+        return *this;
+    }
+    DualNumber& operator/=(const DualNumber& o) {
+        widen(o.n);
+        double inv = 1.0 / o.v;
+        double q = v * inv;
+        for (int k = 0; k < n; ++k) d[k] = (d[k] - q * o.deriv(k)) * inv;
+        v = q;
+        return *this;
+    }
+
+    DualNumber& operator+=(double c) { v += c; return *this; }
+    DualNumber& operator-=(double c) { v -= c; return *this; }
+    DualNumber& operator*=(double c) { v *= c; for (int k = 0; k < n; ++k) d[k] *= c; return *this; }
+    DualNumber& operator/=(double c) { return (*this) *= (1.0 / c); }
+
+private:
+    // 扩展导数分量个数，新增分量清零
+    void widen(int m) {
+        if (m <= n) return;
+        for (int k = n; k < m; ++k) d[k] = 0.0;
+        n = m;
+    }
+};
+
+inline DualNumber operator+(DualNumber a, const DualNumber& b) { return a += b; }
+inline DualNumber operator-(DualNumber a, const DualNumber& b) { return a -= b; }
+inline DualNumber operator*(DualNumber a, const DualNumber& b) { return a *= b; }
+inline DualNumber operator/(DualNumber a, const DualNumber& b) { return a /= b; }
+
+inline DualNumber operator+(DualNumber a, double c) { return a += c; }
+inline DualNumber operator-(DualNumber a, double c) { return a -= c; }
+inline DualNumber operator*(DualNumber a, double c) { return a *= c; }
+inline DualNumber operator/(DualNumber a, double c) { return a /= c; }
+inline DualNumber operator+(double c, DualNumber a) { return a += c; }
+inline DualNumber operator-(double c, const DualNumber& a) { DualNumber r = -a; return r += c; }
+inline DualNumber operator*(double c, DualNumber a) { return a *= c; }
+inline DualNumber operator/(double c, const DualNumber& a) { return DualNumber(c) / a; }
+
+// 比较运算只比较函数值
+inline bool operator<(const DualNumber& a, const DualNumber& b) { return a.v < b.v; }
+inline bool operator>(const DualNumber& a, const DualNumber& b) { return a.v > b.v; }
+
+inline DualNumber sqrt(const DualNumber& x) {
+    double s = std::sqrt(x.v);
+    return DualNumber::chain(x, s, (s > 0.0) ? 0.5 / s : 0.0);
+}
+
+inline DualNumber exp(const DualNumber& x) {
+    double e = std::exp(x.v);
+    return DualNumber::chain(x, e, e);
+}
+
+inline DualNumber log(const DualNumber& x) {
+    return DualNumber::chain(x, std::log(x.v), 1.0 / x.v);
+}
+
+inline DualNumber pow(const DualNumber& x, double a) {
+    double p = std::pow(x.v, a);
+    return DualNumber::chain(x, p, (x.v != 0.0) ? a * p / x.v : 0.0);
+}
+
+inline DualNumber abs(const DualNumber& x) {
+    return (x.v < 0.0) ? -x : x;
+}
+
+// 泛型代码中取标量值
+inline double scalarValue(double x) { return x; }
+inline double scalarValue(const DualNumber& x) { return x.v; }
+
+#endif // DUALNUMBER_H
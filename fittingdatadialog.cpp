@@ -86,6 +86,12 @@ void FittingDataDialog::onAccepted()
         }
     }
 
+    // 变产量叠加以 Pi - p 为压差，只适用于降落试井
+    if (ui->comboRate->currentData().toInt() >= 0 && !ui->radioDrawdown->isChecked()) {
+        QMessageBox::warning(this, "提示", "选择产量列时请使用压力降落试井，并输入地层初始压力 (Pi)！");
+        return;
+    }
+
     accept();
 }
 
@@ -136,6 +142,7 @@ void FittingDataDialog::updateColumnComboBoxes(const QStringList& headers)
     ui->comboTime->clear();
     ui->comboPressure->clear();
     ui->comboDerivative->clear();
+    ui->comboRate->clear();
 
     // 添加选项
     ui->comboTime->addItems(headers);
@@ -147,6 +154,12 @@ void FittingDataDialog::updateColumnComboBoxes(const QStringList& headers)
         ui->comboDerivative->addItem(headers[i], i); // UserData 对应列索引
     }
 
+    // 产量列：第一项为“无 (定产量)”
+    ui->comboRate->addItem("无 (定产量)", -1);
+    for(int i=0; i<headers.size(); ++i) {
+        ui->comboRate->addItem(headers[i], i);
+    }
+
     // 智能匹配列名
     for (int i = 0; i < headers.size(); ++i) {
         QString h = headers[i].toLower();
@@ -316,6 +329,7 @@ FittingDataSettings FittingDataDialog::getSettings() const
 
     // 获取导数列：itemData存储了真实的列索引，-1表示自动
     s.derivColIndex = ui->comboDerivative->currentData().toInt();
+    s.rateColIndex = ui->comboRate->currentData().toInt();
 
     s.skipRows = ui->spinSkipRows->value();
 
@@ -31,6 +31,7 @@ struct FittingDataSettings {
     int timeColIndex;           // 时间列索引
     int pressureColIndex;       // 压力列索引
     int derivColIndex;          // 导数列索引 (-1 表示自动计算)
+    int rateColIndex;           // 产量列索引 (-1 表示定产量；否则按变产量历史叠加计算)
     int skipRows;               // 跳过首行数
 
     WellTestType testType;      // 试井类型 (降落/恢复)
@@ -5,13 +5,17 @@
  * 1. 实现了多页签管理逻辑（增删改）。
  * 2. 负责将全局的模型管理器和数据模型分发给具体的拟合子控件。
  * 3. 实现了拟合状态的序列化与反序列化，支持项目保存恢复。
+ * 4. 合并报告: 在界面线程收集各页签的报告快照，由 ReportGenerator 在后台生成。
  */
 
 #include "fittingpage.h"
 #include "ui_fittingpage.h"
 #include "wt_fittingwidget.h"
 #include "modelparameter.h"
+#include "reportgenerator.h"
 #include <QInputDialog>
+#include <QFileDialog>
+#include <QFutureWatcher>
 #include <QMessageBox>
 #include <QJsonArray>
 #include <QDebug>
@@ -174,6 +178,36 @@ void FittingPage::on_btnDeleteAnalysis_clicked()
     }
 }
 
+// 合并导出全部分析页的报告
+void FittingPage::on_btnReportAll_clicked()
+{
+    QList<ReportAnalysis> analyses;
+    for(int i=0; i<ui->tabWidget->count(); ++i) {
+        FittingWidget* w = qobject_cast<FittingWidget*>(ui->tabWidget->widget(i));
+        if(!w) continue;
+        ReportAnalysis a = w->reportSnapshot();
+        a.name = ui->tabWidget->tabText(i);
+        analyses.append(a);
+    }
+    if(analyses.isEmpty()) return;
+
+    QString defaultDir = ModelParameter::instance()->getProjectPath();
+    if(defaultDir.isEmpty()) defaultDir = ".";
+    QString fileName = QFileDialog::getSaveFileName(this, "导出全部分析报告", defaultDir + "/WellTestReport_All.doc", "Word 文档 (*.doc);;HTML 文件 (*.html)");
+    if(fileName.isEmpty()) return;
+
+    ui->btnReportAll->setEnabled(false);
+    QFutureWatcher<QString>* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, fileName, count = analyses.size()]() {
+        watcher->deleteLater();
+        ui->btnReportAll->setEnabled(true);
+        const QString error = watcher->result();
+        if(error.isEmpty()) QMessageBox::information(this, "导出成功", QString("%1 个分析页的报告已保存至:\n%2").arg(count).arg(fileName));
+        else QMessageBox::critical(this, "错误", "无法写入文件，请检查权限或文件是否被占用。\n" + error);
+    });
+    watcher->setFuture(ReportGenerator::writeAsync(fileName, ReportProjectInfo::fromModelParameter(), analyses));
+}
+
 // 保存所有状态
 void FittingPage::saveAllFittingStates()
 {
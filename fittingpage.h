@@ -5,6 +5,7 @@
  * 1. 管理多个拟合分析页签 (FittingWidget)。
  * 2. 负责将项目级数据（如模型管理器、观测数据模型）传递给各个子页签。
  * 3. 实现多页签的创建、重命名、删除及保存恢复功能。
+ * 4. 将全部分析页合并导出为一份报告。
  */
 
 #ifndef FITTINGPAGE_H
@@ -59,6 +60,8 @@ private slots:
     void on_btnNewAnalysis_clicked();
     void on_btnRenameAnalysis_clicked();
     void on_btnDeleteAnalysis_clicked();
+    // 把全部分析页合并导出为一份报告 (后台生成)
+    void on_btnReportAll_clicked();
 
     // 响应子页面的保存请求
     void onChildRequestSave();
@@ -10,6 +10,8 @@
 #include "modelmanager.h"
 #include <QHeaderView>
 #include <QCheckBox>
+#include <QSlider>
+#include <cmath>
 #include <QDebug>
 
 FittingParameterChart::FittingParameterChart(QTableWidget* table, QObject *parent)
@@ -28,8 +30,8 @@ void FittingParameterChart::initTable()
     if(!m_table) return;
 
     QStringList headers;
-    headers << "拟合" << "参数" << "数值" << "下限" << "上限";
-    m_table->setColumnCount(5);
+    headers << "拟合" << "参数" << "数值" << "下限" << "上限" << "调节";
+    m_table->setColumnCount(6);
     m_table->setHorizontalHeaderLabels(headers);
 
     // 设置列宽比例
@@ -39,6 +41,8 @@ void FittingParameterChart::initTable()
     m_table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
     m_table->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
     m_table->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
+    m_table->horizontalHeader()->setSectionResizeMode(5, QHeaderView::Fixed);
+    m_table->setColumnWidth(5, 110);
 
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_table->setAlternatingRowColors(true);
@@ -147,6 +151,16 @@ void FittingParameterChart::refreshTable()
         QTableWidgetItem* maxItem = new QTableWidgetItem(QString::number(p.max));
         m_table->setItem(row, 4, maxItem);
 
+        // 6. 滑块 (仅拟合参数)
+        if(p.isFit && p.max > p.min) {
+            QSlider* slider = new QSlider(Qt::Horizontal);
+            slider->setRange(0, SliderSteps);
+            slider->setValue(valueToSlider(p));
+            connect(slider, &QSlider::valueChanged, this, [this, row, i](int pos) { onSliderMoved(row, i, pos); });
+            connect(slider, &QSlider::sliderReleased, this, &FittingParameterChart::sliderReleased);
+            m_table->setCellWidget(row, 5, slider);
+        }
+
         row++;
     }
 }
@@ -176,11 +190,74 @@ void FittingParameterChart::updateParamsFromTable()
     }
 }
 
+double FittingParameterChart::sliderToValue(const FitParameter& p, int pos)
+{
+    double u = qBound(0, pos, SliderSteps) / double(SliderSteps);
+    int id = ParameterSchema::indexOf(p.name);
+    double v = ParameterSchema::usesLog(id, p.min)
+        ? pow(10.0, log10(p.min) + u * (log10(p.max) - log10(p.min)))
+        : p.min + u * (p.max - p.min);
+    if(id == Param_nf) v = std::round(v);
+    return v;
+}
+
+int FittingParameterChart::valueToSlider(const FitParameter& p)
+{
+    int id = ParameterSchema::indexOf(p.name);
+    double u = ParameterSchema::usesLog(id, p.min)
+        ? (log10(qMax(p.value, p.min)) - log10(p.min)) / (log10(p.max) - log10(p.min))
+        : (p.value - p.min) / (p.max - p.min);
+    return qBound(0, int(std::lround(u * SliderSteps)), SliderSteps);
+}
+
+void FittingParameterChart::onSliderMoved(int row, int paramIndex, int pos)
+{
+    if(paramIndex < 0 || paramIndex >= m_params.size()) return;
+    // 先取表格中可能刚编辑过的上下限
+    updateParamsFromTable();
+    FitParameter& p = m_params[paramIndex];
+    p.value = sliderToValue(p, pos);
+    if(QTableWidgetItem* item = m_table->item(row, 2)) item->setText(QString::number(p.value, 'g', 5));
+    emit parameterSliding(p.name, p.value);
+}
+
+void FittingParameterChart::setSlidersEnabled(bool enabled)
+{
+    for(int row = 0; row < m_table->rowCount(); ++row) {
+        if(QWidget* w = m_table->cellWidget(row, 5)) w->setEnabled(enabled);
+    }
+}
+
 QList<FitParameter> FittingParameterChart::getParameters() const
 {
     return m_params;
 }
 
+CompiledFitParams FittingParameterChart::compileParameters(ModelType type, const QList<FitParameter>& params)
+{
+    CompiledFitParams compiled;
+    compiled.type = type;
+    compiled.values = ParameterSchema::defaults();
+    compiled.lower = ParameterSchema::defaults();
+    compiled.upper = ParameterSchema::defaults();
+
+    bool hasLf = false;
+    bool hasLfD = false;
+    for(const FitParameter& p : params) {
+        int id = ParameterSchema::indexOf(p.name);
+        if(id < 0) continue;
+        compiled.values[id] = p.value;
+        compiled.lower[id] = p.min;
+        compiled.upper[id] = p.max;
+        if(p.isFit) compiled.fitIds.append(id);
+        hasLf = hasLf || (id == Param_Lf);
+        hasLfD = hasLfD || (id == Param_LfD);
+    }
+    if(hasLfD && !hasLf) compiled.values[Param_Lf] = compiled.values[Param_LfD] * compiled.values[Param_L];
+    ParameterSchema::applyDependencies(compiled.values);
+    return compiled;
+}
+
 void FittingParameterChart::setParameters(const QList<FitParameter>& params)
 {
     // 更新现有参数的值
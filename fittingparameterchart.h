@@ -4,6 +4,8 @@
  * 功能描述:
  * 1. 管理拟合界面左侧的参数表格 (QTableWidget)。
  * 2. 负责参数的显示、读取、更新和模型切换时的参数重置。
+ * 3. 参与拟合的参数在 "调节" 列带一个滑块 (在上下限之间取值，对数参数按对数刻度)，
+ *    拖动时即时改写数值并发出 parameterSliding，供界面做实时曲线预览。
  */
 
 #ifndef FITTINGPARAMETERCHART_H
@@ -15,6 +17,7 @@
 #include <QMap>
 #include "modelparameter.h"
 #include "modelenums.h" // [新增] 引入公共枚举
+#include "parameterschema.h"
 
 class ModelManager; // 前向声明
 
@@ -53,15 +56,34 @@ public:
     // 设置参数列表到表格
     void setParameters(const QList<FitParameter>& params);
 
+    // 编译参数列表: 取值、上下限按 ParamId 存入稠密向量，并记录参与拟合的参数下标
+    // (拟合迭代只使用编译结果，不再按名称查找参数)
+    static CompiledFitParams compileParameters(ModelType type, const QList<FitParameter>& params);
+
     // 静态工具：获取参数的显示信息（符号、单位等）
     static void getParamDisplayInfo(const QString& name, QString& displayName, QString& symbol, QString& uniSymbol, QString& unit);
 
+    // 启用/禁用参数滑块 (拟合进行中禁用)
+    void setSlidersEnabled(bool enabled);
+
+signals:
+    // 滑块改变了参数值 (数值列与内部参数列表均已更新)
+    void parameterSliding(const QString& name, double value);
+    // 滑块被松开
+    void sliderReleased();
+
 private:
     // 初始化表格表头
     void initTable();
     // 刷新表格显示
     void refreshTable();
 
+    // 滑块位置与参数值的换算 (对数参数在 log10 空间等分)
+    static constexpr int SliderSteps = 1000;
+    static double sliderToValue(const FitParameter& p, int pos);
+    static int valueToSlider(const FitParameter& p);
+    void onSliderMoved(int row, int paramIndex, int pos);
+
 private:
     QTableWidget* m_table;
     ModelManager* m_modelManager;
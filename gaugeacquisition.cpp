@@ -0,0 +1,267 @@
+/*
+ * gaugeacquisition.cpp
+ * 文件作用: 实时压力计数据采集实现文件
+ * 功能描述:
+ * 1. 文件数据源以非缓冲方式打开，读到文件末尾后定时轮询新增内容；文件变短 (被截断重写) 时从头读取。
+ * 2. 套接字在读取线程中创建并以阻塞等待方式读取，不依赖事件循环。
+ * 3. 环形缓冲区满时: 文件数据源等待界面线程取走数据 (数据仍在文件中，不会丢失)；
+ *    套接字数据源丢弃新样本并计数，保证内存有界。
+ * 4. 分析点的导数与 PressureDerivativeCalculator::calculateBourdetDerivative 对同一组点的结果一致。
+ */
+
+#include "gaugeacquisition.h"
+
+#include <QFile>
+#include <QTcpSocket>
+#include <QLocalSocket>
+#include <QtEndian>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+
+namespace {
+// 读到文件末尾或套接字暂无数据时的等待时间 (ms)
+const int PollInterval = 20;
+// 每次从文件读取的最大字节数
+const qint64 ReadChunk = 1 << 16;
+// 套接字连接超时 (ms)
+const int ConnectTimeout = 3000;
+
+inline bool isSeparator(char c)
+{
+    return c == ',' || c == ';' || c == '\t' || c == ' ' || c == '\r';
+}
+
+// 跳过分隔符后解析一个数，成功时 p 移到数字之后
+bool parseNumber(const char*& p, const char* end, double& value)
+{
+    while (p < end && isSeparator(*p)) ++p;
+    if (p < end && *p == '+') ++p;
+    const std::from_chars_result r = std::from_chars(p, end, value);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+}
+
+// ========================= GaugeStreamParser =========================
+
+void GaugeStreamParser::feed(const QByteArray& data, QVector<GaugeSample>& out)
+{
+    m_pending.append(data);
+    const char* begin = m_pending.constData();
+    const char* end = begin + m_pending.size();
+    const char* p = begin;
+
+    if (m_format == GaugeSource::BinaryDouble) {
+        const int recordSize = 2 * int(sizeof(double));
+        for (; end - p >= recordSize; p += recordSize) {
+            GaugeSample s;
+            s.time = qFromLittleEndian<double>(p);
+            s.pressure = qFromLittleEndian<double>(p + sizeof(double));
+            out.append(s);
+        }
+    } else {
+        while (p < end) {
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+            if (!eol) break;
+            GaugeSample s;
+            if (parseLine(p, eol, s)) out.append(s);
+            p = eol + 1;
+        }
+    }
+    // 保留不完整的尾部
+    m_pending.remove(0, int(p - begin));
+}
+
+bool GaugeStreamParser::parseLine(const char* begin, const char* end, GaugeSample& sample) const
+{
+    const char* p = begin;
+    return parseNumber(p, end, sample.time) && parseNumber(p, end, sample.pressure)
+           && std::isfinite(sample.time) && std::isfinite(sample.pressure);
+}
+
+// ========================= GaugeReader =========================
+
+GaugeReader::GaugeReader(const GaugeSource& source, QObject* parent)
+    : QThread(parent)
+    , m_source(source)
+    , m_parser(source.format)
+    , m_buffer(BufferCapacity)
+    , m_dropped(0)
+    , m_received(0)
+{
+}
+
+GaugeReader::~GaugeReader()
+{
+    stop();
+}
+
+void GaugeReader::stop()
+{
+    requestInterruption();
+    wait();
+}
+
+void GaugeReader::run()
+{
+    switch (m_source.kind) {
+    case GaugeSource::TailFile:    runTailFile(); break;
+    case GaugeSource::TcpSocket:   runTcpSocket(); break;
+    case GaugeSource::LocalSocket: runLocalSocket(); break;
+    }
+}
+
+void GaugeReader::runTailFile()
+{
+    QFile file(m_source.address);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        emit sourceError(QString("无法打开数据文件: %1").arg(file.errorString()));
+        return;
+    }
+
+    QVector<GaugeSample> samples;
+    while (!isInterruptionRequested()) {
+        // 文件被截断后重新写入 (如记录仪重新开始记录): 从头读取
+        if (file.size() < file.pos()) {
+            file.seek(0);
+            m_parser.reset();
+        }
+        const QByteArray chunk = file.read(ReadChunk);
+        if (chunk.isEmpty()) {
+            msleep(PollInterval);
+            continue;
+        }
+        samples.clear();
+        m_parser.feed(chunk, samples);
+        if (!publish(samples)) return;
+    }
+}
+
+void GaugeReader::runTcpSocket()
+{
+    const int colon = m_source.address.lastIndexOf(':');
+    bool ok = false;
+    const quint16 port = colon > 0 ? m_source.address.mid(colon + 1).toUShort(&ok) : 0;
+    if (!ok) {
+        emit sourceError("TCP 地址格式应为 主机:端口");
+        return;
+    }
+
+    QTcpSocket socket;
+    socket.connectToHost(m_source.address.left(colon), port);
+    if (!socket.waitForConnected(ConnectTimeout)) {
+        emit sourceError(QString("无法连接数据源: %1").arg(socket.errorString()));
+        return;
+    }
+    readStream(socket, [&socket]() { return socket.state() == QAbstractSocket::ConnectedState; });
+}
+
+void GaugeReader::runLocalSocket()
+{
+    QLocalSocket socket;
+    socket.connectToServer(m_source.address);
+    if (!socket.waitForConnected(ConnectTimeout)) {
+        emit sourceError(QString("无法连接数据源: %1").arg(socket.errorString()));
+        return;
+    }
+    readStream(socket, [&socket]() { return socket.state() == QLocalSocket::ConnectedState; });
+}
+
+void GaugeReader::readStream(QIODevice& device, const std::function<bool()>& isConnected)
+{
+    QVector<GaugeSample> samples;
+    while (!isInterruptionRequested()) {
+        if (!device.waitForReadyRead(PollInterval)) {
+            if (!isConnected()) {
+                emit sourceError("数据源已断开");
+                return;
+            }
+            continue;
+        }
+        samples.clear();
+        m_parser.feed(device.readAll(), samples);
+        if (!publish(samples)) return;
+    }
+}
+
+bool GaugeReader::publish(const QVector<GaugeSample>& samples)
+{
+    const bool canWait = (m_source.kind == GaugeSource::TailFile);
+    for (const GaugeSample& s : samples) {
+        bool pushed = m_buffer.push(s);
+        while (!pushed && canWait) {
+            if (isInterruptionRequested()) return false;
+            msleep(1);
+            pushed = m_buffer.push(s);
+        }
+        if (pushed) m_received.fetchAndAddRelaxed(1);
+        else m_dropped.fetchAndAddRelaxed(1);
+    }
+    return !isInterruptionRequested();
+}
+
+// ========================= LiveGaugeAnalysis =========================
+
+LiveGaugeAnalysis::LiveGaugeAnalysis()
+{
+    reset(Config());
+}
+
+void LiveGaugeAnalysis::reset(const Config& config)
+{
+    m_config = config;
+    m_started = false;
+    m_t0 = m_p0 = 0.0;
+    m_lastT = m_lastDp = 0.0;
+    m_bin = 0;
+    m_binCount = 0;
+    m_binTSum = m_binDpSum = 0.0;
+    m_bourdet.reset(config.lSpacing);
+    m_revisionStart = 0;
+}
+
+bool LiveGaugeAnalysis::append(const GaugeSample& sample)
+{
+    // 第一个样本定义时间零点与关井压力
+    if (!m_started) {
+        m_started = true;
+        m_t0 = sample.time;
+        m_p0 = sample.pressure;
+        return false;
+    }
+
+    const double t = (sample.time - m_t0) * m_config.timeScale;
+    if (!(t > m_lastT)) return false;
+
+    double dp;
+    if (m_config.testType == PressureDerivativeConfig::Drawdown) {
+        const double pi = m_config.initialPressure > 0.0 ? m_config.initialPressure : m_p0;
+        dp = std::abs(pi - sample.pressure);
+    } else {
+        dp = std::abs(sample.pressure - m_p0);
+    }
+    m_lastT = t;
+    m_lastDp = dp;
+
+    const qint64 bin = qint64(std::floor(std::log10(t) * m_config.pointsPerDecade));
+    bool produced = false;
+    if (m_binCount > 0 && bin != m_bin) {
+        closeBin();
+        produced = true;
+    }
+    m_bin = bin;
+    ++m_binCount;
+    m_binTSum += t;
+    m_binDpSum += dp;
+    return produced;
+}
+
+void LiveGaugeAnalysis::closeBin()
+{
+    const int changed = m_bourdet.append(m_binTSum / m_binCount, m_binDpSum / m_binCount);
+    if (changed >= 0) m_revisionStart = qMin(m_revisionStart, changed);
+    m_binCount = 0;
+    m_binTSum = m_binDpSum = 0.0;
+}
@@ -0,0 +1,172 @@
+/*
+ * gaugeacquisition.h
+ * 文件作用: 实时压力计数据采集头文件
+ * 功能描述:
+ * 1. GaugeReader 在独立线程中读取数据源: 追踪持续增长的 CSV/二进制数据文件，
+ *    或读取本机 TCP / 本地套接字 (Unix 域套接字、Windows 命名管道) 推送的数据流；
+ *    解析出的样本放入无锁环形缓冲区 (SpscRingBuffer)，界面线程按帧批量取出。
+ * 2. 数据格式: CSV 文本每行 "时间,压力" (分隔符可为逗号、分号、制表符或空格，无法解析的行如表头被跳过)；
+ *    二进制为连续的 (时间, 压力) 小端 double 对，每条记录 16 字节。
+ * 3. LiveGaugeAnalysis 增量计算压差与 Bourdet 导数:
+ *    原始样本按对数时间分箱 (每个对数周期固定点数)，同一箱内的样本取平均后成为一个分析点，
+ *    分析点总数只随测试跨越的对数周期数增长，与采样频率和测试时长无关，内存有界；
+ *    每个原始样本只做一次累加，分析点的导数由 IncrementalBourdetDerivative 只在尾部更新，不做整列重算。
+ */
+
+#ifndef GAUGEACQUISITION_H
+#define GAUGEACQUISITION_H
+
+#include <QThread>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QIODevice>
+#include <QAtomicInteger>
+#include <functional>
+
+#include "spscringbuffer.h"
+#include "pressurederivativecalculator.h"
+
+// 一个原始样本 (数据源中的时间与压力，未换算)
+struct GaugeSample {
+    double time = 0.0;
+    double pressure = 0.0;
+};
+
+// 数据源描述
+struct GaugeSource {
+    enum Kind {
+        TailFile,       // 追踪增长中的数据文件
+        TcpSocket,      // 本机 TCP 数据流 (address 为 "主机:端口")
+        LocalSocket     // 本地套接字 / 命名管道 (address 为套接字名或路径)
+    };
+    enum Format {
+        CsvText,        // 每行 "时间,压力"
+        BinaryDouble    // 连续的 (时间, 压力) 小端 double 对
+    };
+
+    Kind kind = TailFile;
+    Format format = CsvText;
+    QString address;
+};
+
+// 把数据块解析为样本 (保留跨数据块的半行 / 半条记录)
+class GaugeStreamParser
+{
+public:
+    explicit GaugeStreamParser(GaugeSource::Format format) : m_format(format) {}
+
+    // 解析 data，完整的样本追加到 out
+    void feed(const QByteArray& data, QVector<GaugeSample>& out);
+    void reset() { m_pending.clear(); }
+
+private:
+    bool parseLine(const char* begin, const char* end, GaugeSample& sample) const;
+
+    GaugeSource::Format m_format;
+    QByteArray m_pending;
+};
+
+class GaugeReader : public QThread
+{
+    Q_OBJECT
+
+public:
+    // 环形缓冲区容量 (样本数)，1 kHz 时约可缓存一分钟
+    static constexpr int BufferCapacity = 1 << 16;
+
+    explicit GaugeReader(const GaugeSource& source, QObject* parent = nullptr);
+    ~GaugeReader();
+
+    // 界面线程: 最多取出 maxCount 个样本追加到 out
+    int takeSamples(QVector<GaugeSample>& out, int maxCount) { return m_buffer.pop(out, maxCount); }
+
+    // 缓冲区满而丢弃的样本数 (仅套接字数据源会丢弃；文件数据源等待消费者，数据仍留在文件中)
+    quint64 droppedCount() const { return m_dropped.loadRelaxed(); }
+    // 已读入的样本总数
+    quint64 receivedCount() const { return m_received.loadRelaxed(); }
+
+    // 请求停止并等待线程退出
+    void stop();
+
+signals:
+    // 数据源出错 (无法打开文件、连接失败或断开)，线程随即退出
+    void sourceError(const QString& message);
+
+protected:
+    void run() override;
+
+private:
+    void runTailFile();
+    void runTcpSocket();
+    void runLocalSocket();
+    // 已连接的套接字: 读到断开或请求停止为止
+    void readStream(QIODevice& device, const std::function<bool()>& isConnected);
+
+    // 把解析出的样本放入缓冲区；返回 false 表示已请求停止
+    bool publish(const QVector<GaugeSample>& samples);
+
+    GaugeSource m_source;
+    GaugeStreamParser m_parser;
+    SpscRingBuffer<GaugeSample> m_buffer;
+    QAtomicInteger<quint64> m_dropped;
+    QAtomicInteger<quint64> m_received;
+};
+
+// 实时压差与 Bourdet 导数 (界面线程使用)
+class LiveGaugeAnalysis
+{
+public:
+    struct Config {
+        PressureDerivativeConfig::TestType testType = PressureDerivativeConfig::Drawdown;
+        double initialPressure = 0.0;   // 降落试井初始压力，<= 0 时取第一个样本的压力
+        double timeScale = 1.0 / 3600.0; // 数据源时间单位换算为小时的系数
+        double lSpacing = 0.15;
+        int pointsPerDecade = 100;      // 每个对数周期的分析点数
+    };
+
+    LiveGaugeAnalysis();
+
+    void reset(const Config& config);
+
+    // 追加一个原始样本；时间不递增的样本被忽略。
+    // 返回 true 表示产生了新的分析点 (此后 revisionStart() 之后的导数可能已变化)
+    bool append(const GaugeSample& sample);
+
+    // 分析点 (时间单位为小时)
+    const QVector<double>& time() const { return m_bourdet.time(); }
+    const QVector<double>& deltaP() const { return m_bourdet.pressureDrop(); }
+    const QVector<double>& derivative() const { return m_bourdet.derivative(); }
+    int pointCount() const { return m_bourdet.size(); }
+
+    // 自上次 clearRevision() 以来导数发生变化的最小下标 (无变化时等于 pointCount())
+    int revisionStart() const { return m_revisionStart; }
+    void clearRevision() { m_revisionStart = m_bourdet.size(); }
+
+    // 最近一个原始样本换算后的时间与压差
+    double lastTime() const { return m_lastT; }
+    double lastDeltaP() const { return m_lastDp; }
+
+private:
+    // 把当前箱内的平均值作为一个分析点
+    void closeBin();
+
+    Config m_config;
+
+    bool m_started;
+    double m_t0;            // 第一个样本的原始时间 (零点)
+    double m_p0;            // 第一个样本的压力
+    double m_lastT;
+    double m_lastDp;
+
+    // 当前对数时间箱
+    qint64 m_bin;
+    int m_binCount;
+    double m_binTSum;
+    double m_binDpSum;
+
+    IncrementalBourdetDerivative m_bourdet;
+    int m_revisionStart;
+};
+
+#endif // GAUGEACQUISITION_H
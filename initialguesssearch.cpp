@@ -0,0 +1,370 @@
+/*
+ * initialguesssearch.cpp
+ * 文件作用: 拟合前的全局初值搜索实现文件
+ * 功能描述:
+ * 1. 在双对数坐标下，kf 的变化只使理论曲线整体平移:
+ *    log t_D = log t + log(14.4 kf/(φμCtL²))，log p = log p_D + log(1.842e-3 qμB/(kf h))，
+ *    因此每个图版节点只需按 kf 扫描平移量，无需重新求解模型。
+ * 2. 对每个 kf 预先算好抽稀数据点在图版时间网格上的插值位置与目标值 (连续 float 数组)，
+ *    距离计算为无分支的顺序循环，可由编译器向量化；各节点之间用 QtConcurrent 并行。
+ * 3. 压敏系数 gamaD 主要影响晚期段，粗搜索中不计入，由后续 LM 拟合修正。
+ */
+
+#include "initialguesssearch.h"
+#include "modelsolver01_06.h"
+
+#include <QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 图版节点的匹配结果
+struct NodeScore {
+    qint64 node;
+    double distance;
+    int kfIndex;
+};
+
+// 某个 kf 取值下，抽稀数据点在图版时间网格上的插值位置 (只保留落在网格范围内的点)
+struct ShiftedSamples {
+    QVector<int> pIdx;
+    QVector<float> pFrac;
+    QVector<float> pTarget;     // log10(实测压差) - log10(压力换算系数)
+    QVector<int> dIdx;
+    QVector<float> dFrac;
+    QVector<float> dTarget;
+    bool usable;
+};
+
+// 图版坐标轴对应的拟合参数名
+QString fitNameForAxis(const QString& axisName)
+{
+    if (axisName == "M12") return "km";
+    if (axisName == "LfD") return "Lf";
+    return axisName;
+}
+
+const FitParameter* findParam(const QList<FitParameter>& params, const QString& name)
+{
+    for (const FitParameter& p : params) {
+        if (p.name == name) return &p;
+    }
+    return nullptr;
+}
+
+// 按网格插值位置计算一个节点曲线与目标值的加权平方和
+inline double shiftedSquaredError(const float* curve, const int* idx, const float* frac,
+                                  const float* target, int n)
+{
+    float acc = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        const float a = curve[idx[i]];
+        const float b = curve[idx[i] + 1];
+        const float e = a + frac[i] * (b - a) - target[i];
+        acc += e * e;
+    }
+    return acc;
+}
+
+} // namespace
+
+QVector<int> InitialGuessSearch::reduceLogSpaced(const QVector<double>& t, int maxPoints)
+{
+    QVector<int> valid;
+    for (int i = 0; i < t.size(); ++i) {
+        if (t[i] > 1e-12) valid.append(i);
+    }
+    if (valid.size() <= maxPoints || maxPoints < 2) return valid;
+
+    double logMin = std::log10(t[valid.first()]);
+    double logMax = logMin;
+    for (int i : valid) {
+        double lt = std::log10(t[i]);
+        logMin = qMin(logMin, lt);
+        logMax = qMax(logMax, lt);
+    }
+    double step = (logMax - logMin) / (maxPoints - 1);
+    if (step <= 0.0) return valid.mid(0, maxPoints);
+
+    // 每个对数区间取离区间中心最近的一个点
+    QVector<int> best(maxPoints, -1);
+    QVector<double> bestGap(maxPoints, std::numeric_limits<double>::max());
+    for (int i : valid) {
+        double lt = std::log10(t[i]);
+        int bin = qBound(0, (int)std::lround((lt - logMin) / step), maxPoints - 1);
+        double gap = std::abs(lt - (logMin + bin * step));
+        if (gap < bestGap[bin]) {
+            bestGap[bin] = gap;
+            best[bin] = i;
+        }
+    }
+
+    QVector<int> result;
+    for (int idx : best) {
+        if (idx >= 0) result.append(idx);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QSharedPointer<TypeCurveAtlas> InitialGuessSearch::buildCoarseAtlas(ModelType type,
+                                                                    const QList<FitParameter>& params,
+                                                                    const QMap<QString, double>& baseParams,
+                                                                    double logTdMin, double logTdMax,
+                                                                    const Options& options,
+                                                                    const CancellationToken& cancel)
+{
+    // 只有无因次模型参数可以作为网格轴 (kf、L 及物性参数通过平移或量纲换算体现)
+    static const QStringList gridNames = {
+        "km", "Lf", "omega1", "omega2", "lambda1", "rmD", "reD", "cD", "S", "nf"
+    };
+
+    double kf = baseParams.value("kf", 1e-3);
+    double L = baseParams.value("L", 1000.0);
+
+    QList<const FitParameter*> gridParams;
+    for (const FitParameter& p : params) {
+        if (p.isFit && p.isVisible && gridNames.contains(p.name)) gridParams.append(&p);
+    }
+
+    // 每轴 3 个节点，超出节点数上限时降为 2 个
+    int levels = 3;
+    if (std::pow(3.0, gridParams.size()) > options.maxGridNodes) levels = 2;
+
+    QVector<AtlasAxis> axes;
+    for (const FitParameter* p : gridParams) {
+        double v = baseParams.value(p->name, p->value);
+        double lo = p->min, hi = p->max;
+        bool logScale = ParameterSchema::usesLog(ParameterSchema::indexOf(p->name), v) && lo > 0.0;
+        if (logScale) {
+            lo = qMax(lo, v / 100.0);
+            hi = qMin(hi, v * 100.0);
+        }
+        if (hi < lo) std::swap(lo, hi);
+
+        QVector<double> values;
+        for (int k = 0; k < levels; ++k) {
+            double f = (levels > 1) ? double(k) / (levels - 1) : 0.5;
+            double x = logScale ? std::pow(10.0, std::log10(lo) + f * (std::log10(hi) - std::log10(lo)))
+                                : lo + f * (hi - lo);
+            if (p->name == "nf") x = qMax(1.0, (double)std::lround(x));
+
+            // 转换为图版轴的无因次取值
+            if (p->name == "km") x = (x > 0.0) ? kf / x : 1.0;
+            else if (p->name == "Lf") x = (L > 1e-9) ? x / L : 0.0;
+            values.append(x);
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        QString axisName = p->name;
+        if (p->name == "km") axisName = "M12";
+        else if (p->name == "Lf") axisName = "LfD";
+        axes.append(AtlasAxis{axisName, logScale && values.first() > 0.0, values});
+    }
+
+    // 图版生成时 kf 固定为 1，保持渗透率比不变
+    QMap<QString, double> gridBase = baseParams;
+    if (kf > 0.0) gridBase["km"] = baseParams.value("km", kf) / kf;
+
+    return TypeCurveAtlas::generate(type, axes, gridBase, options.gridTimePoints, logTdMin, logTdMax, 8, nullptr, cancel);
+}
+
+QVector<InitialGuessCandidate> InitialGuessSearch::search(ModelType type,
+                                                          const QList<FitParameter>& params,
+                                                          const QMap<QString, double>& baseParams,
+                                                          const QVector<double>& t,
+                                                          const QVector<double>& deltaP,
+                                                          const QVector<double>& deriv,
+                                                          double weight,
+                                                          QSharedPointer<TypeCurveAtlas> atlas,
+                                                          const Options& options,
+                                                          const CancellationToken& cancel)
+{
+    QVector<InitialGuessCandidate> result;
+
+    // 1. 抽稀实测数据 (对数坐标)
+    QVector<int> reduced = reduceLogSpaced(t, options.maxPoints);
+    QVector<double> pLogT, pLogObs, dLogT, dLogObs;
+    for (int i : reduced) {
+        double lt = std::log10(t[i]);
+        if (i < deltaP.size() && deltaP[i] > 1e-10) { pLogT.append(lt); pLogObs.append(std::log10(deltaP[i])); }
+        if (i < deriv.size() && deriv[i] > 1e-10) { dLogT.append(lt); dLogObs.append(std::log10(deriv[i])); }
+    }
+    if (pLogT.size() + dLogT.size() < 4) return result;
+
+    double logTMin = std::numeric_limits<double>::max(), logTMax = -logTMin;
+    for (double lt : pLogT) { logTMin = qMin(logTMin, lt); logTMax = qMax(logTMax, lt); }
+    for (double lt : dLogT) { logTMin = qMin(logTMin, lt); logTMax = qMax(logTMax, lt); }
+
+    // 2. kf 扫描序列
+    double phi = baseParams.value("phi", 0.05);
+    double mu = baseParams.value("mu", 0.5);
+    double B = baseParams.value("B", 1.05);
+    double Ct = baseParams.value("Ct", 5e-4);
+    double q = baseParams.value("q", 5.0);
+    double h = baseParams.value("h", 20.0);
+    double L = baseParams.value("L", 1000.0);
+    double kf0 = baseParams.value("kf", 1e-3);
+
+    QVector<double> kfValues;
+    const FitParameter* kfParam = findParam(params, "kf");
+    if (kfParam && kfParam->isFit && kf0 > 0.0) {
+        double lo = qMax(kfParam->min, kf0 / std::pow(10.0, options.kfDecades));
+        double hi = qMin(kfParam->max, kf0 * std::pow(10.0, options.kfDecades));
+        if (lo > 0.0 && hi > lo) {
+            int steps = qMax(2, options.kfSteps);
+            for (int k = 0; k < steps; ++k) {
+                kfValues.append(std::pow(10.0, std::log10(lo) + k * (std::log10(hi) - std::log10(lo)) / (steps - 1)));
+            }
+        }
+    }
+    if (kfValues.isEmpty()) kfValues.append(kf0);
+
+    auto logTimeShift = [&](double kf) { return std::log10(14.4 * kf / (phi * mu * Ct * L * L)); };
+    auto logPressureShift = [&](double kf) { return std::log10(1.842e-3 * q * mu * B / (kf * h)); };
+
+    // 3. 候选曲线来源: 已加载的图版，或现场生成的粗网格
+    if (!atlas || !atlas->isValid() || atlas->modelType() != type) {
+        double logTdMin = logTMin + logTimeShift(kfValues.first()) - 0.2;
+        double logTdMax = logTMax + logTimeShift(kfValues.last()) + 0.2;
+        atlas = buildCoarseAtlas(type, params, baseParams, logTdMin, logTdMax, options, cancel);
+    }
+    if (!atlas || !atlas->isValid()) return result;
+    if (cancel.isCancelled()) return result;
+
+    const int nTime = atlas->timeCount();
+    const QVector<double> tdGrid = atlas->timeGrid();
+    const double gridMin = std::log10(tdGrid.first());
+    const double gridStep = (std::log10(tdGrid.last()) - gridMin) / (nTime - 1);
+
+    // 4. 每个 kf 下数据点在图版时间网格上的插值位置 (覆盖不足 70% 的 kf 不参与比较)
+    auto buildSamples = [&](const QVector<double>& logT, const QVector<double>& logObs, double shiftT, double shiftP,
+                            QVector<int>& idx, QVector<float>& frac, QVector<float>& target) {
+        for (int i = 0; i < logT.size(); ++i) {
+            double x = (logT[i] + shiftT - gridMin) / gridStep;
+            if (x < 0.0 || x > nTime - 1) continue;
+            int k = qMin((int)x, nTime - 2);
+            idx.append(k);
+            frac.append(float(x - k));
+            target.append(float(logObs[i] - shiftP));
+        }
+    };
+
+    QVector<ShiftedSamples> samples(kfValues.size());
+    for (int s = 0; s < kfValues.size(); ++s) {
+        ShiftedSamples& smp = samples[s];
+        double shiftT = logTimeShift(kfValues[s]);
+        double shiftP = logPressureShift(kfValues[s]);
+        buildSamples(pLogT, pLogObs, shiftT, shiftP, smp.pIdx, smp.pFrac, smp.pTarget);
+        buildSamples(dLogT, dLogObs, shiftT, shiftP, smp.dIdx, smp.dFrac, smp.dTarget);
+        smp.usable = (smp.pIdx.size() + smp.dIdx.size()) >= 0.7 * (pLogT.size() + dLogT.size());
+    }
+
+    // 5. 确定参与搜索的节点: 拟合参数对应的轴取全部 (上下限以内的) 节点，其余轴取最接近当前值的节点
+    const QVector<AtlasAxis>& axes = atlas->axes();
+    QVector<QVector<int>> allowed(axes.size());
+    QVector<bool> axisFitted(axes.size(), false);
+    for (int a = 0; a < axes.size(); ++a) {
+        const AtlasAxis& axis = axes[a];
+        const FitParameter* fp = findParam(params, fitNameForAxis(axis.name));
+        if (fp && fp->isFit) {
+            axisFitted[a] = true;
+            for (int k = 0; k < axis.values.size(); ++k) {
+                double v = axis.values[k];
+                if (axis.name == "LfD") v *= L;
+                if (axis.name == "M12" || (v >= fp->min && v <= fp->max)) allowed[a].append(k);
+            }
+        }
+        if (allowed[a].isEmpty()) {
+            double cur = TypeCurveAtlas::axisParamValue(axis.name, baseParams);
+            double tc = axis.logScale ? std::log10(qMax(cur, 1e-300)) : cur;
+            int nearest = 0;
+            double bestGap = std::numeric_limits<double>::max();
+            for (int k = 0; k < axis.values.size(); ++k) {
+                double tv = axis.logScale ? std::log10(qMax(axis.values[k], 1e-300)) : axis.values[k];
+                if (std::abs(tv - tc) < bestGap) { bestGap = std::abs(tv - tc); nearest = k; }
+            }
+            allowed[a].append(nearest);
+        }
+    }
+
+    QVector<qint64> strides(axes.size());
+    qint64 stride = 1;
+    for (int a = axes.size() - 1; a >= 0; --a) {
+        strides[a] = stride;
+        stride *= axes[a].values.size();
+    }
+
+    QVector<NodeScore> scores;
+    QVector<int> counter(axes.size(), 0);
+    while (true) {
+        qint64 node = 0;
+        for (int a = 0; a < axes.size(); ++a) node += allowed[a][counter[a]] * strides[a];
+        scores.append(NodeScore{node, std::numeric_limits<double>::max(), 0});
+
+        int a = axes.size() - 1;
+        while (a >= 0 && ++counter[a] >= allowed[a].size()) { counter[a] = 0; --a; }
+        if (a < 0) break;
+    }
+
+    // 6. 并行计算各节点在全部 kf 平移下的最小距离
+    const double wp = weight;
+    const double wd = 1.0 - weight;
+    QtConcurrent::blockingMap(scores, [&](NodeScore& score) {
+        if (cancel.isCancelled()) return;
+        const float* lp = atlas->nodeLogPressure(score.node);
+        const float* ld = atlas->nodeLogDerivative(score.node);
+        for (int s = 0; s < samples.size(); ++s) {
+            const ShiftedSamples& smp = samples[s];
+            if (!smp.usable) continue;
+            double ep = shiftedSquaredError(lp, smp.pIdx.constData(), smp.pFrac.constData(),
+                                            smp.pTarget.constData(), smp.pIdx.size());
+            double ed = shiftedSquaredError(ld, smp.dIdx.constData(), smp.dFrac.constData(),
+                                            smp.dTarget.constData(), smp.dIdx.size());
+            double norm = wp * smp.pIdx.size() + wd * smp.dIdx.size();
+            if (norm <= 0.0) continue;
+            double dist = std::sqrt((wp * ep + wd * ed) / norm);
+            if (dist < score.distance) {
+                score.distance = dist;
+                score.kfIndex = s;
+            }
+        }
+    });
+    if (cancel.isCancelled()) return result;
+
+    // 7. 取前 k 个节点，换算回有量纲参数
+    int topK = qMin(qMax(1, options.topK), (int)scores.size());
+    std::partial_sort(scores.begin(), scores.begin() + topK, scores.end(),
+                      [](const NodeScore& a, const NodeScore& b) { return a.distance < b.distance; });
+
+    for (int c = 0; c < topK; ++c) {
+        const NodeScore& score = scores[c];
+        if (score.distance == std::numeric_limits<double>::max()) break;
+
+        InitialGuessCandidate cand;
+        cand.params = baseParams;
+        cand.distance = score.distance;
+        double kf = kfValues[score.kfIndex];
+        cand.params["kf"] = kf;
+
+        for (int a = 0; a < axes.size(); ++a) {
+            if (!axisFitted[a]) continue;
+            const AtlasAxis& axis = axes[a];
+            double v = axis.values[(score.node / strides[a]) % axis.values.size()];
+            TypeCurveAtlas::setAxisParam(cand.params, axis.name, v);
+        }
+
+        // 限制在参数上下限之内
+        for (const FitParameter& fp : params) {
+            if (fp.isFit && cand.params.contains(fp.name))
+                cand.params[fp.name] = qBound(fp.min, cand.params[fp.name], fp.max);
+        }
+        ParameterSchema::applyDependencies(cand.params);
+        result.append(cand);
+    }
+    return result;
+}
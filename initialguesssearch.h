@@ -0,0 +1,72 @@
+/*
+ * initialguesssearch.h
+ * 文件作用: 拟合前的全局初值搜索 (类型曲线图版匹配) 头文件
+ * 功能描述:
+ * 1. 将实测数据在对数时间上抽稀为约 40 个点，作为匹配目标。
+ * 2. 候选曲线来自类型曲线图版: 优先使用 ModelManager 已加载的离线图版，
+ *    否则按拟合参数的上下限现场生成一个粗网格图版 (并行计算)。
+ * 3. 对每个图版节点在 kf 方向上扫描 (kf 只引起双对数坐标下的平移)，
+ *    在 log-log 空间计算与实测压差、导数的加权距离，并行遍历全部节点。
+ * 4. 按距离排序给出前 k 组候选参数，供 LM 拟合选择起始点。
+ */
+
+#ifndef INITIALGUESSSEARCH_H
+#define INITIALGUESSSEARCH_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QList>
+#include <QSharedPointer>
+
+#include "modelenums.h"
+#include "fittingparameterchart.h"
+#include "typecurveatlas.h"
+
+// 一组候选初值
+struct InitialGuessCandidate {
+    QMap<QString, double> params;   // 完整的模型参数表 (已写回 kf/km/Lf 等有量纲参数)
+    double distance;                // 抽稀数据上的加权 RMS 对数距离
+};
+
+class InitialGuessSearch
+{
+public:
+    // 搜索设置
+    struct Options {
+        int maxPoints = 40;         // 抽稀后的数据点数
+        int kfSteps = 31;           // kf 扫描步数
+        double kfDecades = 3.0;     // kf 扫描范围: 当前值上下各若干个数量级 (再与参数上下限取交集)
+        int topK = 5;               // 返回的候选个数
+        int maxGridNodes = 729;     // 现场生成粗网格时的节点数上限
+        int gridTimePoints = 48;    // 现场生成粗网格的时间点数
+    };
+
+    // 执行搜索。atlas 为空时按 params 中勾选拟合的参数现场生成粗网格图版。
+    // baseParams 为当前的完整参数表 (含 LfD)，weight 为压差权重 (导数权重为 1-weight)。
+    // cancel 被取消时尽快结束 (含粗网格图版的生成) 并返回空结果。
+    static QVector<InitialGuessCandidate> search(ModelType type,
+                                                 const QList<FitParameter>& params,
+                                                 const QMap<QString, double>& baseParams,
+                                                 const QVector<double>& t,
+                                                 const QVector<double>& deltaP,
+                                                 const QVector<double>& deriv,
+                                                 double weight,
+                                                 QSharedPointer<TypeCurveAtlas> atlas,
+                                                 const Options& options,
+                                                 const CancellationToken& cancel = CancellationToken());
+
+    // 按对数时间等间距抽稀，返回被选中数据点的下标
+    static QVector<int> reduceLogSpaced(const QVector<double>& t, int maxPoints);
+
+private:
+    // 现场生成覆盖拟合参数范围的粗网格图版
+    static QSharedPointer<TypeCurveAtlas> buildCoarseAtlas(ModelType type,
+                                                           const QList<FitParameter>& params,
+                                                           const QMap<QString, double>& baseParams,
+                                                           double logTdMin, double logTdMax,
+                                                           const Options& options,
+                                                           const CancellationToken& cancel);
+};
+
+#endif // INITIALGUESSSEARCH_H
@@ -0,0 +1,74 @@
+/*
+ * livecurvepreview.cpp
+ * 文件作用: 参数滑块拖动时理论曲线的后台渐进计算实现文件
+ * 功能描述:
+ * 1. 线程池只保留两个线程: 一个线程上被取消的计算尚在收尾时，新请求可以立即在另一个线程上开始。
+ * 2. 每个阶段算完后以排队调用回到界面线程，再次核对请求序号后才发出 curveReady。
+ */
+
+#include "livecurvepreview.h"
+
+#include <QtConcurrent>
+
+LiveCurvePreview::LiveCurvePreview(QObject* parent)
+    : QObject(parent)
+    , m_generation(0)
+{
+    m_pool.setMaxThreadCount(2);
+}
+
+LiveCurvePreview::~LiveCurvePreview()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void LiveCurvePreview::setStages(const Stage& preview, const QVector<Stage>& refinements)
+{
+    m_preview = preview;
+    m_refinements = refinements;
+}
+
+void LiveCurvePreview::preview(const ParamVector& params)
+{
+    if (!m_preview) return;
+    submit(params, {m_preview}, 0, m_refinements.isEmpty());
+}
+
+void LiveCurvePreview::refine(const ParamVector& params)
+{
+    if (m_refinements.isEmpty()) {
+        preview(params);
+        return;
+    }
+    submit(params, m_refinements, 1, true);
+}
+
+void LiveCurvePreview::cancel()
+{
+    m_generation.fetchAndAddOrdered(1);
+    m_cancelToken.cancel();
+}
+
+void LiveCurvePreview::submit(const ParamVector& params, const QVector<Stage>& stages, int stageOffset, bool lastIsFinal)
+{
+    cancel();
+    const quint64 generation = m_generation.loadAcquire();
+    const CancellationToken token = CancellationToken::create();
+    m_cancelToken = token;
+
+    (void)QtConcurrent::run(&m_pool, [this, params, stages, stageOffset, lastIsFinal, generation, token]() {
+        for (int i = 0; i < stages.size(); ++i) {
+            // 排队期间已被新请求取代: 直接放弃
+            if (token.isCancelled() || m_generation.loadAcquire() != generation) return;
+            ModelCurveData curve = stages[i](params, token);
+            if (token.isCancelled() || std::get<0>(curve).isEmpty()) return;
+
+            const int stage = stageOffset + i;
+            const bool isFinal = lastIsFinal && (i == stages.size() - 1);
+            QMetaObject::invokeMethod(this, [this, params, curve, stage, isFinal, generation]() {
+                if (m_generation.loadAcquire() == generation) emit curveReady(params, curve, stage, isFinal);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
@@ -0,0 +1,62 @@
+/*
+ * livecurvepreview.h
+ * 文件作用: 参数滑块拖动时理论曲线的后台渐进计算头文件
+ * 功能描述:
+ * 1. 计算分阶段进行: 预览阶段 (图版插值或低阶反演、少量时间点) 在拖动过程中每次参数变化时计算；
+ *    参数停止变化后依次计算各细化阶段，直至全精度，每完成一个阶段界面即更新一次曲线。
+ * 2. 新请求使旧请求作废: 旧请求的取消令牌被置位，求解器在当前时间点算完后返回；
+ *    已排队但尚未开始的旧任务在开始时发现自己已过期即直接返回，不会逐个补算。
+ *    作废请求即使已算完，其结果也不会发出 (按请求序号过滤)。
+ * 3. 计算在专用线程池中进行 (不占用拟合等任务使用的全局线程池)，析构时取消并等待工作线程退出。
+ */
+
+#ifndef LIVECURVEPREVIEW_H
+#define LIVECURVEPREVIEW_H
+
+#include <QObject>
+#include <QVector>
+#include <QThreadPool>
+#include <QAtomicInteger>
+#include <functional>
+
+#include "modelsolver01_06.h"
+#include "parameterschema.h"
+#include "cancellationtoken.h"
+
+class LiveCurvePreview : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 一个计算阶段: 在 params 处计算理论曲线，被取消时返回空结果
+    using Stage = std::function<ModelCurveData(const ParamVector&, const CancellationToken&)>;
+
+    explicit LiveCurvePreview(QObject* parent = nullptr);
+    ~LiveCurvePreview();
+
+    // 设置预览阶段与细化阶段 (按精度由低到高)，对之后的请求生效
+    void setStages(const Stage& preview, const QVector<Stage>& refinements);
+
+    // 参数变化 (拖动中): 作废进行中的计算，只计算预览阶段
+    void preview(const ParamVector& params);
+    // 参数停止变化: 作废进行中的计算，依次计算全部细化阶段
+    void refine(const ParamVector& params);
+    // 作废进行中的计算
+    void cancel();
+
+signals:
+    // 曲线已算完 (界面线程中发出)；stage 为 0 表示预览，1.. 为细化阶段，isFinal 表示最高精度阶段
+    void curveReady(const ParamVector& params, const ModelCurveData& curve, int stage, bool isFinal);
+
+private:
+    // 作废旧请求并按 stages 启动新请求，stageOffset 为 stages[0] 的阶段号
+    void submit(const ParamVector& params, const QVector<Stage>& stages, int stageOffset, bool lastIsFinal);
+
+    Stage m_preview;
+    QVector<Stage> m_refinements;
+    QThreadPool m_pool;
+    CancellationToken m_cancelToken;
+    QAtomicInteger<quint64> m_generation;   // 最新请求序号 (工作线程读取以判断是否过期)
+};
+
+#endif // LIVECURVEPREVIEW_H
@@ -0,0 +1,336 @@
+/*
+ * livegaugewidget.cpp
+ * 文件作用: 实时监测窗口实现文件
+ * 功能描述:
+ * 1. 每帧最多取出 MaxSamplesPerFrame 个样本: 1 kHz 采样时每帧只有几十个样本，
+ *    追踪已有大量数据的文件时则分多帧追上，界面不会因积压数据卡顿。
+ * 2. 曲线的数据容器与分析点按下标一一对应: 新点以 addData 追加在末尾，
+ *    尾部导数修正时直接改写容器中对应点的值；非正值以 NaN 占位 (双对数图中不显示)。
+ */
+
+#include "livegaugewidget.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QCloseEvent>
+#include <limits>
+
+namespace {
+// 取样与刷新周期 (ms)
+const int DrainInterval = 33;
+// 每帧最多处理的样本数
+const int MaxSamplesPerFrame = 200000;
+
+inline double positiveOrNaN(double v)
+{
+    return v > 0.0 ? v : std::numeric_limits<double>::quiet_NaN();
+}
+}
+
+LiveGaugeWidget::LiveGaugeWidget(QWidget* parent)
+    : QWidget(parent)
+    , m_rateBase(0)
+    , m_sampleRate(0.0)
+    , m_xMin(std::numeric_limits<double>::infinity())
+    , m_xMax(0.0)
+    , m_yMin(std::numeric_limits<double>::infinity())
+    , m_yMax(0.0)
+{
+    setupUI();
+    setupPlot();
+
+    m_drainTimer.setInterval(DrainInterval);
+    connect(&m_drainTimer, &QTimer::timeout, this, &LiveGaugeWidget::onDrainTimeout);
+
+    onSourceKindChanged(m_kindCombo->currentIndex());
+    setRunning(false);
+    updateStatus();
+}
+
+LiveGaugeWidget::~LiveGaugeWidget()
+{
+    m_drainTimer.stop();
+    m_reader.reset();
+}
+
+void LiveGaugeWidget::setupUI()
+{
+    setWindowTitle("实时监测");
+    resize(1000, 720);
+
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+    // 数据源组
+    QGroupBox* sourceGroup = new QGroupBox("数据源");
+    QGridLayout* grid = new QGridLayout(sourceGroup);
+
+    m_kindCombo = new QComboBox;
+    m_kindCombo->addItem("追踪数据文件");
+    m_kindCombo->addItem("TCP 数据流");
+    m_kindCombo->addItem("本地套接字");
+    m_addressEdit = new QLineEdit;
+    m_browseBtn = new QPushButton("浏览...");
+    m_formatCombo = new QComboBox;
+    m_formatCombo->addItem("CSV 文本 (时间,压力)");
+    m_formatCombo->addItem("二进制 (double 时间, double 压力)");
+    m_timeUnitCombo = new QComboBox;
+    m_timeUnitCombo->addItem("s");
+    m_timeUnitCombo->addItem("min");
+    m_timeUnitCombo->addItem("h");
+
+    grid->addWidget(new QLabel("类型:"), 0, 0);
+    grid->addWidget(m_kindCombo, 0, 1);
+    grid->addWidget(new QLabel("地址:"), 0, 2);
+    grid->addWidget(m_addressEdit, 0, 3, 1, 3);
+    grid->addWidget(m_browseBtn, 0, 6);
+    grid->addWidget(new QLabel("格式:"), 1, 0);
+    grid->addWidget(m_formatCombo, 1, 1);
+    grid->addWidget(new QLabel("时间单位:"), 1, 2);
+    grid->addWidget(m_timeUnitCombo, 1, 3);
+
+    // 分析参数
+    m_testTypeCombo = new QComboBox;
+    m_testTypeCombo->addItem("压力降落 (Drawdown)");
+    m_testTypeCombo->addItem("压力恢复 (Buildup)");
+    m_piSpin = new QDoubleSpinBox;
+    m_piSpin->setRange(0.0, 1e6);
+    m_piSpin->setDecimals(4);
+    m_piSpin->setSpecialValueText("取首个样本");
+    m_lSpacingSpin = new QDoubleSpinBox;
+    m_lSpacingSpin->setRange(0.01, 1.0);
+    m_lSpacingSpin->setSingleStep(0.05);
+    m_lSpacingSpin->setValue(0.15);
+    m_autoScaleCheck = new QCheckBox("自动缩放");
+    m_autoScaleCheck->setChecked(true);
+
+    grid->addWidget(new QLabel("试井类型:"), 2, 0);
+    grid->addWidget(m_testTypeCombo, 2, 1);
+    grid->addWidget(new QLabel("初始压力:"), 2, 2);
+    grid->addWidget(m_piSpin, 2, 3);
+    grid->addWidget(new QLabel("L-Spacing:"), 2, 4);
+    grid->addWidget(m_lSpacingSpin, 2, 5);
+    grid->addWidget(m_autoScaleCheck, 2, 6);
+    mainLayout->addWidget(sourceGroup);
+
+    connect(m_kindCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LiveGaugeWidget::onSourceKindChanged);
+    connect(m_testTypeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        m_piSpin->setEnabled(index == 0);
+    });
+    connect(m_browseBtn, &QPushButton::clicked, this, &LiveGaugeWidget::onBrowseClicked);
+
+    m_plot = new MouseZoom(this);
+    mainLayout->addWidget(m_plot, 1);
+
+    // 底部状态与按钮
+    QHBoxLayout* btnLayout = new QHBoxLayout;
+    m_statusLabel = new QLabel;
+    m_statusLabel->setStyleSheet("color: #333;");
+    m_startBtn = new QPushButton("开始采集");
+    m_stopBtn = new QPushButton("停止");
+    connect(m_startBtn, &QPushButton::clicked, this, &LiveGaugeWidget::onStartClicked);
+    connect(m_stopBtn, &QPushButton::clicked, this, &LiveGaugeWidget::onStopClicked);
+    btnLayout->addWidget(m_statusLabel, 1);
+    btnLayout->addWidget(m_startBtn);
+    btnLayout->addWidget(m_stopBtn);
+    mainLayout->addLayout(btnLayout);
+}
+
+void LiveGaugeWidget::setupPlot()
+{
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plot->setBackground(Qt::white);
+    m_plot->axisRect()->setBackground(Qt::white);
+
+    m_plot->plotLayout()->insertRow(0);
+    m_plot->plotLayout()->addElement(0, 0, new QCPTextElement(m_plot, "实时压差与导数", QFont("SimHei", 14, QFont::Bold)));
+
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    m_plot->xAxis->setScaleType(QCPAxis::stLogarithmic); m_plot->xAxis->setTicker(logTicker);
+    m_plot->yAxis->setScaleType(QCPAxis::stLogarithmic); m_plot->yAxis->setTicker(logTicker);
+    m_plot->xAxis->setNumberFormat("eb"); m_plot->xAxis->setNumberPrecision(0);
+    m_plot->yAxis->setNumberFormat("eb"); m_plot->yAxis->setNumberPrecision(0);
+
+    QFont labelFont("Arial", 12, QFont::Bold); QFont tickFont("Arial", 12);
+    m_plot->xAxis->setLabel("时间 Time (h)");
+    m_plot->yAxis->setLabel("压差 & 导数 Delta P & Derivative");
+    m_plot->xAxis->setLabelFont(labelFont); m_plot->yAxis->setLabelFont(labelFont);
+    m_plot->xAxis->setTickLabelFont(tickFont); m_plot->yAxis->setTickLabelFont(tickFont);
+
+    m_plot->xAxis->grid()->setSubGridVisible(true); m_plot->yAxis->grid()->setSubGridVisible(true);
+    m_plot->xAxis->grid()->setPen(QPen(QColor(220, 220, 220), 1, Qt::SolidLine));
+    m_plot->yAxis->grid()->setPen(QPen(QColor(220, 220, 220), 1, Qt::SolidLine));
+    m_plot->xAxis->grid()->setSubGridPen(QPen(QColor(240, 240, 240), 1, Qt::DotLine));
+    m_plot->yAxis->grid()->setSubGridPen(QPen(QColor(240, 240, 240), 1, Qt::DotLine));
+    m_plot->xAxis->setRange(1e-4, 1e2); m_plot->yAxis->setRange(1e-3, 1e2);
+
+    m_graphDp = m_plot->addGraph();
+    m_graphDp->setPen(Qt::NoPen);
+    m_graphDp->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, QColor(0, 100, 0), 5));
+    m_graphDp->setName("压差");
+
+    m_graphDeriv = m_plot->addGraph();
+    m_graphDeriv->setPen(Qt::NoPen);
+    m_graphDeriv->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssTriangle, Qt::magenta, 5));
+    m_graphDeriv->setName("导数");
+
+    m_plot->legend->setVisible(true);
+    m_plot->axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignTop | Qt::AlignLeft);
+}
+
+void LiveGaugeWidget::onSourceKindChanged(int index)
+{
+    m_browseBtn->setEnabled(index == GaugeSource::TailFile);
+    switch (index) {
+    case GaugeSource::TailFile:    m_addressEdit->setPlaceholderText("数据文件路径"); break;
+    case GaugeSource::TcpSocket:   m_addressEdit->setPlaceholderText("127.0.0.1:5000"); break;
+    case GaugeSource::LocalSocket: m_addressEdit->setPlaceholderText("套接字名称或路径"); break;
+    }
+}
+
+void LiveGaugeWidget::onBrowseClicked()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "选择数据文件", m_addressEdit->text(),
+                                                      "数据文件 (*.csv *.txt *.dat *.bin);;所有文件 (*.*)");
+    if (!path.isEmpty()) m_addressEdit->setText(path);
+}
+
+void LiveGaugeWidget::onStartClicked()
+{
+    const QString address = m_addressEdit->text().trimmed();
+    if (address.isEmpty()) {
+        QMessageBox::warning(this, "提示", "请填写数据源地址。");
+        return;
+    }
+
+    GaugeSource source;
+    source.kind = GaugeSource::Kind(m_kindCombo->currentIndex());
+    source.format = GaugeSource::Format(m_formatCombo->currentIndex());
+    source.address = address;
+
+    static const double timeScales[] = {1.0 / 3600.0, 1.0 / 60.0, 1.0};
+    LiveGaugeAnalysis::Config config;
+    config.testType = m_testTypeCombo->currentIndex() == 0 ? PressureDerivativeConfig::Drawdown
+                                                           : PressureDerivativeConfig::Buildup;
+    config.initialPressure = m_piSpin->value();
+    config.timeScale = timeScales[m_timeUnitCombo->currentIndex()];
+    config.lSpacing = m_lSpacingSpin->value();
+    m_analysis.reset(config);
+
+    m_graphDp->data()->clear();
+    m_graphDeriv->data()->clear();
+    m_xMin = m_yMin = std::numeric_limits<double>::infinity();
+    m_xMax = m_yMax = 0.0;
+    m_plot->requestReplot();
+
+    m_reader.reset(new GaugeReader(source));
+    connect(m_reader.data(), &GaugeReader::sourceError, this, &LiveGaugeWidget::onSourceError);
+    m_rateBase = 0;
+    m_sampleRate = 0.0;
+    m_rateClock.start();
+    m_reader->start();
+    m_drainTimer.start();
+    setRunning(true);
+}
+
+void LiveGaugeWidget::onStopClicked()
+{
+    if (!m_reader || !m_drainTimer.isActive()) return;
+    m_reader->stop();
+    m_drainTimer.stop();
+    // 取完停止前已进入缓冲区的样本
+    onDrainTimeout();
+    setRunning(false);
+}
+
+void LiveGaugeWidget::onSourceError(const QString& message)
+{
+    if (sender() != m_reader.data()) return;
+    onStopClicked();
+    QMessageBox::warning(this, "数据源错误", message);
+}
+
+void LiveGaugeWidget::onDrainTimeout()
+{
+    if (!m_reader) return;
+    m_batch.clear();
+    m_reader->takeSamples(m_batch, MaxSamplesPerFrame);
+
+    const int oldCount = m_analysis.pointCount();
+    for (const GaugeSample& s : m_batch) m_analysis.append(s);
+    appendToPlot(oldCount);
+    updateStatus();
+}
+
+void LiveGaugeWidget::appendToPlot(int oldCount)
+{
+    const int n = m_analysis.pointCount();
+    const int revision = qMin(m_analysis.revisionStart(), oldCount);
+    m_analysis.clearRevision();
+    if (n == oldCount && revision >= oldCount) return;
+
+    const QVector<double>& t = m_analysis.time();
+    const QVector<double>& dp = m_analysis.deltaP();
+    const QVector<double>& deriv = m_analysis.derivative();
+
+    // 尾部导数修正: 原地改写
+    QCPGraphDataContainer::iterator it = m_graphDeriv->data()->begin() + revision;
+    for (int i = revision; i < oldCount; ++i, ++it) it->value = positiveOrNaN(deriv[i]);
+
+    // 新分析点: 追加在末尾
+    for (int i = oldCount; i < n; ++i) {
+        m_graphDp->addData(t[i], positiveOrNaN(dp[i]));
+        m_graphDeriv->addData(t[i], positiveOrNaN(deriv[i]));
+        m_xMin = qMin(m_xMin, t[i]);
+        m_xMax = qMax(m_xMax, t[i]);
+        for (double v : {dp[i], deriv[i]}) {
+            if (v <= 0.0) continue;
+            m_yMin = qMin(m_yMin, v);
+            m_yMax = qMax(m_yMax, v);
+        }
+    }
+
+    if (m_autoScaleCheck->isChecked() && m_xMax > 0.0 && m_yMax > 0.0) {
+        m_plot->xAxis->setRange(m_xMin / 2.0, m_xMax * 2.0);
+        m_plot->yAxis->setRange(m_yMin / 2.0, m_yMax * 2.0);
+    }
+    m_plot->requestReplot();
+}
+
+void LiveGaugeWidget::updateStatus()
+{
+    const quint64 received = m_reader ? m_reader->receivedCount() : 0;
+    const quint64 dropped = m_reader ? m_reader->droppedCount() : 0;
+    if (m_rateClock.isValid() && m_rateClock.elapsed() >= 1000) {
+        m_sampleRate = (received - m_rateBase) * 1000.0 / m_rateClock.restart();
+        m_rateBase = received;
+    }
+
+    m_statusLabel->setText(QString("已接收 %1 个样本 | %2 Hz | 丢弃 %3 | 分析点 %4 | 最新 t = %5 h, Δp = %6")
+                               .arg(received)
+                               .arg(m_sampleRate, 0, 'f', 0)
+                               .arg(dropped)
+                               .arg(m_analysis.pointCount())
+                               .arg(m_analysis.lastTime(), 0, 'g', 6)
+                               .arg(m_analysis.lastDeltaP(), 0, 'g', 6));
+}
+
+void LiveGaugeWidget::setRunning(bool running)
+{
+    m_startBtn->setEnabled(!running);
+    m_stopBtn->setEnabled(running);
+    const QList<QWidget*> inputs = {m_kindCombo, m_addressEdit, m_formatCombo,
+                                    m_timeUnitCombo, m_testTypeCombo, m_lSpacingSpin};
+    for (QWidget* w : inputs) w->setEnabled(!running);
+    m_browseBtn->setEnabled(!running && m_kindCombo->currentIndex() == GaugeSource::TailFile);
+    m_piSpin->setEnabled(!running && m_testTypeCombo->currentIndex() == 0);
+}
+
+void LiveGaugeWidget::closeEvent(QCloseEvent* event)
+{
+    onStopClicked();
+    QWidget::closeEvent(event);
+}
@@ -0,0 +1,90 @@
+/*
+ * livegaugewidget.h
+ * 文件作用: 实时监测窗口头文件
+ * 功能描述:
+ * 1. 代码构建的独立窗口，由项目界面的 "监测" 入口打开: 选择数据源 (追踪文件 / TCP / 本地套接字)、
+ *    数据格式、时间单位与试井类型后开始采集。
+ * 2. 界面线程按帧从 GaugeReader 的环形缓冲区批量取出样本交给 LiveGaugeAnalysis，
+ *    双对数图只追加新分析点、原地修正尾部导数，不重建曲线数据，重绘经 MouseZoom 按帧合并。
+ * 3. 状态栏显示接收样本数、采样速率、丢弃样本数、分析点数与最新压差。
+ */
+
+#ifndef LIVEGAUGEWIDGET_H
+#define LIVEGAUGEWIDGET_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+
+#include "gaugeacquisition.h"
+#include "mousezoom.h"
+
+class LiveGaugeWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LiveGaugeWidget(QWidget* parent = nullptr);
+    ~LiveGaugeWidget();
+
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
+private slots:
+    void onSourceKindChanged(int index);
+    void onBrowseClicked();
+    void onStartClicked();
+    void onStopClicked();
+    // 取出环形缓冲区中的样本并更新图表 (每帧一次)
+    void onDrainTimeout();
+    void onSourceError(const QString& message);
+
+private:
+    void setupUI();
+    void setupPlot();
+    void setRunning(bool running);
+
+    // 把上次以来新增的分析点追加到曲线，并修正尾部已变化的导数
+    void appendToPlot(int oldCount);
+    void updateStatus();
+
+    // 采集参数
+    QComboBox* m_kindCombo;
+    QLineEdit* m_addressEdit;
+    QPushButton* m_browseBtn;
+    QComboBox* m_formatCombo;
+    QComboBox* m_timeUnitCombo;
+    QComboBox* m_testTypeCombo;
+    QDoubleSpinBox* m_piSpin;
+    QDoubleSpinBox* m_lSpacingSpin;
+    QCheckBox* m_autoScaleCheck;
+    QPushButton* m_startBtn;
+    QPushButton* m_stopBtn;
+    QLabel* m_statusLabel;
+
+    MouseZoom* m_plot;
+    QCPGraph* m_graphDp;
+    QCPGraph* m_graphDeriv;
+
+    QScopedPointer<GaugeReader> m_reader;
+    LiveGaugeAnalysis m_analysis;
+    QVector<GaugeSample> m_batch;   // 每帧取出的样本 (复用缓冲区)
+    QTimer m_drainTimer;
+
+    // 采样速率统计
+    QElapsedTimer m_rateClock;
+    quint64 m_rateBase;
+    double m_sampleRate;
+
+    // 已显示数据的范围 (自动缩放用)
+    double m_xMin, m_xMax, m_yMin, m_yMax;
+};
+
+#endif // LIVEGAUGEWIDGET_H
@@ -10,6 +10,10 @@
  */
 
 #include "mainwindow.h"
+#include "typecurveatlas.h"
+#include "stehfestbenchmark.h"
+#include "bourdetbenchmark.h"
+#include "reportgenerator.h"
 #include <QApplication>
 #include <QStyleFactory>
 #include <QMessageBox>
@@ -18,6 +22,30 @@
 
 int main(int argc, char *argv[])
 {
+    // 命令行模式: 离线生成类型曲线图版 (不创建界面)
+    for (int i = 1; i < argc; ++i) {
+        if (QString::fromLocal8Bit(argv[i]) == "--generate-atlas") {
+            QCoreApplication cliApp(argc, argv);
+            return TypeCurveAtlas::runGeneratorCli(cliApp.arguments());
+        }
+        // 命令行模式: Stehfest 高项数反演的精度与耗时基准
+        if (QString::fromLocal8Bit(argv[i]) == "--bench-stehfest") {
+            QCoreApplication cliApp(argc, argv);
+            return StehfestBenchmark::runCli(cliApp.arguments());
+        }
+        // 命令行模式: 增量 Bourdet 导数与逐点搜索的一致性检查及耗时
+        if (QString::fromLocal8Bit(argv[i]) == "--bench-bourdet") {
+            QCoreApplication cliApp(argc, argv);
+            return BourdetBenchmark::runCli(cliApp.arguments());
+        }
+        // 命令行模式: 由项目文件生成试井分析报告 (绘图需要字体，使用离屏平台的 QGuiApplication)
+        if (QString::fromLocal8Bit(argv[i]) == "--report") {
+            if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+            QGuiApplication cliApp(argc, argv);
+            return ReportGenerator::runCli(cliApp.arguments());
+        }
+    }
+
 // [修复] 解决 HighDpiScaling 在 Qt6 中已废弃的警告
 // 只有在 Qt 6.0 之前的版本才需要手动启用，Qt 6 默认启用
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
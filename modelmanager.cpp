@@ -5,17 +5,22 @@
  * 1. 实例化 WT_ModelWidget 并将其加入界面布局。
  * 2. 实现 calculateTheoreticalCurve，直接调用 ModelSolver01_06 的静态方法，
  * 从而实现了界面与算法的解耦，提高了拟合计算的效率和安全性。
+ * 3. 样条计算方式下，给定时刻数超过基础网格点数的 2 倍时改为网格反演 + 插值 (曲线与偏导均适用)。
  */
 
 #include "modelmanager.h"
 #include "modelparameter.h"
 #include <QVBoxLayout>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
 #include <QDebug>
 #include <cmath>
 
 ModelManager::ModelManager(QObject *parent)
     : QObject(parent)
     , m_highPrecision(true)
+    , m_evaluationMode(Eval_Direct)
 {
 }
 
@@ -43,6 +48,7 @@ void ModelManager::initializeModels(QWidget* parentContainer)
 
         // 使用新的界面类 WT_ModelWidget
         WT_ModelWidget* widget = new WT_ModelWidget(type, parentContainer);
+        widget->setModelManager(this);
 
         // 默认隐藏，由外部逻辑控制显示哪一个
         widget->hide();
@@ -59,6 +65,41 @@ void ModelManager::initializeModels(QWidget* parentContainer)
     if (!m_modelWidgets.isEmpty()) {
         m_modelWidgets.first()->show();
     }
+
+    // 加载随程序发布的类型曲线图版 (程序目录下的 atlas 子目录)
+    loadTypeCurveAtlases(QDir(QCoreApplication::applicationDirPath()).filePath("atlas"));
+}
+
+int ModelManager::loadTypeCurveAtlases(const QString& dir)
+{
+    int loaded = 0;
+    for (int i = 0; i < 6; ++i) {
+        ModelType type = static_cast<ModelType>(i);
+        QString path = QDir(dir).filePath(TypeCurveAtlas::defaultFileName(type));
+        if (!QFileInfo::exists(path)) continue;
+
+        QSharedPointer<TypeCurveAtlas> atlas(new TypeCurveAtlas);
+        if (atlas->load(path) && atlas->modelType() == type) {
+            m_atlases[type] = atlas;
+            loaded++;
+        }
+    }
+    return loaded;
+}
+
+QSharedPointer<TypeCurveAtlas> ModelManager::typeCurveAtlas(ModelType type) const
+{
+    return m_atlases.value(type);
+}
+
+bool ModelManager::calculatePreviewCurve(ModelType type,
+                                         const QMap<QString, double>& params,
+                                         const QVector<double>& providedTime,
+                                         ModelCurveData& out) const
+{
+    QSharedPointer<TypeCurveAtlas> atlas = m_atlases.value(type);
+    if (!atlas || !atlas->isValid()) return false;
+    return atlas->evaluate(params, providedTime, out);
 }
 
 // 核心修改点：计算理论曲线
@@ -68,9 +109,56 @@ ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type,
                                                        const QVector<double>& providedTime)
 {
     // 直接调用纯数学计算类，传入当前管理的精度设置
+    if (m_evaluationMode == Eval_Spline)
+        return calculateTheoreticalCurve(type, ParameterSchema::fromMap(params), providedTime);
     return ModelSolver01_06::calculateTheoreticalCurve(type, params, providedTime, m_highPrecision);
 }
 
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type,
+                                                       const ParamVector& params,
+                                                       const QVector<double>& providedTime,
+                                                       const CancellationToken& cancel)
+{
+    const bool highPrecision = m_highPrecision;
+    if (m_evaluationMode == Eval_Spline) {
+        const SplineEvalOptions options = m_splineOptions;
+        int gridSize = SplineCurveEvaluator::baseGridSize(providedTime, options.pointsPerDecade);
+        if (gridSize >= 4 && providedTime.size() > 2 * gridSize) {
+            return SplineCurveEvaluator::evaluate([&](const QVector<double>& t) {
+                return ModelSolver01_06::calculateTheoreticalCurve(type, params, t, highPrecision, cancel);
+            }, providedTime, options);
+        }
+    }
+    return ModelSolver01_06::calculateTheoreticalCurve(type, params, providedTime, highPrecision, cancel);
+}
+
+ModelSensitivityData ModelManager::calculateCurveSensitivity(ModelType type,
+                                                             const QMap<QString, double>& params,
+                                                             const QStringList& sensNames,
+                                                             const QVector<double>& providedTime)
+{
+    return ModelSolver01_06::calculateCurveSensitivity(type, params, sensNames, providedTime, m_highPrecision);
+}
+
+ModelSensitivityData ModelManager::calculateCurveSensitivity(ModelType type,
+                                                             const ParamVector& params,
+                                                             const QVector<int>& sensIds,
+                                                             const QVector<double>& providedTime,
+                                                             const CancellationToken& cancel)
+{
+    const bool highPrecision = m_highPrecision;
+    if (m_evaluationMode == Eval_Spline) {
+        const SplineEvalOptions options = m_splineOptions;
+        int gridSize = SplineCurveEvaluator::baseGridSize(providedTime, options.pointsPerDecade);
+        if (gridSize >= 4 && providedTime.size() > 2 * gridSize) {
+            return SplineCurveEvaluator::evaluateSensitivity([&](const QVector<double>& t) {
+                return ModelSolver01_06::calculateCurveSensitivity(type, params, sensIds, t, highPrecision, cancel);
+            }, providedTime, options);
+        }
+    }
+    return ModelSolver01_06::calculateCurveSensitivity(type, params, sensIds, providedTime, highPrecision, cancel);
+}
+
 void ModelManager::setHighPrecision(bool high)
 {
     m_highPrecision = high;
@@ -80,6 +168,16 @@ void ModelManager::setHighPrecision(bool high)
     }
 }
 
+void ModelManager::setEvaluationMode(EvaluationMode mode)
+{
+    m_evaluationMode = mode;
+}
+
+void ModelManager::setSplineOptions(const SplineEvalOptions& options)
+{
+    m_splineOptions = options;
+}
+
 void ModelManager::updateAllModelsBasicParameters()
 {
     // 通知所有界面重置/更新基础参数
@@ -5,7 +5,9 @@
  * 1. 负责管理所有的试井解释模型（目前为复合模型01-06）。
  * 2. 充当“工厂”角色，在界面上创建并初始化具体的模型界面(WT_ModelWidget)。
  * 3. 作为“计算中转站”，为拟合模块(FittingWidget)提供理论曲线计算服务，底层调用 ModelSolver。
- * 4. 维护模型计算的全局设置（如精度控制）。
+ * 4. 维护模型计算的全局设置（如精度控制、计算方式）。
+ * 5. 样条插值计算方式: 观测点远多于对数网格点时，在自适应对数网格上反演后插值到观测时刻，
+ *    拟合迭代的代价与观测点数无关 (见 SplineCurveEvaluator)。
  */
 
 #ifndef MODELMANAGER_H
@@ -15,17 +17,26 @@
 #include <QMap>
 #include <QVector>
 #include <QWidget>
+#include <QSharedPointer>
 #include <tuple>
 
 // 引入公共枚举和新拆分的类
 #include "modelenums.h"
 #include "wt_modelwidget.h"
 #include "modelsolver01_06.h"
+#include "typecurveatlas.h"
+#include "splinecurveevaluator.h"
 
 class ModelManager : public QObject
 {
     Q_OBJECT
 public:
+    // 理论曲线的计算方式
+    enum EvaluationMode {
+        Eval_Direct = 0,    // 在每个给定时刻直接反演
+        Eval_Spline = 1     // 自适应对数网格反演 + 单调三次样条插值
+    };
+
     explicit ModelManager(QObject *parent = nullptr);
     ~ModelManager();
 
@@ -42,12 +53,50 @@ public:
     // 供拟合模块在迭代过程中调用以加速
     void setHighPrecision(bool high);
 
+    // 设置计算方式 (样条方式只在给定时刻数明显多于网格点数时生效)
+    void setEvaluationMode(EvaluationMode mode);
+    EvaluationMode evaluationMode() const { return m_evaluationMode; }
+    void setSplineOptions(const SplineEvalOptions& options);
+
     // 计算理论曲线 (代理函数)
     // 拟合模块调用此函数，内部直接调用 ModelSolver 进行纯数学计算
     ModelCurveData calculateTheoreticalCurve(ModelType type,
                                              const QMap<QString, double>& params,
                                              const QVector<double>& providedTime = QVector<double>());
 
+    // 稠密参数向量版本 (拟合迭代的热点路径使用，避免 QMap 查找与拷贝)
+    // cancel 被取消时返回空结果
+    ModelCurveData calculateTheoreticalCurve(ModelType type,
+                                             const ParamVector& params,
+                                             const QVector<double>& providedTime,
+                                             const CancellationToken& cancel = CancellationToken());
+
+    // 计算理论曲线及其对指定参数的解析偏导 (代理函数)
+    // 拟合模块用其构造雅可比矩阵，替代逐参数的有限差分
+    ModelSensitivityData calculateCurveSensitivity(ModelType type,
+                                                   const QMap<QString, double>& params,
+                                                   const QStringList& sensNames,
+                                                   const QVector<double>& providedTime = QVector<double>());
+    ModelSensitivityData calculateCurveSensitivity(ModelType type,
+                                                   const ParamVector& params,
+                                                   const QVector<int>& sensIds,
+                                                   const QVector<double>& providedTime,
+                                                   const CancellationToken& cancel = CancellationToken());
+
+    // 加载类型曲线图版: 在 dir 目录下查找 atlas_model1.wta ... atlas_model6.wta (内存映射)
+    // 返回成功加载的图版个数
+    int loadTypeCurveAtlases(const QString& dir);
+
+    // 获取某模型的类型曲线图版 (未加载时返回空指针)
+    QSharedPointer<TypeCurveAtlas> typeCurveAtlas(ModelType type) const;
+
+    // 图版插值快速预览曲线 (近似结果，用于交互预览)
+    // 无对应图版时返回 false，调用方应退回 calculateTheoreticalCurve
+    bool calculatePreviewCurve(ModelType type,
+                               const QMap<QString, double>& params,
+                               const QVector<double>& providedTime,
+                               ModelCurveData& out) const;
+
     // 更新所有模型的基础参数 (当项目参数变更时调用)
     void updateAllModelsBasicParameters();
 
@@ -68,6 +117,13 @@ private:
 
     // 当前计算精度设置
     bool m_highPrecision;
+
+    // 当前计算方式及样条插值设置
+    EvaluationMode m_evaluationMode;
+    SplineEvalOptions m_splineOptions;
+
+    // 已加载的类型曲线图版
+    QMap<ModelType, QSharedPointer<TypeCurveAtlas>> m_atlases;
 };
 
 #endif // MODELMANAGER_H
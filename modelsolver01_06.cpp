@@ -6,6 +6,9 @@
  * 2. 使用 Eigen 库求解线性方程组。
  * 3. 使用 Boost 库计算 Bessel 函数。
  * 4. 实现了 Stehfest 数值反演算法将拉普拉斯空间解转换回实空间。
+ * 5. 拉普拉斯核函数按标量类型模板化，可用 DualNumber 一次求得压力及其参数偏导。
+ * 6. Stehfest 项数 N > 14 时权重正负交替且量级超过 1e8，权重与加权和改用双双精度计算，
+ *    消除权重本身与求和过程的舍入误差 (核函数值的舍入误差仍按权重量级放大，见 StehfestBenchmark)。
  */
 
 #include "modelsolver01_06.h"
@@ -22,11 +25,61 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+// DualNumber 的双双精度加权累加器: 函数值与各偏导分量分别累加
+struct ExtendedDualSum {
+    DoubleDouble v;
+    DoubleDouble d[DualNumber::MaxDerivs];
+    int n = 0;
+
+    void add(const DoubleDouble& w, const DualNumber& x) {
+        v += w * x.v;
+        for (int k = 0; k < x.n; ++k) d[k] += w * x.d[k];
+        n = std::max(n, x.n);
+    }
+
+    DualNumber value() const {
+        DualNumber r(v.toDouble());
+        r.n = n;
+        for (int k = 0; k < n; ++k) r.d[k] = d[k].toDouble();
+        return r;
+    }
+};
+
+} // namespace
+
+// 拉普拉斯核函数参数 (标量类型 T 为 double 或 DualNumber)
+template<typename T>
+struct ModelSolver01_06::KernelParams {
+    T M12;      // 渗透率比 kf/km
+    T LfD;      // 无因次缝长
+    T rmD;      // 无因次复合半径
+    T reD;      // 无因次外边界半径
+    T omega1;
+    T omega2;
+    T lambda1;
+    T cD;       // 无因次井储
+    T S;        // 表皮系数
+    int nf;     // 裂缝条数
+    QVector<double> xwD; // 裂缝位置分布
+};
+
 // 计算理论曲线的主入口
 ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(ModelType type,
                                                            const QMap<QString, double>& params,
                                                            const QVector<double>& providedTime,
-                                                           bool highPrecision)
+                                                           bool highPrecision,
+                                                           const CancellationToken& cancel)
+{
+    return calculateTheoreticalCurve(type, ParameterSchema::fromMap(params), providedTime, highPrecision, cancel);
+}
+
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(ModelType type,
+                                                           const ParamVector& params,
+                                                           const QVector<double>& providedTime,
+                                                           bool highPrecision,
+                                                           const CancellationToken& cancel)
 {
     // 1. 准备时间序列
     QVector<double> tPoints = providedTime;
@@ -36,14 +89,11 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(ModelType type,
     }
 
     // 2. 提取基础参数
-    double phi = params.value("phi", 0.05);
-    double mu = params.value("mu", 0.5);
-    double B = params.value("B", 1.05);
-    double Ct = params.value("Ct", 5e-4);
-    double q = params.value("q", 5.0);
-    double h = params.value("h", 20.0);
-    double kf = params.value("kf", 1e-3);
-    double L = params.value("L", 1000.0);
+    double phi = params[Param_phi];
+    double mu = params[Param_mu];
+    double Ct = params[Param_Ct];
+    double kf = params[Param_kf];
+    double L = params[Param_L];
 
     // 3. 计算无因次时间 tD
     QVector<double> tD_vec;
@@ -56,14 +106,13 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(ModelType type,
 
     // 4. 计算无因次压力和导数
     QVector<double> PD_vec, Deriv_vec;
-    // 绑定拉普拉斯空间函数，将 ModelType 传递进去
-    auto func = std::bind(&ModelSolver01_06::flaplace_composite, std::placeholders::_1, std::placeholders::_2, type);
-
-    calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec, highPrecision);
+    if (!calculatePDandDeriv(tD_vec, params, type, PD_vec, Deriv_vec, highPrecision, cancel)) {
+        return ModelCurveData();
+    }
 
     // 5. 转换回实有量纲压力和导数
     // 压力转换系数
-    double factor = 1.842e-3 * q * mu * B / (kf * h);
+    double factor = pressureScale(params);
     QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
 
     for(int i=0; i<tPoints.size(); ++i) {
@@ -74,41 +123,207 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(ModelType type,
     return std::make_tuple(tPoints, finalP, finalDP);
 }
 
+double ModelSolver01_06::pressureScale(const ParamVector& params)
+{
+    return 1.842e-3 * params[Param_q] * params[Param_mu] * params[Param_B] / (params[Param_kf] * params[Param_h]);
+}
+
+// 计算无因次理论曲线 (不含量纲换算)
+ModelCurveData ModelSolver01_06::calculateDimensionlessCurve(ModelType type,
+                                                             const QMap<QString, double>& params,
+                                                             const QVector<double>& tD,
+                                                             bool highPrecision,
+                                                             const CancellationToken& cancel)
+{
+    QVector<double> PD_vec, Deriv_vec;
+    if (!calculatePDandDeriv(tD, ParameterSchema::fromMap(params), type, PD_vec, Deriv_vec, highPrecision, cancel)) {
+        return ModelCurveData();
+    }
+    return std::make_tuple(tD, PD_vec, Deriv_vec);
+}
+
+// 前向自动微分计算理论曲线及参数偏导
+// 1. 所有参与计算的量 (包括 tD、Bessel 函数、数值积分限和线性方程组) 均以 DualNumber 传播偏导；
+// 2. 导数列与 calculateTheoreticalCurve 相同，对压差做 Bourdet 差分 (L = 0.1)，其偏导由同一差分作用于
+//    压差偏导得到 (左右点只取决于 ln tD 之差，与参数无关)，雅可比与拟合残差使用同一导数定义。
+ModelSensitivityData ModelSolver01_06::calculateCurveSensitivity(ModelType type,
+                                                                 const QMap<QString, double>& params,
+                                                                 const QStringList& sensNames,
+                                                                 const QVector<double>& providedTime,
+                                                                 bool highPrecision,
+                                                                 const CancellationToken& cancel)
+{
+    QVector<int> sensIds;
+    for (const QString& name : sensNames) sensIds.append(ParameterSchema::indexOf(name));
+    ModelSensitivityData out = calculateCurveSensitivity(type, ParameterSchema::fromMap(params), sensIds, providedTime, highPrecision, cancel);
+    out.paramNames = sensNames.mid(0, out.paramNames.size());
+    return out;
+}
+
+ModelSensitivityData ModelSolver01_06::calculateCurveSensitivity(ModelType type,
+                                                                 const ParamVector& params,
+                                                                 const QVector<int>& sensIds,
+                                                                 const QVector<double>& providedTime,
+                                                                 bool highPrecision,
+                                                                 const CancellationToken& cancel)
+{
+    ModelSensitivityData out;
+    out.time = providedTime;
+    if (out.time.isEmpty()) {
+        out.time = ModelManager::generateLogTimeSteps(100, -3.0, 3.0);
+    }
+
+    int nSens = std::min((int)sensIds.size(), (int)DualNumber::MaxDerivs);
+    std::array<int, Param_Count> slot;
+    slot.fill(-1);
+    for (int j = 0; j < nSens; ++j) {
+        out.paramNames.append(ParameterSchema::nameOf(sensIds[j]));
+        if (sensIds[j] >= 0 && sensIds[j] < Param_Count && slot[sensIds[j]] < 0) slot[sensIds[j]] = j;
+    }
+
+    // 参数取值: 若在求导列表中则作为自变量 (导数种子)，否则作为常数
+    auto seed = [&](int id) -> DualNumber {
+        return (slot[id] >= 0) ? DualNumber::variable(params[id], slot[id], nSens) : DualNumber(params[id]);
+    };
+
+    DualNumber phi = seed(Param_phi);
+    DualNumber mu = seed(Param_mu);
+    DualNumber B = seed(Param_B);
+    DualNumber Ct = seed(Param_Ct);
+    DualNumber q = seed(Param_q);
+    DualNumber h = seed(Param_h);
+    DualNumber kf = seed(Param_kf);
+    DualNumber L = seed(Param_L);
+
+    KernelParams<DualNumber> kp = makeKernelParams<DualNumber>(params, seed);
+    // 若对井长或缝长求导 (且未直接对 LfD 求导)，无因次缝长按 LfD = Lf / L 传播偏导
+    if ((slot[Param_L] >= 0 || slot[Param_Lf] >= 0) && slot[Param_LfD] < 0 && params[Param_L] > 1e-9) {
+        kp.LfD = seed(Param_Lf) / L;
+    }
+    DualNumber gamaD = seed(Param_gamaD);
+
+    int N = stehfestN(params, highPrecision);
+    const bool extended = usesExtendedPrecision(N);
+    QVector<double> V = stehfestWeights(N);
+    QVector<DoubleDouble> VX = extended ? stehfestWeightsExtended(N) : QVector<DoubleDouble>();
+    double ln2 = log(2.0);
+
+    DualNumber timeScale = 14.4 * kf / (phi * mu * Ct * L * L);
+    DualNumber factor = 1.842e-3 * q * mu * B / (kf * h);
+
+    int numPoints = out.time.size();
+    QVector<double> tDValues(numPoints);
+    out.pressure.resize(numPoints);
+    out.dPressure = QVector<QVector<double>>(nSens, QVector<double>(numPoints, 0.0));
+
+    for (int k = 0; k < numPoints; ++k) {
+        if (cancel.isCancelled()) return ModelSensitivityData();
+        DualNumber tD = timeScale * out.time[k];
+        tDValues[k] = tD.v;
+        if (tD.v <= 1e-12) {
+            out.pressure[k] = 0.0;
+            continue;
+        }
+
+        // Stehfest 反演: pD = ln2/tD·ΣV·p̄(z)
+        DualNumber sumP;
+        ExtendedDualSum accP;
+        for (int m = 1; m <= N; ++m) {
+            DualNumber z = (m * ln2) / tD;
+            DualNumber pf = flaplaceKernel(z, kp, type);
+            if (std::isnan(pf.v) || std::isinf(pf.v)) pf = DualNumber(0.0);
+            if (extended) accP.add(VX[m - 1], pf);
+            else sumP += V[m - 1] * pf;
+        }
+        if (extended) sumP = accP.value();
+        DualNumber pD = sumP * ln2 / tD;
+
+        // 考虑压敏效应 (gamaD)
+        if (std::abs(gamaD.v) > 1e-9) {
+            DualNumber arg = 1.0 - gamaD * pD;
+            if (arg.v > 1e-12) {
+                pD = -log(arg) / gamaD;
+            }
+        }
+
+        DualNumber P = factor * pD;
+        out.pressure[k] = P.v;
+        for (int j = 0; j < nSens; ++j) out.dPressure[j][k] = P.deriv(j);
+    }
+
+    // 计算导数 (Bourdet 导数) 及其偏导
+    if (numPoints > 2) {
+        out.derivative = PressureDerivativeCalculator::calculateBourdetDerivative(tDValues, out.pressure, 0.1);
+        out.dDerivative = PressureDerivativeCalculator::calculateBourdetSensitivity(tDValues, out.pressure, out.dPressure, 0.1);
+    } else {
+        out.derivative = QVector<double>(numPoints, 0.0);
+        out.dDerivative = QVector<QVector<double>>(nSens, QVector<double>(numPoints, 0.0));
+    }
+    return out;
+}
+
+bool ModelSolver01_06::isDifferentiableParam(const QString& name)
+{
+    static const QStringList names = {
+        "kf", "km", "L", "Lf", "LfD", "rmD", "reD", "omega1", "omega2", "lambda1",
+        "cD", "S", "gamaD", "phi", "mu", "B", "Ct", "q", "h"
+    };
+    return names.contains(name);
+}
+
+bool ModelSolver01_06::isDifferentiableParam(int id)
+{
+    return id >= 0 && id < Param_Count && id != Param_nf && id != Param_N;
+}
+
 // 通用的 Stehfest 数值反演计算流程
-void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD,
-                                           const QMap<QString, double>& params,
-                                           std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
+bool ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD,
+                                           const ParamVector& params,
+                                           ModelType type,
                                            QVector<double>& outPD,
                                            QVector<double>& outDeriv,
-                                           bool highPrecision)
+                                           bool highPrecision,
+                                           const CancellationToken& cancel)
 {
     int numPoints = tD.size();
     outPD.resize(numPoints);
     outDeriv.resize(numPoints);
 
     // 确定 Stehfest 参数 N
-    int N_param = (int)params.value("N", 4);
-    int N = highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4; // N 必须为偶数
+    int N = stehfestN(params, highPrecision);
+    const bool extended = usesExtendedPrecision(N);
+    QVector<double> V = stehfestWeights(N);
+    QVector<DoubleDouble> VX = extended ? stehfestWeightsExtended(N) : QVector<DoubleDouble>();
     double ln2 = log(2.0);
 
-    double gamaD = params.value("gamaD", 0.0);
+    double gamaD = params[Param_gamaD];
+
+    // 核函数参数 (含裂缝位置分布) 只组装一次
+    KernelParams<double> kp = makeKernelParams<double>(params, [&params](int id) { return params[id]; });
 
     // 对每个时间点进行数值反演
     for (int k = 0; k < numPoints; ++k) {
+        if (cancel.isCancelled()) {
+            outPD.clear();
+            outDeriv.clear();
+            return false;
+        }
         double t = tD[k];
         if (t <= 1e-12) { outPD[k] = 0; continue; }
 
         double pd_val = 0.0;
+        DoubleDouble pd_ext;
         for (int m = 1; m <= N; ++m) {
             double z = m * ln2 / t; // 拉普拉斯变量 s (此处用 z 表示)
 
             // 调用拉普拉斯空间解函数
-            double pf = laplaceFunc(z, params);
+            double pf = flaplaceKernel(z, kp, type);
 
             if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
+            if (extended) pd_ext += VX[m - 1] * pf;
+            else pd_val += V[m - 1] * pf;
         }
+        if (extended) pd_val = pd_ext.toDouble();
         outPD[k] = pd_val * ln2 / t;
 
         // 考虑压敏效应 (gamaD)
@@ -126,42 +341,49 @@ void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD,
     } else {
         outDeriv.fill(0.0);
     }
+    return true;
 }
 
-// 拉普拉斯空间下的复合模型函数实现
-double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double>& p, ModelType type) {
-    // 提取模型参数
-    double kf = p.value("kf");
-    double km = p.value("km");
-    double LfD = p.value("LfD");
-    double rmD = p.value("rmD");
-    double reD = p.value("reD", 0.0);
-    double omga1 = p.value("omega1");
-    double omga2 = p.value("omega2");
-    double remda1 = p.value("lambda1");
-    int nf = (int)p.value("nf", 4);
-    if(nf < 1) nf = 1;
-
-    double M12 = kf / km; // 渗透率比
+// 从参数向量组装核函数参数，seed(id) 决定各参数的标量值 (常数或求导自变量)
+template<typename T, typename SeedFunc>
+ModelSolver01_06::KernelParams<T> ModelSolver01_06::makeKernelParams(const ParamVector& p, SeedFunc seed)
+{
+    KernelParams<T> kp;
+    T kf = seed(Param_kf);
+    T km = seed(Param_km);
+    kp.M12 = kf / km; // 渗透率比
+    kp.LfD = seed(Param_LfD);
+    kp.rmD = seed(Param_rmD);
+    kp.reD = seed(Param_reD);
+    kp.omega1 = seed(Param_omega1);
+    kp.omega2 = seed(Param_omega2);
+    kp.lambda1 = seed(Param_lambda1);
+    kp.cD = seed(Param_cD);
+    kp.S = seed(Param_S);
+    kp.nf = (int)p[Param_nf];
+    if(kp.nf < 1) kp.nf = 1;
 
     // 计算裂缝位置分布
-    QVector<double> xwD;
-    if (nf == 1) {
-        xwD.append(0.0);
+    if (kp.nf == 1) {
+        kp.xwD.append(0.0);
     } else {
         double start = -0.9;
         double end = 0.9;
-        double step = (end - start) / (nf - 1);
-        for(int i=0; i<nf; ++i) xwD.append(start + i * step);
+        double step = (end - start) / (kp.nf - 1);
+        for(int i=0; i<kp.nf; ++i) kp.xwD.append(start + i * step);
     }
+    return kp;
+}
 
+template<typename T>
+T ModelSolver01_06::flaplaceKernel(const T& z, const KernelParams<T>& kp, ModelType type) {
     // 双重介质参数处理
-    double temp = omga2;
-    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
-    double fs2 = M12 * temp;
+    T temp = kp.omega2;
+    T fs1 = kp.omega1 + kp.lambda1 * temp / (kp.lambda1 + z * temp);
+    T fs2 = kp.M12 * temp;
 
     // 计算未考虑井储和表皮的压力
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, type);
+    T pf = PWD_composite(z, fs1, fs2, kp.M12, kp.LfD, kp.rmD, kp.reD, kp.nf, kp.xwD, type);
 
     // 考虑井筒储集系数(C)和表皮系数(S)
     // 仅在模型 1, 3, 5 (变井储) 或其他需要的情况下应用
@@ -171,11 +393,9 @@ double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double
     bool hasStorage = (type == Model_1 || type == Model_3 || type == Model_5);
 
     if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
+        if (scalarValue(kp.cD) > 1e-12 || std::abs(scalarValue(kp.S)) > 1e-12) {
             // Duhamel 原理叠加井储和表皮
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
+            pf = (z * pf + kp.S) / (z + kp.cD * z * z * (z * pf + kp.S));
         }
     }
 
@@ -183,24 +403,27 @@ double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double
 }
 
 // 核心：计算无限导流裂缝在复合储层中的拉普拉斯解
-double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double M12,
-                                       double LfD, double rmD, double reD, int nf,
-                                       const QVector<double>& xwD, ModelType type) {
-    using namespace boost::math;
+template<typename T>
+T ModelSolver01_06::PWD_composite(const T& z, const T& fs1, const T& fs2, const T& M12,
+                                  const T& LfD, const T& rmD, const T& reD, int nf,
+                                  const QVector<double>& xwD, ModelType type) {
+    using std::sqrt;
+    using std::exp;
+    using std::abs;
     QVector<double> ywD(nf, 0.0); // 裂缝y坐标假设为0
 
-    double gama1 = sqrt(z * fs1);
-    double gama2 = sqrt(z * fs2);
-    double arg_g2_rm = gama2 * rmD;
-    double arg_g1_rm = gama1 * rmD;
+    T gama1 = sqrt(z * fs1);
+    T gama2 = sqrt(z * fs2);
+    T arg_g2_rm = gama2 * rmD;
+    T arg_g1_rm = gama1 * rmD;
 
     // 计算贝塞尔函数值
-    double k0_g2 = cyl_bessel_k(0, arg_g2_rm);
-    double k1_g2 = cyl_bessel_k(1, arg_g2_rm);
-    double k1_g1 = cyl_bessel_k(1, arg_g1_rm);
+    T k0_g2 = bessel_k(0, arg_g2_rm);
+    T k1_g2 = bessel_k(1, arg_g2_rm);
+    T k1_g1 = bessel_k(1, arg_g1_rm);
 
-    double term_mAB_i0 = 0.0;
-    double term_mAB_i1 = 0.0;
+    T term_mAB_i0 = 0.0;
+    T term_mAB_i1 = 0.0;
 
     bool isInfinite = (type == Model_1 || type == Model_2);
     bool isClosed = (type == Model_3 || type == Model_4);
@@ -208,79 +431,129 @@ double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double
 
     // 处理外边界条件
     if (!isInfinite) {
-        double arg_re = gama2 * reD;
-        double i1_re_s = scaled_besseli(1, arg_re);
-        double i0_re_s = scaled_besseli(0, arg_re);
-        double k1_re = cyl_bessel_k(1, arg_re);
-        double k0_re = cyl_bessel_k(0, arg_re);
-        double i0_g2_s = scaled_besseli(0, arg_g2_rm);
-        double i1_g2_s = scaled_besseli(1, arg_g2_rm);
+        T arg_re = gama2 * reD;
+        T i1_re_s = scaled_besseli(1, arg_re);
+        T i0_re_s = scaled_besseli(0, arg_re);
+        T k1_re = bessel_k(1, arg_re);
+        T k0_re = bessel_k(0, arg_re);
+        T i0_g2_s = scaled_besseli(0, arg_g2_rm);
+        T i1_g2_s = scaled_besseli(1, arg_g2_rm);
 
         if (isClosed) {
             // 封闭边界
-            if (i1_re_s > 1e-100) {
-                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+            if (scalarValue(i1_re_s) > 1e-100) {
+                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * exp(arg_g2_rm - arg_re);
+                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * exp(arg_g2_rm - arg_re);
             }
         } else if (isConstP) {
             // 定压边界
-            if (i0_re_s > 1e-100) {
-                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+            if (scalarValue(i0_re_s) > 1e-100) {
+                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * exp(arg_g2_rm - arg_re);
+                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * exp(arg_g2_rm - arg_re);
             }
         }
     }
 
-    double term1 = term_mAB_i0 + k0_g2;
-    double term2 = term_mAB_i1 - k1_g2;
+    T term1 = term_mAB_i0 + k0_g2;
+    T term2 = term_mAB_i1 - k1_g2;
 
-    double Acup = M12 * gama1 * k1_g1 * term1 + gama2 * cyl_bessel_k(0, arg_g1_rm) * term2;
+    T Acup = M12 * gama1 * k1_g1 * term1 + gama2 * bessel_k(0, arg_g1_rm) * term2;
 
-    double i1_g1_s = scaled_besseli(1, arg_g1_rm);
-    double i0_g1_s = scaled_besseli(0, arg_g1_rm);
+    T i1_g1_s = scaled_besseli(1, arg_g1_rm);
+    T i0_g1_s = scaled_besseli(0, arg_g1_rm);
 
-    double Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+    T Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
 
-    if (std::abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
+    if (std::abs(scalarValue(Acdown_scaled)) < 1e-100) Acdown_scaled = 1e-100;
 
-    double Ac_prefactor = Acup / Acdown_scaled;
+    T Ac_prefactor = Acup / Acdown_scaled;
 
-    // 构建线性方程组求解裂缝流量分布
+    // 构建线性方程组求解裂缝流量分布 (行主序存储)
     int size = nf + 1;
-    Eigen::MatrixXd A_mat(size, size);
-    Eigen::VectorXd b_vec(size);
-    b_vec.setZero();
-    b_vec(nf) = 1.0; // 定压条件
+    QVector<T> A_mat(size * size, T(0.0));
 
     for (int i = 0; i < nf; ++i) {
         for (int j = 0; j < nf; ++j) {
             // 定义积分核函数
-            auto integrand = [&](double a) -> double {
-                double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
-                double arg_dist = gama1 * dist;
-                if (arg_dist < 1e-10) arg_dist = 1e-10;
-
-                double term2_val = 0.0;
-                double exponent = arg_dist - arg_g1_rm;
-                if (exponent > -700.0) {
-                    term2_val = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
+            auto integrand = [&](const T& a) -> T {
+                T dist = abs((xwD[i] - xwD[j]) - a);
+                dist = sqrt(dist * dist + (ywD[i] - ywD[j]) * (ywD[i] - ywD[j]));
+                T arg_dist = gama1 * dist;
+                if (scalarValue(arg_dist) < 1e-10) arg_dist = 1e-10;
+
+                T term2_val = 0.0;
+                T exponent = arg_dist - arg_g1_rm;
+                if (scalarValue(exponent) > -700.0) {
+                    term2_val = Ac_prefactor * scaled_besseli(0, arg_dist) * exp(exponent);
                 }
-                return cyl_bessel_k(0, arg_dist) + term2_val;
+                return bessel_k(0, arg_dist) + term2_val;
             };
             // 积分计算矩阵元素
-            double val = adaptiveGauss(integrand, -LfD, LfD, 1e-5, 0, 10);
-            A_mat(i, j) = z * val / (M12 * z * 2 * LfD);
+            T val = adaptiveGauss(integrand, T(-LfD), LfD, 1e-5, 0, 10);
+            A_mat[i * size + j] = z * val / (M12 * z * 2 * LfD);
         }
     }
     // 添加定流量约束
     for (int i = 0; i < nf; ++i) {
-        A_mat(i, nf) = -1.0;
-        A_mat(nf, i) = z;
+        A_mat[i * size + nf] = -1.0;
+        A_mat[nf * size + i] = z;
     }
-    A_mat(nf, nf) = 0.0;
+    A_mat[nf * size + nf] = 0.0;
 
     // 求解方程组，返回井底压力
-    return A_mat.fullPivLu().solve(b_vec)(nf);
+    return solveBorderedSystem(A_mat, size);
+}
+
+double ModelSolver01_06::solveBorderedSystem(const QVector<double>& A, int size)
+{
+    Eigen::MatrixXd A_mat(size, size);
+    for (int i = 0; i < size; ++i)
+        for (int j = 0; j < size; ++j) A_mat(i, j) = A[i * size + j];
+    Eigen::VectorXd b_vec = Eigen::VectorXd::Zero(size);
+    b_vec(size - 1) = 1.0; // 定压条件
+    return A_mat.fullPivLu().solve(b_vec)(size - 1);
+}
+
+// 对偶数版本: 对值部分做一次 LU 分解，偏导由 A·dx = -dA·x 复用同一分解求得
+DualNumber ModelSolver01_06::solveBorderedSystem(const QVector<DualNumber>& A, int size)
+{
+    Eigen::MatrixXd A_val(size, size);
+    int nDeriv = 0;
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            const DualNumber& a = A[i * size + j];
+            A_val(i, j) = a.v;
+            nDeriv = std::max(nDeriv, a.n);
+        }
+    }
+    Eigen::VectorXd b_vec = Eigen::VectorXd::Zero(size);
+    b_vec(size - 1) = 1.0;
+
+    Eigen::FullPivLU<Eigen::MatrixXd> lu(A_val);
+    Eigen::VectorXd x = lu.solve(b_vec);
+
+    DualNumber result(x(size - 1));
+    result.n = nDeriv;
+    Eigen::MatrixXd dA(size, size);
+    for (int k = 0; k < nDeriv; ++k) {
+        for (int i = 0; i < size; ++i)
+            for (int j = 0; j < size; ++j) dA(i, j) = A[i * size + j].deriv(k);
+        Eigen::VectorXd dx = lu.solve(-(dA * x));
+        result.d[k] = dx(size - 1);
+    }
+    return result;
+}
+
+double ModelSolver01_06::bessel_k(int v, double x) {
+    return boost::math::cyl_bessel_k(v, x);
+}
+
+// K0' = -K1, K1' = -K0 - K1/x
+DualNumber ModelSolver01_06::bessel_k(int v, const DualNumber& x) {
+    double k0 = boost::math::cyl_bessel_k(0, x.v);
+    double k1 = boost::math::cyl_bessel_k(1, x.v);
+    if (v == 0) return DualNumber::chain(x, k0, -k1);
+    return DualNumber::chain(x, k1, -k0 - k1 / x.v);
 }
 
 // 标度 Bessel I 函数: e^{-x} * I_v(x)
@@ -290,29 +563,61 @@ double ModelSolver01_06::scaled_besseli(int v, double x) {
     return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
 }
 
+// (e^{-x}I0)' = e^{-x}(I1 - I0), (e^{-x}I1)' = e^{-x}(I0 - I1/x - I1)
+DualNumber ModelSolver01_06::scaled_besseli(int v, const DualNumber& x) {
+    double i0 = scaled_besseli(0, x.v);
+    double i1 = scaled_besseli(1, x.v);
+    if (v == 0) return DualNumber::chain(x, i0, i1 - i0);
+    return DualNumber::chain(x, i1, i0 - i1 / x.v - i1);
+}
+
 // 高斯-勒让德积分 (15点)
-double ModelSolver01_06::gauss15(std::function<double(double)> f, double a, double b) {
+template<typename T, typename F>
+T ModelSolver01_06::gauss15(const F& f, const T& a, const T& b) {
     static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
     static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
-    double h = 0.5 * (b - a);
-    double c = 0.5 * (a + b);
-    double s = W[0] * f(c);
+    T h = 0.5 * (b - a);
+    T c = 0.5 * (a + b);
+    T s = W[0] * f(c);
     for (int i = 1; i < 8; ++i) {
-        double dx = h * X[i];
+        T dx = h * X[i];
         s += W[i] * (f(c - dx) + f(c + dx));
     }
     return s * h;
 }
 
-// 自适应高斯积分
-double ModelSolver01_06::adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth) {
-    double c = (a + b) / 2.0;
-    double v1 = gauss15(f, a, b);
-    double v2 = gauss15(f, a, c) + gauss15(f, c, b);
-    if (depth >= maxDepth || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
+// 自适应高斯积分 (细分判据只依赖函数值部分)
+template<typename T, typename F>
+T ModelSolver01_06::adaptiveGauss(const F& f, const T& a, const T& b, double eps, int depth, int maxDepth) {
+    T c = (a + b) / 2.0;
+    T v1 = gauss15(f, a, b);
+    T v2 = gauss15(f, a, c) + gauss15(f, c, b);
+    if (depth >= maxDepth || std::abs(scalarValue(v1 - v2)) < 1e-10 * std::abs(scalarValue(v2)) + eps) return v2;
     return adaptiveGauss(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss(f, c, b, eps/2, depth+1, maxDepth);
 }
 
+// 确定 Stehfest 参数 N (低精度模式固定为 4，N 必须为偶数)
+int ModelSolver01_06::stehfestN(const ParamVector& params, bool highPrecision) {
+    int N_param = (int)params[Param_N];
+    int N = highPrecision ? N_param : 4;
+    if (N % 2 != 0) N = 4;
+    return N;
+}
+
+// 预先计算全部 Stehfest 权重 V_1..V_N
+QVector<double> ModelSolver01_06::stehfestWeights(int N) {
+    QVector<double> V(N);
+    for (int m = 1; m <= N; ++m) V[m - 1] = stefestCoefficient(m, N);
+    return V;
+}
+
+// 双双精度权重 (N > ExtendedPrecisionN 时使用)
+QVector<DoubleDouble> ModelSolver01_06::stehfestWeightsExtended(int N) {
+    QVector<DoubleDouble> V(N);
+    for (int m = 1; m <= N; ++m) V[m - 1] = stefestCoefficientExtended(m, N);
+    return V;
+}
+
 // Stehfest 算法系数
 double ModelSolver01_06::stefestCoefficient(int i, int N) {
     double s = 0.0;
@@ -326,6 +631,25 @@ double ModelSolver01_06::stefestCoefficient(int i, int N) {
     return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * s;
 }
 
+// 双双精度系数: 各项分子分母均为整数 (N ≤ 24 时有效位不超过 106 位，可精确表示)，只有除法和求和带舍入
+DoubleDouble ModelSolver01_06::stefestCoefficientExtended(int i, int N) {
+    auto fact = [](int n) {
+        DoubleDouble r(1.0);
+        for (int j = 2; j <= n; ++j) r *= double(j);
+        return r;
+    };
+    DoubleDouble s;
+    int k1 = (i + 1) / 2;
+    int k2 = std::min(i, N / 2);
+    for (int k = k1; k <= k2; ++k) {
+        DoubleDouble num = fact(2 * k);
+        for (int j = 0; j < N / 2; ++j) num *= double(k);
+        DoubleDouble den = fact(N / 2 - k) * fact(k) * fact(k - 1) * fact(i - k) * fact(2 * k - i);
+        s += num / den;
+    }
+    return ((i + N / 2) % 2 == 0) ? s : -s;
+}
+
 // 阶乘函数
 double ModelSolver01_06::factorial(int n) {
     if(n<=1) return 1;
@@ -7,41 +7,131 @@
 #define MODELSOLVER01_06_H
 
 #include "modelenums.h"
+#include "dualnumber.h"
+#include "doubledouble.h"
+#include "parameterschema.h"
+#include "cancellationtoken.h"
 #include <QMap>
 #include <QVector>
 #include <QString>
+#include <QStringList>
 #include <tuple>
 #include <functional>
 
 // 类型定义: <时间, 压力, 导数>
 using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
 
+// 参数敏感度计算结果: 理论曲线及其对各参数的解析偏导
+struct ModelSensitivityData {
+    QVector<double> time;                   // 时间
+    QVector<double> pressure;               // 压差
+    QVector<double> derivative;             // 压力导数 (Bourdet 导数，与理论曲线相同)
+    QStringList paramNames;                 // 求导参数名，与下面两个数组的外层下标一一对应
+    QVector<QVector<double>> dPressure;     // dPressure[k][i]   = ∂P(t_i) / ∂θ_k
+    QVector<QVector<double>> dDerivative;   // dDerivative[k][i] = ∂P'(t_i) / ∂θ_k
+};
+
+// 以下各计算接口均可传入取消令牌: 每个时间点计算前检查一次，
+// 一旦取消立即返回空结果 (不返回部分曲线)，调用方应以令牌状态判断结果是否有效
 class ModelSolver01_06
 {
 public:
     static ModelCurveData calculateTheoreticalCurve(ModelType type,
                                                     const QMap<QString, double>& params,
                                                     const QVector<double>& providedTime = QVector<double>(),
-                                                    bool highPrecision = true);
+                                                    bool highPrecision = true,
+                                                    const CancellationToken& cancel = CancellationToken());
+
+    // 稠密参数向量版本 (拟合迭代使用，参数须已应用 ParameterSchema::applyDependencies)
+    static ModelCurveData calculateTheoreticalCurve(ModelType type,
+                                                    const ParamVector& params,
+                                                    const QVector<double>& providedTime,
+                                                    bool highPrecision,
+                                                    const CancellationToken& cancel = CancellationToken());
+
+    // 计算无因次理论曲线: 输入无因次时间 tD，返回 <tD, pD, pD 的 Bourdet 导数>
+    // 不做量纲换算，供类型曲线图版生成等离线任务使用
+    static ModelCurveData calculateDimensionlessCurve(ModelType type,
+                                                      const QMap<QString, double>& params,
+                                                      const QVector<double>& tD,
+                                                      bool highPrecision = true,
+                                                      const CancellationToken& cancel = CancellationToken());
+
+    // 一次前向自动微分计算: 同时返回压差、Bourdet 导数以及二者对 sensNames 中各参数的偏导
+    // 不可微参数 (如裂缝条数 nf) 的偏导恒为 0，由调用方自行处理
+    static ModelSensitivityData calculateCurveSensitivity(ModelType type,
+                                                          const QMap<QString, double>& params,
+                                                          const QStringList& sensNames,
+                                                          const QVector<double>& providedTime = QVector<double>(),
+                                                          bool highPrecision = true,
+                                                          const CancellationToken& cancel = CancellationToken());
+
+    // 稠密参数向量版本: sensIds 为求导参数的 ParamId，输出的 paramNames 与之对应
+    static ModelSensitivityData calculateCurveSensitivity(ModelType type,
+                                                          const ParamVector& params,
+                                                          const QVector<int>& sensIds,
+                                                          const QVector<double>& providedTime,
+                                                          bool highPrecision,
+                                                          const CancellationToken& cancel = CancellationToken());
+
+    // 参数是否可由 calculateCurveSensitivity 解析求导
+    static bool isDifferentiableParam(const QString& name);
+    static bool isDifferentiableParam(int id);
+
+    // 无因次压力到实际压差的换算系数 1.842e-3·q·μ·B/(kf·h)
+    static double pressureScale(const ParamVector& params);
+
+    // Stehfest 项数超过此值时，权重与加权求和改用双双精度 (拉普拉斯核函数仍为双精度)
+    static constexpr int ExtendedPrecisionN = 14;
+    static bool usesExtendedPrecision(int N) { return N > ExtendedPrecisionN; }
+
+    // Stehfest 权重 V_1..V_N: 双精度版本由阶乘浮点运算得到，双双精度版本的阶乘与幂在 N ≤ 24 内精确
+    static QVector<double> stehfestWeights(int N);
+    static QVector<DoubleDouble> stehfestWeightsExtended(int N);
 
 private:
-    static void calculatePDandDeriv(const QVector<double>& tD,
-                                    const QMap<QString, double>& params,
-                                    std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
+    // 拉普拉斯核函数所需的参数 (按标量类型模板化，double 或 DualNumber)
+    template<typename T> struct KernelParams;
+
+    // seed(id) 给出下标为 id 的参数的标量值 (常数或求导自变量)
+    template<typename T, typename SeedFunc>
+    static KernelParams<T> makeKernelParams(const ParamVector& p, SeedFunc seed);
+
+    // Stehfest 反演 (核函数参数在进入时组装一次，反演循环中不再查表)
+    // 被取消时清空输出并返回 false
+    static bool calculatePDandDeriv(const QVector<double>& tD,
+                                    const ParamVector& params,
+                                    ModelType type,
                                     QVector<double>& outPD,
                                     QVector<double>& outDeriv,
-                                    bool highPrecision);
+                                    bool highPrecision,
+                                    const CancellationToken& cancel);
+
+    template<typename T>
+    static T flaplaceKernel(const T& z, const KernelParams<T>& kp, ModelType type);
 
-    static double flaplace_composite(double z, const QMap<QString, double>& p, ModelType type);
+    template<typename T>
+    static T PWD_composite(const T& z, const T& fs1, const T& fs2, const T& M12,
+                           const T& LfD, const T& rmD, const T& reD, int nf,
+                           const QVector<double>& xwD, ModelType type);
 
-    static double PWD_composite(double z, double fs1, double fs2, double M12,
-                                double LfD, double rmD, double reD, int nf,
-                                const QVector<double>& xwD, ModelType type);
+    // 求解裂缝流量分布的加边线性方程组，返回井底压力分量
+    static double solveBorderedSystem(const QVector<double>& A, int size);
+    static DualNumber solveBorderedSystem(const QVector<DualNumber>& A, int size);
 
+    static double bessel_k(int v, double x);
+    static DualNumber bessel_k(int v, const DualNumber& x);
     static double scaled_besseli(int v, double x);
-    static double gauss15(std::function<double(double)> f, double a, double b);
-    static double adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth);
+    static DualNumber scaled_besseli(int v, const DualNumber& x);
+
+    template<typename T, typename F>
+    static T gauss15(const F& f, const T& a, const T& b);
+    template<typename T, typename F>
+    static T adaptiveGauss(const F& f, const T& a, const T& b, double eps, int depth, int maxDepth);
+
+    static int stehfestN(const ParamVector& params, bool highPrecision);
     static double stefestCoefficient(int i, int N);
+    static DoubleDouble stefestCoefficientExtended(int i, int N);
     static double factorial(int n);
 };
 
@@ -5,8 +5,9 @@
 #include <QClipboard>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QScreen>
 
-MouseZoom::MouseZoom(QWidget *parent) : QCustomPlot(parent)
+MouseZoom::MouseZoom(QWidget *parent) : QCustomPlot(parent), m_fullReplotPending(false)
 {
     // 允许拖拽、缩放、选择
     setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectPlottables | QCP::iSelectLegend);
@@ -18,6 +19,92 @@ MouseZoom::MouseZoom(QWidget *parent) : QCustomPlot(parent)
     // 启用右键菜单策略并连接信号
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QCustomPlot::customContextMenuRequested, this, &MouseZoom::onChartContextMenuRequest);
+    connect(this, &QCustomPlot::beforeReplot, this, &MouseZoom::updateLodGraphs);
+
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &MouseZoom::onFrameTimeout);
+}
+
+void MouseZoom::requestReplot(QCPLayer* layer)
+{
+    if (!layer || layer->mode() != QCPLayer::lmBuffered) {
+        m_fullReplotPending = true;
+    } else if (!m_pendingLayers.contains(layer)) {
+        m_pendingLayers.append(layer);
+    }
+    if (m_frameTimer.isActive()) return;
+
+    // 一帧的时长由所在屏幕的刷新率决定
+    double hz = screen() ? screen()->refreshRate() : 60.0;
+    m_frameTimer.start(qMax(1, int(1000.0 / qMax(1.0, hz))));
+}
+
+void MouseZoom::onFrameTimeout()
+{
+    bool full = m_fullReplotPending;
+    QList<QPointer<QCPLayer>> layers = m_pendingLayers;
+    m_fullReplotPending = false;
+    m_pendingLayers.clear();
+
+    if (full) {
+        replot();
+        return;
+    }
+    for (const QPointer<QCPLayer>& layer : layers) {
+        if (layer) layer->replot();
+    }
+}
+
+void MouseZoom::setLodData(QCPGraph* graph, const PlotSeries& series)
+{
+    if (!graph) return;
+    for (int i = m_lodGraphs.size() - 1; i >= 0; --i) {
+        if (m_lodGraphs[i].graph == graph) m_lodGraphs.remove(i);
+    }
+    if (series.rowCount() <= ScatterLod::MinPoints) {
+        PlotDataSource::setGraphData(graph, series);
+        return;
+    }
+
+    LodGraph entry;
+    entry.graph = graph;
+    entry.lod = QSharedPointer<ScatterLod>::create(series.x(), series.y(),
+                                                   graph->keyAxis()->scaleType() == QCPAxis::stLogarithmic,
+                                                   graph->valueAxis()->scaleType() == QCPAxis::stLogarithmic,
+                                                   series.minValue());
+    entry.shown = entry.lod->select(graph->keyAxis()->range(), graph->valueAxis()->range(),
+                                    graph->keyAxis()->axisRect()->width(), graph->keyAxis()->axisRect()->height());
+    entry.shownSize = entry.shown->size();
+    graph->setData(entry.shown);
+    m_lodGraphs.append(entry);
+}
+
+void MouseZoom::updateLodGraphs()
+{
+    for (int i = m_lodGraphs.size() - 1; i >= 0; --i) {
+        LodGraph& e = m_lodGraphs[i];
+        // 曲线已删除，或数据已被其他代码替换/修改: 不再管理
+        if (!e.graph || e.graph->data() != e.shown || e.shown->size() != e.shownSize) {
+            m_lodGraphs.remove(i);
+            continue;
+        }
+        QCPAxis* keyAxis = e.graph->keyAxis();
+        QCPAxis* valueAxis = e.graph->valueAxis();
+        bool logX = keyAxis->scaleType() == QCPAxis::stLogarithmic;
+        bool logY = valueAxis->scaleType() == QCPAxis::stLogarithmic;
+        if (logX != e.lod->logX() || logY != e.lod->logY())
+            e.lod = QSharedPointer<ScatterLod>::create(e.lod->x(), e.lod->y(), logX, logY, e.lod->minValue());
+
+        QSharedPointer<QCPGraphDataContainer> data = e.lod->select(keyAxis->range(), valueAxis->range(),
+                                                                   keyAxis->axisRect()->width(),
+                                                                   keyAxis->axisRect()->height());
+        if (data != e.shown) {
+            e.shown = data;
+            e.shownSize = data->size();
+            e.graph->setData(data);
+        }
+    }
 }
 
 // [修复] 滚轮事件优化
@@ -2,13 +2,20 @@
 #define MOUSEZOOM_H
 
 #include "qcustomplot.h"
+#include "scatterlod.h"
+#include "plotdatasource.h"
 #include <QTableWidget>
+#include <QPointer>
+#include <QTimer>
 
 /**
  * @brief 增强型绘图控件 (MouseZoom)
  * 继承自 QCustomPlot，提供针对试井分析优化的交互体验。
  * 1. 滚轮缩放：默认全向，按住左键纵向缩放，按住右键横向缩放。
  * 2. 提供通用辅助功能（表格右键菜单 + 绘图区右键菜单）。
+ * 3. 大数据量散点的细节层次显示 (setLodData)：每次重绘前按可见范围切换抽稀层级 (见 ScatterLod)。
+ * 4. 重绘请求合并 (requestReplot)：按屏幕刷新率每帧最多重绘一次；
+ *    只请求了缓冲图层 (lmBuffered) 时只重绘这些图层，不重绘坐标轴、网格与其他曲线。
  */
 class MouseZoom : public QCustomPlot
 {
@@ -19,12 +26,42 @@ public:
     // 静态辅助函数：为外部表格添加通用右键菜单（复制等）
     static void addTableContextMenu(QTableWidget* table);
 
+    // 设置曲线数据: 点数超过 ScatterLod::MinPoints 时建立抽稀金字塔，重绘时按视图显示对应层级；
+    // 之后若其他代码直接修改了该曲线的数据，LOD 自动失效。
+    // 点数较少时直接绑定 series 的共享容器 (PlotDataSource)；抽稀金字塔同样与调用方共享数据列
+    void setLodData(QCPGraph* graph, const PlotSeries& series);
+    void setLodData(QCPGraph* graph, const QVector<double>& x, const QVector<double>& y) {
+        setLodData(graph, PlotSeries(x, y));
+    }
+
+    // 请求在下一显示帧重绘: layer 为空表示完整重绘，否则只重绘该缓冲图层 (同一帧内有完整重绘请求时以完整重绘为准)
+    void requestReplot(QCPLayer* layer = nullptr);
+
 protected:
     void wheelEvent(QWheelEvent *event) override;
 
 private slots:
     // [新增] 处理绘图区域的右键菜单请求
     void onChartContextMenuRequest(const QPoint &pos);
+
+    // 重绘前为各 LOD 曲线选择层级
+    void updateLodGraphs();
+
+    // 执行本帧合并后的重绘请求
+    void onFrameTimeout();
+
+private:
+    struct LodGraph {
+        QPointer<QCPGraph> graph;
+        QSharedPointer<ScatterLod> lod;
+        QSharedPointer<QCPGraphDataContainer> shown;    // 当前交给曲线的数据
+        int shownSize;
+    };
+    QVector<LodGraph> m_lodGraphs;
+
+    QTimer m_frameTimer;
+    bool m_fullReplotPending;
+    QList<QPointer<QCPLayer>> m_pendingLayers;
 };
 
 #endif // MOUSEZOOM_H
@@ -0,0 +1,228 @@
+/*
+ * numericexport.cpp
+ * 文件作用: 数值表快速导出实现文件
+ * 功能描述:
+ * 1. 每块按上界一次性分配缓冲区，逐值 std::to_chars 直接写入，不经 QString/QTextStream 转换。
+ * 2. 块分批提交到专用线程池: 写入当前批次的同时格式化下一批，最多两批在途。
+ * 3. 大块直接交给 QSaveFile 写入 (超过设备缓冲区大小的写入不再经过缓冲区拷贝)。
+ */
+
+#include "numericexport.h"
+
+#include <QSaveFile>
+#include <QStringList>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QtEndian>
+#include <QtConcurrent>
+#include <charconv>
+#include <functional>
+
+namespace {
+// 每块格式化结果的目标大小 (字节)
+const qint64 ChunkBytes = 1 << 20;
+// 最短往返表示的最大字符数 (如 "-2.2250738585072014e-308")
+const int MaxShortestChars = 24;
+
+// 每块行数: 使每块结果约为 ChunkBytes
+qint64 chunkRowsFor(int columnCount, int bytesPerValue)
+{
+    return qMax<qint64>(1, ChunkBytes / (qint64(qMax(1, columnCount)) * bytesPerValue));
+}
+
+// 文本格式每个值的字符数上界 (含分隔符): 最短表示 24；科学计数法为 "-d." + 小数位 + "e-308"
+int textBytesPerValue(int precision)
+{
+    return (precision < 0 ? MaxShortestChars : precision + 8) + 1;
+}
+
+inline char* putDouble(char* first, char* last, double value, int precision)
+{
+    const std::to_chars_result r = precision < 0
+        ? std::to_chars(first, last, value)
+        : std::to_chars(first, last, value, std::chars_format::scientific, precision);
+    return r.ptr;
+}
+
+// 格式化 [begin, end) 行
+QByteArray formatChunk(const QVector<NumericExport::Column>& columns, qint64 begin, qint64 end,
+                       char separator, int precision)
+{
+    const int nc = columns.size();
+    QByteArray buffer;
+    buffer.resize(int((end - begin) * nc * textBytesPerValue(precision)));
+    char* p = buffer.data();
+    char* last = p + buffer.size();
+    for (qint64 r = begin; r < end; ++r) {
+        for (int j = 0; j < nc; ++j) {
+            if (j > 0) *p++ = separator;
+            p = putDouble(p, last, columns[j].data[r], precision);
+        }
+        *p++ = '\n';
+    }
+    buffer.resize(int(p - buffer.data()));
+    return buffer;
+}
+
+QByteArray binaryChunk(const QVector<NumericExport::Column>& columns, qint64 begin, qint64 end)
+{
+    const int nc = columns.size();
+    QByteArray buffer;
+    buffer.resize(int((end - begin) * nc * qint64(sizeof(double))));
+    char* p = buffer.data();
+    for (qint64 r = begin; r < end; ++r) {
+        for (int j = 0; j < nc; ++j) {
+            qToLittleEndian<double>(columns[j].data[r], p);
+            p += sizeof(double);
+        }
+    }
+    return buffer;
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    out.append(bytes, int(sizeof(T)));
+}
+
+QByteArray binaryHeader(const QVector<NumericExport::Column>& columns, qint64 rows)
+{
+    QByteArray header("WTNT");
+    appendLittleEndian<quint32>(header, 1);
+    appendLittleEndian<quint32>(header, quint32(columns.size()));
+    appendLittleEndian<quint64>(header, quint64(rows));
+    for (const NumericExport::Column& c : columns) {
+        const QByteArray name = c.name.toUtf8();
+        appendLittleEndian<quint32>(header, quint32(name.size()));
+        header.append(name);
+    }
+    return header;
+}
+
+QByteArray textHeader(const QVector<NumericExport::Column>& columns, char separator)
+{
+    QStringList names;
+    for (const NumericExport::Column& c : columns) {
+        QString name = c.name;
+        if (separator == ',') {
+            if (name.contains(',') || name.contains('"') || name.contains('\n')) {
+                name.replace("\"", "\"\"");
+                name = "\"" + name + "\"";
+            }
+        } else {
+            name.replace('\t', ' ').replace('\n', ' ');
+        }
+        names.append(name);
+    }
+    return (names.join(QChar(separator)) + "\n").toUtf8();
+}
+
+// 分块并行生成、按块顺序交给 consume；consume 返回 false 时停止
+bool processChunks(qint64 rows, qint64 chunkRows, const std::function<QByteArray(qint64, qint64)>& produce,
+                   const std::function<bool(const QByteArray&)>& consume)
+{
+    if (rows <= chunkRows) return rows <= 0 || consume(produce(0, rows));
+
+    const qint64 chunkCount = (rows + chunkRows - 1) / chunkRows;
+    const int threads = qMax(1, QThread::idealThreadCount());
+    const qint64 batch = qMax(2, 2 * threads);
+
+    // 调用方可能自身运行在全局线程池中，使用专用线程池避免互相等待
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    auto launch = [&](qint64 first) {
+        QVector<qint64> ids;
+        for (qint64 c = first; c < qMin(first + batch, chunkCount); ++c) ids.append(c);
+        return QtConcurrent::mapped(&pool, ids, [&produce, rows, chunkRows](qint64 c) {
+            return produce(c * chunkRows, qMin(rows, (c + 1) * chunkRows));
+        });
+    };
+
+    QFuture<QByteArray> current = launch(0);
+    for (qint64 first = 0; first < chunkCount; first += batch) {
+        QFuture<QByteArray> next;
+        if (first + batch < chunkCount) next = launch(first + batch);
+        const int n = int(qMin(batch, chunkCount - first));
+        for (int i = 0; i < n; ++i) {
+            if (!consume(current.resultAt(i))) {
+                current.cancel();
+                next.cancel();
+                current.waitForFinished();
+                next.waitForFinished();
+                return false;
+            }
+        }
+        current = next;
+    }
+    return true;
+}
+}
+
+NumericExport::Format NumericExport::formatForFile(const QString& fileName)
+{
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "bin") return Binary;
+    if (suffix == "tsv" || suffix == "txt" || suffix == "xls") return Tsv;
+    return Csv;
+}
+
+QString NumericExport::fileFilter()
+{
+    return "CSV Files (*.csv);;TSV Files (*.tsv *.txt);;Binary Files (*.bin)";
+}
+
+bool NumericExport::write(const QString& fileName, Format format, const QVector<Column>& columns, qint64 rows,
+                          QString* error)
+{
+    for (const Column& c : columns) {
+        if (rows > 0 && !c.data) {
+            if (error) *error = QString("列 %1 没有数据").arg(c.name);
+            return false;
+        }
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    const char separator = (format == Tsv) ? '\t' : ',';
+    const QByteArray header = (format == Binary) ? binaryHeader(columns, rows) : textHeader(columns, separator);
+    bool ok = (file.write(header) == header.size());
+    if (ok && !columns.isEmpty()) {
+        const qint64 chunkRows = chunkRowsFor(columns.size(), format == Binary ? int(sizeof(double)) : textBytesPerValue(-1));
+        ok = processChunks(rows, chunkRows,
+            [&](qint64 begin, qint64 end) {
+                return format == Binary ? binaryChunk(columns, begin, end)
+                                        : formatChunk(columns, begin, end, separator, -1);
+            },
+            [&file](const QByteArray& chunk) { return file.write(chunk) == chunk.size(); });
+    }
+
+    if (!ok || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QByteArray NumericExport::formatRows(const QVector<Column>& columns, qint64 rows, char separator, int precision)
+{
+    QByteArray text;
+    if (columns.isEmpty()) return text;
+    processChunks(rows, chunkRowsFor(columns.size(), textBytesPerValue(precision)),
+        [&](qint64 begin, qint64 end) { return formatChunk(columns, begin, end, separator, precision); },
+        [&text](const QByteArray& chunk) { text.append(chunk); return true; });
+    return text;
+}
+
+QString NumericExport::toString(double value)
+{
+    char buffer[MaxShortestChars + 8];
+    char* end = putDouble(buffer, buffer + sizeof(buffer), value, -1);
+    return QString::fromLatin1(buffer, int(end - buffer));
+}
@@ -0,0 +1,52 @@
+/*
+ * numericexport.h
+ * 文件作用: 数值表快速导出头文件
+ * 功能描述:
+ * 1. 以列指针描述数值表 (各列可来自不同容器，导出时不复制数据)，导出为 CSV、TSV 或二进制文件。
+ * 2. 数值用 std::to_chars 格式化: 默认输出最短往返表示 (读回后与原值逐位相同)，也可指定科学计数法位数。
+ * 3. 行按固定大小分块，在线程池中并行格式化为大块缓冲区，写文件线程按块顺序顺序写入；
+ *    同时在途的块数有界，内存占用与总行数无关，大表导出速度受磁盘带宽限制。
+ * 4. 二进制格式 (小端): 魔数 "WTNT"、quint32 版本 (1)、quint32 列数、quint64 行数，
+ *    每列 quint32 名称字节数 + UTF-8 名称，之后按行连续存放 double (每行 列数 × 8 字节)。
+ */
+
+#ifndef NUMERICEXPORT_H
+#define NUMERICEXPORT_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+class NumericExport
+{
+public:
+    enum Format {
+        Csv,        // 逗号分隔 (列名含逗号或引号时加引号)
+        Tsv,        // 制表符分隔
+        Binary      // 带列名表头的小端 double 表
+    };
+
+    // 一列数据: data 指向至少 rows 个 double，导出期间须保持有效
+    struct Column {
+        QString name;
+        const double* data = nullptr;
+    };
+
+    // 由扩展名确定格式: .bin → Binary，.tsv/.txt/.xls → Tsv，其余 → Csv
+    static Format formatForFile(const QString& fileName);
+    // 文件对话框过滤器 (CSV / TSV / 二进制)
+    static QString fileFilter();
+
+    // 导出 rows 行 (首行为列名)，写入经 QSaveFile 完成，失败时返回 false 并写入 error
+    static bool write(const QString& fileName, Format format, const QVector<Column>& columns, qint64 rows,
+                      QString* error = nullptr);
+
+    // 把 rows 行格式化为文本 (不含列名)，每行以 '\n' 结尾；
+    // precision < 0 为最短往返表示，否则为科学计数法的小数位数 (与 QString::number(v, 'e', precision) 一致)
+    static QByteArray formatRows(const QVector<Column>& columns, qint64 rows, char separator, int precision = -1);
+
+    // 单个数值的最短往返表示
+    static QString toString(double value);
+};
+
+#endif // NUMERICEXPORT_H
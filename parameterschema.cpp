@@ -0,0 +1,155 @@
+/*
+ * parameterschema.cpp
+ * 文件作用: 模型参数描述实现文件
+ * 功能描述:
+ * 1. 参数名表与缺省值表按 ParamId 顺序排列。
+ * 2. 各模型的参数描述在首次使用时构造为静态对象，此后只读。
+ */
+
+#include "parameterschema.h"
+
+#include <cmath>
+
+namespace {
+
+const char* const ParamNames[Param_Count] = {
+    "kf", "km", "L", "Lf", "LfD", "nf", "omega1", "omega2", "lambda1", "rmD",
+    "reD", "cD", "S", "gamaD", "phi", "mu", "B", "Ct", "q", "h", "N"
+};
+
+ParamVector makeDefaults()
+{
+    ParamVector v;
+    v[Param_kf] = 1e-3;
+    v[Param_km] = 1e-4;
+    v[Param_L] = 1000.0;
+    v[Param_Lf] = 0.0;
+    v[Param_LfD] = 0.0;
+    v[Param_nf] = 4.0;
+    v[Param_omega1] = 0.0;
+    v[Param_omega2] = 0.0;
+    v[Param_lambda1] = 0.0;
+    v[Param_rmD] = 0.0;
+    v[Param_reD] = 0.0;
+    v[Param_cD] = 0.0;
+    v[Param_S] = 0.0;
+    v[Param_gamaD] = 0.0;
+    v[Param_phi] = 0.05;
+    v[Param_mu] = 0.5;
+    v[Param_B] = 1.05;
+    v[Param_Ct] = 5e-4;
+    v[Param_q] = 5.0;
+    v[Param_h] = 20.0;
+    v[Param_N] = 4.0;
+    return v;
+}
+
+} // namespace
+
+ParameterSchema::ParameterSchema(ModelType type)
+    : m_type(type)
+{
+    m_active.fill(true);
+    bool hasBoundary = (type == Model_3 || type == Model_4 || type == Model_5 || type == Model_6);
+    bool hasStorage = (type == Model_1 || type == Model_3 || type == Model_5);
+    m_active[Param_reD] = hasBoundary;
+    m_active[Param_cD] = hasStorage;
+    m_active[Param_S] = hasStorage;
+}
+
+const ParameterSchema& ParameterSchema::forModel(ModelType type)
+{
+    static const ParameterSchema schemas[] = {
+        ParameterSchema(Model_1), ParameterSchema(Model_2), ParameterSchema(Model_3),
+        ParameterSchema(Model_4), ParameterSchema(Model_5), ParameterSchema(Model_6)
+    };
+    int idx = (int)type;
+    if (idx < 0 || idx >= 6) idx = 0;
+    return schemas[idx];
+}
+
+int ParameterSchema::indexOf(const QString& name)
+{
+    for (int i = 0; i < Param_Count; ++i) {
+        if (name == QLatin1String(ParamNames[i])) return i;
+    }
+    return -1;
+}
+
+QString ParameterSchema::nameOf(int id)
+{
+    if (id < 0 || id >= Param_Count) return QString();
+    return QString::fromLatin1(ParamNames[id]);
+}
+
+ParameterSchema::Transform ParameterSchema::transform(int id)
+{
+    switch (id) {
+    case Param_S:
+    case Param_nf:
+    case Param_N:
+        return Transform_Linear;
+    default:
+        return Transform_Log10;
+    }
+}
+
+double ParameterSchema::applyStep(int id, double value, double delta)
+{
+    if (usesLog(id, value)) return std::pow(10.0, std::log10(value) + delta);
+    return value + delta;
+}
+
+double ParameterSchema::stepBetween(int id, double from, double to)
+{
+    if (usesLog(id, from) && to > 0.0) return std::log10(to) - std::log10(from);
+    return to - from;
+}
+
+const ParamVector& ParameterSchema::defaults()
+{
+    static const ParamVector v = makeDefaults();
+    return v;
+}
+
+void ParameterSchema::applyDependencies(ParamVector& v)
+{
+    if (v[Param_L] > 1e-9) v[Param_LfD] = v[Param_Lf] / v[Param_L];
+}
+
+ParamVector ParameterSchema::fromMap(const QMap<QString, double>& map)
+{
+    ParamVector v = defaults();
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        int id = indexOf(it.key());
+        if (id >= 0) v[id] = it.value();
+    }
+    if (map.contains("LfD") && !map.contains("Lf")) v[Param_Lf] = v[Param_LfD] * v[Param_L];
+    applyDependencies(v);
+    return v;
+}
+
+void ParameterSchema::setMapValue(QMap<QString, double>& map, const QString& name, double value)
+{
+    map[name] = value;
+    const double L = map.value("L", defaults()[Param_L]);
+    if (name == QLatin1String("LfD") || (name == QLatin1String("L") && !map.contains("Lf") && map.contains("LfD"))) {
+        map["Lf"] = map.value("LfD") * L;
+    } else if (name == QLatin1String("L") || name == QLatin1String("Lf")) {
+        if (L > 1e-9) map["LfD"] = map.value("Lf", defaults()[Param_Lf]) / L;
+    }
+}
+
+void ParameterSchema::applyDependencies(QMap<QString, double>& map)
+{
+    map["LfD"] = fromMap(map)[Param_LfD];
+}
+
+QMap<QString, double> ParameterSchema::toMap(const ParamVector& v) const
+{
+    QMap<QString, double> map;
+    for (int i = 0; i < Param_Count; ++i) {
+        if (m_active[i]) map.insert(nameOf(i), v[i]);
+    }
+    return map;
+}
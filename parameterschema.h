@@ -0,0 +1,113 @@
+/*
+ * parameterschema.h
+ * 文件作用: 模型参数的编译期描述 (参数下标、稠密参数向量、迭代变换与依赖规则)
+ * 功能描述:
+ * 1. 为全部模型参数分配固定下标，参数以定长数组 ParamVector 存放，
+ *    拟合迭代与模型求解的热点路径中不再使用按字符串查找的 QMap，也不产生堆分配。
+ * 2. 声明每个参数在拟合迭代中的变换方式 (对数 / 线性)，统一原先散落各处的
+ *    "值为正且不是 S、nf 时取对数" 判断。
+ * 3. 派生参数规则 (无因次缝长 LfD = Lf / L) 集中在 applyDependencies 中一次求值。
+ * 4. QMap 形式的参数表只在界面、图版等边界处通过 fromMap / toMap 转换。
+ */
+
+#ifndef PARAMETERSCHEMA_H
+#define PARAMETERSCHEMA_H
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <array>
+
+#include "modelenums.h"
+
+// 参数下标 (全部模型共用)
+enum ParamId {
+    Param_kf = 0,   // 内区渗透率
+    Param_km,       // 外区渗透率
+    Param_L,        // 水平井长
+    Param_Lf,       // 裂缝半长
+    Param_LfD,      // 无因次缝长 (派生: Lf / L)
+    Param_nf,       // 裂缝条数
+    Param_omega1,
+    Param_omega2,
+    Param_lambda1,
+    Param_rmD,      // 无因次复合半径
+    Param_reD,      // 无因次外边界半径
+    Param_cD,       // 无因次井储
+    Param_S,        // 表皮系数
+    Param_gamaD,    // 压敏系数
+    Param_phi,
+    Param_mu,
+    Param_B,
+    Param_Ct,
+    Param_q,
+    Param_h,
+    Param_N,        // Stehfest 项数
+    Param_Count
+};
+
+// 稠密参数向量 (按 ParamId 下标存放)
+using ParamVector = std::array<double, Param_Count>;
+
+// 编译后的拟合问题描述: 参数值与上下限按下标存放，fitIds 为参与拟合的参数下标
+struct CompiledFitParams {
+    ModelType type;
+    ParamVector values;
+    ParamVector lower;
+    ParamVector upper;
+    QVector<int> fitIds;
+};
+
+class ParameterSchema
+{
+public:
+    // 参数在拟合迭代中的变换方式
+    enum Transform {
+        Transform_Linear,   // 迭代坐标即参数值 (S、nf、N)
+        Transform_Log10     // 迭代坐标为 log10(参数值)
+    };
+
+    // 各模型的参数描述 (首次调用时编译，此后只读，可在多线程中共享)
+    static const ParameterSchema& forModel(ModelType type);
+
+    ModelType modelType() const { return m_type; }
+    // 参数在该模型中是否起作用 (reD 仅用于有界模型，cD/S 仅用于变井储模型)
+    bool isActive(int id) const { return id >= 0 && id < Param_Count && m_active[id]; }
+
+    // 名称与下标互查，未知名称返回 -1
+    static int indexOf(const QString& name);
+    static QString nameOf(int id);
+
+    static Transform transform(int id);
+    // 当前取值下是否按对数迭代 (取值非正时退回线性)
+    static bool usesLog(int id, double value) { return transform(id) == Transform_Log10 && value > 1e-12; }
+    // 在迭代坐标中前进 delta
+    static double applyStep(int id, double value, double delta);
+    // 两个取值在迭代坐标中的差 (以 from 的变换方式为准)
+    static double stepBetween(int id, double from, double to);
+
+    // 未给定参数的缺省值 (物性参数与 ModelSolver01_06 原有缺省值一致)
+    static const ParamVector& defaults();
+
+    // 派生参数规则: LfD = Lf / L
+    static void applyDependencies(ParamVector& v);
+
+    // 与 QMap 参数表互相转换 (只在边界处使用)
+    // fromMap: 未给出的参数取缺省值；只给出 LfD 而没有 Lf 时按 Lf = LfD·L 补齐，再应用依赖规则
+    static ParamVector fromMap(const QMap<QString, double>& map);
+    QMap<QString, double> toMap(const ParamVector& v) const;
+
+    // QMap 参数表中的依赖规则 (图版节点、敏感性工况、初值候选等边界处使用)
+    // setMapValue: 写入一个参数并保持派生关系: 写入 LfD 时同步 Lf = LfD·L，写入 L 或 Lf 时重新计算 LfD
+    static void setMapValue(QMap<QString, double>& map, const QString& name, double value);
+    // applyDependencies: 按 fromMap 的规则补齐参数表中的 LfD (Lf 优先)
+    static void applyDependencies(QMap<QString, double>& map);
+
+private:
+    explicit ParameterSchema(ModelType type);
+
+    ModelType m_type;
+    std::array<bool, Param_Count> m_active;
+};
+
+#endif // PARAMETERSCHEMA_H
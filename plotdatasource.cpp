@@ -0,0 +1,80 @@
+/*
+ * plotdatasource.cpp
+ * 文件作用: 图表数据源实现文件
+ * 功能描述:
+ * 1. 生成容器时按索引视图逐行取值，顺带检查 x 是否已升序 (试井数据通常已排序)，
+ *    已排序时直接整体放入容器，省去 QCPDataContainer 的排序。
+ * 2. 缓存项在每次查询时顺带清理，缓存规模与当前显示的曲线数相当。
+ */
+
+#include "plotdatasource.h"
+
+QVector<int> PlotSeries::rows() const
+{
+    const int n = rowCount();
+    QVector<int> idx;
+    idx.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (accepts(i)) idx.append(i);
+    }
+    return idx;
+}
+
+QSharedPointer<QCPGraphDataContainer> PlotDataSource::createContainer(const PlotSeries& series)
+{
+    const QVector<double>& x = series.x();
+    const QVector<double>& y = series.y();
+    const QVector<int> idx = series.rows();
+
+    QVector<QCPGraphData> points;
+    points.reserve(idx.size());
+    bool sorted = true;
+    for (int i : idx) {
+        if (!points.isEmpty() && x[i] < points.last().key) sorted = false;
+        points.append(QCPGraphData(x[i], y[i]));
+    }
+
+    QSharedPointer<QCPGraphDataContainer> data(new QCPGraphDataContainer);
+    data->set(points, sorted);
+    return data;
+}
+
+QSharedPointer<QCPGraphDataContainer> PlotDataSource::container(const PlotSeries& series)
+{
+    prune();
+    Key key{series.x().constData(), series.y().constData(), series.rowCount(), series.minValue()};
+    auto it = cache().find(key);
+    if (it != cache().end()) {
+        QSharedPointer<QCPGraphDataContainer> data = it->data.toStrongRef();
+        if (data) return data;
+    }
+
+    QSharedPointer<QCPGraphDataContainer> data = createContainer(series);
+    Entry entry;
+    entry.x = series.x();
+    entry.y = series.y();
+    entry.data = data;
+    cache().insert(key, entry);
+    return data;
+}
+
+int PlotDataSource::cacheSize()
+{
+    prune();
+    return cache().size();
+}
+
+void PlotDataSource::prune()
+{
+    QHash<Key, Entry>& c = cache();
+    for (auto it = c.begin(); it != c.end();) {
+        if (it->data.isNull()) it = c.erase(it);
+        else ++it;
+    }
+}
+
+QHash<PlotDataSource::Key, PlotDataSource::Entry>& PlotDataSource::cache()
+{
+    static QHash<Key, Entry> s_cache;
+    return s_cache;
+}
@@ -0,0 +1,97 @@
+/*
+ * plotdatasource.h
+ * 文件作用: 图表数据源头文件 —— 把共享只读的数据列适配为 QCPGraph 的数据容器
+ * 功能描述:
+ * 1. PlotSeries 描述一条曲线: x、y 两个数据列 (QVector 隐式共享的只读缓冲区，按值传递只增加引用计数)
+ *    加上可选的过滤条件 (对数坐标只取 x、y 均大于下限的行)。过滤结果是行号索引视图，不复制数据列。
+ * 2. QCPGraph 只能从自身的数据容器 (按 x 排序的 key/value 数组) 绘制，不能直接读取外部数据列；
+ *    PlotDataSource 为每组 "数据列 + 过滤条件" 只生成一个容器，以共享指针交给所有显示它的曲线
+ *    (主图表、弹出的 ChartWindow 等)。同一组数据无论显示在几个图表中，内存中只有原始数据列与一份容器。
+ * 3. 容器按数据列的缓冲区地址缓存 (缓存项持有数据列的引用，缓存项存在期间地址不会被复用)，
+ *    最后一条使用它的曲线释放容器后缓存项随之清除。只在界面线程中使用。
+ * 4. 共享容器是只读的: 绑定后不可再对曲线调用 setData(keys, values)、addData 等原地修改容器的接口，
+ *    更新数据时应重新调用 setGraphData 替换容器。
+ */
+
+#ifndef PLOTDATASOURCE_H
+#define PLOTDATASOURCE_H
+
+#include <QVector>
+#include <QHash>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <limits>
+
+#include "qcustomplot.h"
+
+class PlotSeries
+{
+public:
+    PlotSeries() {}
+    // minValue 为过滤下限 (x、y 均须大于它)，缺省不过滤
+    PlotSeries(const QVector<double>& x, const QVector<double>& y,
+               double minValue = -std::numeric_limits<double>::infinity())
+        : m_x(x), m_y(y), m_minValue(minValue) {}
+
+    // 对数坐标曲线: 只取 x、y 均为正 (大于 minValue) 的行
+    static PlotSeries positive(const QVector<double>& x, const QVector<double>& y, double minValue = 1e-8) {
+        return PlotSeries(x, y, minValue);
+    }
+
+    const QVector<double>& x() const { return m_x; }
+    const QVector<double>& y() const { return m_y; }
+    double minValue() const { return m_minValue; }
+    bool isFiltered() const { return m_minValue > -std::numeric_limits<double>::infinity(); }
+    int rowCount() const { return qMin(m_x.size(), m_y.size()); }
+
+    bool accepts(int i) const { return !isFiltered() || (m_x[i] > m_minValue && m_y[i] > m_minValue); }
+    // 满足过滤条件的行号 (索引视图)
+    QVector<int> rows() const;
+
+private:
+    QVector<double> m_x, m_y;
+    double m_minValue = -std::numeric_limits<double>::infinity();
+};
+
+class PlotDataSource
+{
+public:
+    // series 对应的共享容器 (同一数据列与过滤条件只生成一次)
+    static QSharedPointer<QCPGraphDataContainer> container(const PlotSeries& series);
+
+    // 不经缓存直接生成容器 (每次数据都不同的曲线，如拟合迭代中的理论曲线)
+    static QSharedPointer<QCPGraphDataContainer> createContainer(const PlotSeries& series);
+
+    // 把曲线绑定到 series 的共享容器
+    static void setGraphData(QCPGraph* graph, const PlotSeries& series) {
+        if (graph) graph->setData(container(series));
+    }
+
+    // 当前仍被曲线引用的容器个数
+    static int cacheSize();
+
+private:
+    struct Key {
+        const double* x;
+        const double* y;
+        int rows;
+        double minValue;
+        bool operator==(const Key& o) const {
+            return x == o.x && y == o.y && rows == o.rows && minValue == o.minValue;
+        }
+    };
+    friend size_t qHash(const Key& key, size_t seed) {
+        return qHashMulti(seed, quintptr(key.x), quintptr(key.y), key.rows, key.minValue);
+    }
+
+    struct Entry {
+        QVector<double> x, y;   // 持有数据列，保证缓冲区地址不被复用
+        QWeakPointer<QCPGraphDataContainer> data;
+    };
+
+    // 清除容器已释放的缓存项
+    static void prune();
+    static QHash<Key, Entry>& cache();
+};
+
+#endif // PLOTDATASOURCE_H
@@ -5,6 +5,7 @@
  * 1. 实现了基于试井类型的压差计算逻辑 (降落: Pi-P, 恢复: P-Pwf)。
  * 2. 实现了 Bourdet 导数算法。
  * 3. 将计算生成的压差和导数写回数据模型。
+ * 4. 实现了增量 Bourdet 导数 (IncrementalBourdetDerivative)，批量计算在时间有序时也使用它。
  */
 
 #include "pressurederivativecalculator.h"
@@ -215,6 +216,50 @@ QVector<double> PressureDerivativeCalculator::calculateBourdetDerivative(
     const QVector<double>& timeData,
     const QVector<double>& pressureDropData,
     double lSpacing)
+{
+    // 时间为正且严格递增 (绝大多数情况): 增量算法只需线性时间，结果与下面的逐点搜索一致
+    IncrementalBourdetDerivative incremental(lSpacing);
+    if (incremental.assign(timeData, pressureDropData)) return incremental.derivative();
+
+    // 导数结果取绝对值（双对数图要求正值）
+    QVector<double> derivativeData = signedBourdetDerivative(timeData, pressureDropData, lSpacing);
+    for (double& d : derivativeData) d = std::abs(d);
+    return derivativeData;
+}
+
+QVector<QVector<double>> PressureDerivativeCalculator::calculateBourdetSensitivity(
+    const QVector<double>& timeData,
+    const QVector<double>& pressureDropData,
+    const QVector<QVector<double>>& dPressureDropData,
+    double lSpacing)
+{
+    const int n = timeData.size();
+    QVector<QVector<double>> out(dPressureDropData.size(), QVector<double>(n, 0.0));
+
+    // 与 calculateBourdetDerivative 相同的分支: 时间有序时用增量算法建立的左右点，否则逐点搜索
+    IncrementalBourdetDerivative stencil(lSpacing);
+    const bool ordered = stencil.assign(timeData, pressureDropData);
+    auto signedDerivative = [&](const QVector<double>& values) {
+        if (!ordered) return signedBourdetDerivative(timeData, values, lSpacing);
+        QVector<double> d(n);
+        for (int i = 0; i < n; ++i) d[i] = stencil.signedDerivativeAt(i, values);
+        return d;
+    };
+
+    // 绝对值在 0 处取右导数
+    const QVector<double> base = signedDerivative(pressureDropData);
+    for (int j = 0; j < out.size(); ++j) {
+        if (dPressureDropData[j].size() != n) continue;
+        const QVector<double> d = signedDerivative(dPressureDropData[j]);
+        for (int i = 0; i < n; ++i) out[j][i] = (base[i] < 0.0) ? -d[i] : d[i];
+    }
+    return out;
+}
+
+QVector<double> PressureDerivativeCalculator::signedBourdetDerivative(
+    const QVector<double>& timeData,
+    const QVector<double>& pressureDropData,
+    double lSpacing)
 {
     QVector<double> derivativeData;
     int n = timeData.size();
@@ -283,8 +328,7 @@ QVector<double> PressureDerivativeCalculator::calculateBourdetDerivative(
             }
         }
 
-        // 导数结果取绝对值（双对数图要求正值）
-        derivativeData.append(std::abs(derivative));
+        derivativeData.append(derivative);
     }
 
     return derivativeData;
@@ -398,3 +442,102 @@ QString PressureDerivativeCalculator::formatValue(double value, int precision)
     if (std::isnan(value) || std::isinf(value)) return "0";
     return QString::number(value, 'g', precision);
 }
+
+// =========================================================================
+// 增量 Bourdet 导数
+// =========================================================================
+
+IncrementalBourdetDerivative::IncrementalBourdetDerivative(double lSpacing)
+{
+    reset(lSpacing);
+}
+
+void IncrementalBourdetDerivative::reset(double lSpacing)
+{
+    m_lSpacing = lSpacing;
+    m_t.clear(); m_lnT.clear(); m_dp.clear(); m_deriv.clear();
+    m_left.clear(); m_right.clear();
+    m_leftCursor = -1;
+    m_firstPending = 0;
+}
+
+bool IncrementalBourdetDerivative::assign(const QVector<double>& timeData, const QVector<double>& pressureDropData)
+{
+    reset(m_lSpacing);
+    if (timeData.size() != pressureDropData.size()) return false;
+
+    const int n = timeData.size();
+    for (QVector<double>* v : {&m_t, &m_lnT, &m_dp, &m_deriv}) v->reserve(n);
+    m_left.reserve(n);
+    m_right.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (append(timeData[i], pressureDropData[i]) < 0) {
+            reset(m_lSpacing);
+            return false;
+        }
+    }
+    return true;
+}
+
+int IncrementalBourdetDerivative::append(double t, double pressureDrop)
+{
+    if (!(t > 0.0) || (!m_t.isEmpty() && !(t > m_t.last()))) return -1;
+
+    const int n = m_t.size();
+    const double lnT = std::log(t);
+    m_t.append(t);
+    m_lnT.append(lnT);
+    m_dp.append(pressureDrop);
+
+    // 新点的左侧点: 时间递增，左侧点只会前移
+    while (m_leftCursor + 1 < n && lnT - m_lnT[m_leftCursor + 1] >= m_lSpacing) ++m_leftCursor;
+    m_left.append(m_leftCursor);
+    m_right.append(-1);
+    m_deriv.append(0.0);
+
+    // 尚无右侧点的尾部点: 新点是它们第一个满足 L 间距的右侧点，导数就此确定
+    int changed = n;
+    while (m_firstPending < n && lnT - m_lnT[m_firstPending] >= m_lSpacing) {
+        m_right[m_firstPending] = n;
+        m_deriv[m_firstPending] = derivativeAt(m_firstPending);
+        changed = qMin(changed, m_firstPending);
+        ++m_firstPending;
+    }
+    // 第一点两侧都没有 L 间距点时以下一点差分保底，第二点到来前无法计算
+    if (n == 1 && m_right[0] < 0) {
+        m_deriv[0] = derivativeAt(0);
+        changed = 0;
+    }
+
+    m_deriv[n] = derivativeAt(n);
+    return changed;
+}
+
+double IncrementalBourdetDerivative::signedDerivativeAt(int i, const QVector<double>& values) const
+{
+    const int n = m_t.size();
+    const int left = m_left[i];
+    const int right = m_right[i];
+    auto slope = [this, &values](int a, int b) {
+        const double dx = m_lnT[a] - m_lnT[b];
+        return std::abs(dx) < 1e-10 ? 0.0 : (values[a] - values[b]) / dx;
+    };
+
+    double derivative = 0.0;
+    if (left >= 0 && right >= 0) {
+        // 加权平均 (Bourdet Standard)
+        const double dxL = m_lnT[i] - m_lnT[left];
+        const double dxR = m_lnT[right] - m_lnT[i];
+        if (dxL + dxR > 1e-12)
+            derivative = (slope(i, left) * dxR + slope(right, i) * dxL) / (dxL + dxR);
+    } else if (left >= 0) {
+        derivative = slope(i, left);
+    } else if (right >= 0) {
+        derivative = slope(right, i);
+    } else if (i > 0) {
+        derivative = slope(i, i - 1);
+    } else if (i < n - 1) {
+        derivative = slope(i + 1, i);
+    }
+    return derivative;
+}
@@ -14,6 +14,7 @@
 #include <QString>
 #include <QVector>
 #include <QStandardItemModel>
+#include <cmath>
 
 // 压力导数计算结果结构
 struct PressureDerivativeResult {
@@ -119,6 +120,24 @@ public:
                                                       const QVector<double>& pressureDropData,
                                                       double lSpacing);
 
+    /**
+     * @brief Bourdet 导数对模型参数的偏导 (拟合雅可比矩阵使用)
+     * 左右 L 间距点只由时间决定，导数是压差的线性组合再取绝对值:
+     * 对压差偏导做同样的组合并乘以该点导数的符号，即为 calculateBourdetDerivative 结果的精确偏导
+     * @param dPressureDropData 压差对各参数的偏导，每列与 timeData 等长
+     * @return 每列对应一个参数的导数偏导
+     */
+    static QVector<QVector<double>> calculateBourdetSensitivity(const QVector<double>& timeData,
+                                                                const QVector<double>& pressureDropData,
+                                                                const QVector<QVector<double>>& dPressureDropData,
+                                                                double lSpacing);
+
+    // 逐点搜索左右 L 间距点的 Bourdet 导数 (带符号，未取绝对值)。
+    // 时间无序或不为正时 calculateBourdetDerivative 使用它，也是增量算法的对照实现 (见 BourdetBenchmark)
+    static QVector<double> signedBourdetDerivative(const QVector<double>& timeData,
+                                                   const QVector<double>& pressureDropData,
+                                                   double lSpacing);
+
 signals:
     void progressUpdated(int progress, const QString& message);
     void calculationCompleted(const PressureDerivativeResult& result);
@@ -135,4 +154,47 @@ private:
     QString formatValue(double value, int precision = 6);
 };
 
+/**
+ * @brief 增量 Bourdet 导数 (只追加数据时使用)
+ *
+ * 保存各点的对数时间与左右 L 间距点下标:
+ * 1. append() 追加一点时，新点的左侧点随时间单调前移；只有尚无右侧点的尾部点以新点为右侧点
+ *    修正一次导数，此后不再变化。每次追加均摊 O(1)，不重算整列。
+ * 2. 结果与 calculateBourdetDerivative 对同一组数据的结果一致；时间须为正且严格递增。
+ */
+class IncrementalBourdetDerivative
+{
+public:
+    explicit IncrementalBourdetDerivative(double lSpacing = 0.15);
+
+    // 清空数据并设置 L-Spacing
+    void reset(double lSpacing);
+
+    // 批量建立；时间不是正的严格递增序列或长度不一致时返回 false 并清空
+    bool assign(const QVector<double>& timeData, const QVector<double>& pressureDropData);
+
+    // 追加一点，返回导数发生变化的最小下标；t 不大于上一点 (或不为正) 时忽略并返回 -1
+    int append(double t, double pressureDrop);
+
+    int size() const { return m_t.size(); }
+    double lSpacing() const { return m_lSpacing; }
+    const QVector<double>& time() const { return m_t; }
+    const QVector<double>& logTime() const { return m_lnT; }
+    const QVector<double>& pressureDrop() const { return m_dp; }
+    const QVector<double>& derivative() const { return m_deriv; }
+
+    // 用已建立的左右 L 间距点对与时间对应的另一列数据 (如压差偏导) 做同样的差分，结果带符号
+    double signedDerivativeAt(int i, const QVector<double>& values) const;
+
+private:
+    double derivativeAt(int i) const { return std::abs(signedDerivativeAt(i, m_dp)); }
+
+    double m_lSpacing;
+    QVector<double> m_t, m_lnT, m_dp, m_deriv;
+    QVector<int> m_left;    // 左侧 L 间距点 (-1 表示无)
+    QVector<int> m_right;   // 右侧 L 间距点 (-1 表示尚无)
+    int m_leftCursor;       // 最新点的左侧点
+    int m_firstPending;     // 第一个尚无右侧点的点 (其后的点均无右侧点)
+};
+
 #endif // PRESSUREDERIVATIVECALCULATOR_H
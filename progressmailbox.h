@@ -0,0 +1,50 @@
+/*
+ * progressmailbox.h
+ * 文件作用: 工作线程向界面线程传递进度快照的单槽邮箱
+ * 功能描述:
+ * 1. 邮箱只保存最新的一份快照: post() 以原子交换放入新快照并丢弃尚未取走的旧快照，
+ *    take() 以原子交换取走快照并清空邮箱。两端都不加锁，也不经过事件队列。
+ * 2. 工作线程推送的频率与界面刷新无关: 界面按固定频率轮询，两次轮询之间的中间状态直接被覆盖，
+ *    不会像排队信号那样积压并逐个复制、逐个重绘。
+ * 3. 允许多个工作线程同时 post() (如多起点并行拟合)，take() 应只在一个线程 (界面线程) 中调用。
+ */
+
+#ifndef PROGRESSMAILBOX_H
+#define PROGRESSMAILBOX_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <utility>
+
+template <typename T>
+class ProgressMailbox
+{
+public:
+    ProgressMailbox() : m_slot(nullptr) {}
+    ~ProgressMailbox() { clear(); }
+
+    // 放入最新快照 (任意线程)
+    void post(T value) {
+        T* old = m_slot.exchange(new T(std::move(value)), std::memory_order_acq_rel);
+        delete old;
+    }
+
+    // 取走快照，邮箱为空时返回 false 且不改动 out
+    bool take(T& out) {
+        T* p = m_slot.exchange(nullptr, std::memory_order_acq_rel);
+        if (!p) return false;
+        out = std::move(*p);
+        delete p;
+        return true;
+    }
+
+    // 丢弃未取走的快照
+    void clear() { delete m_slot.exchange(nullptr, std::memory_order_acq_rel); }
+
+private:
+    Q_DISABLE_COPY(ProgressMailbox)
+
+    std::atomic<T*> m_slot;
+};
+
+#endif // PROGRESSMAILBOX_H
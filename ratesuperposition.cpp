@@ -0,0 +1,293 @@
+/*
+ * ratesuperposition.cpp
+ * 文件作用: 变产量叠加算子实现文件
+ * 功能描述:
+ * 1. 产量历史的构造与合并。
+ * 2. 对数网格上的三次 Hermite 插值系数 (含对 ln(u) 的一阶、二阶导数)。
+ * 3. 对数分箱的叠加求和，生成压差与导数两个稀疏算子。
+ */
+
+#include "ratesuperposition.h"
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+// ===========================================================================
+// RateHistory
+// ===========================================================================
+
+double RateHistory::rateAt(double t) const
+{
+    auto it = std::upper_bound(startTime.constBegin(), startTime.constEnd(), t);
+    if (it == startTime.constBegin()) return 0.0;
+    return rate[int(it - startTime.constBegin()) - 1];
+}
+
+double RateHistory::maxAbsRate() const
+{
+    double m = 0.0;
+    for (double q : rate) m = qMax(m, std::abs(q));
+    return m;
+}
+
+RateHistory RateHistory::fromSamples(const QVector<double>& t, const QVector<double>& q)
+{
+    RateHistory h;
+    const int n = qMin(t.size(), q.size());
+    double prevTime = 0.0;
+    for (int i = 0; i < n; ++i) {
+        if (!std::isfinite(t[i]) || !std::isfinite(q[i]) || t[i] <= prevTime) continue;
+        // 与上一阶段产量相同时并入上一阶段
+        if (h.rate.isEmpty() || h.rate.last() != q[i]) {
+            h.startTime.append(prevTime);
+            h.rate.append(q[i]);
+        }
+        prevTime = t[i];
+    }
+    return h;
+}
+
+RateHistory RateHistory::fromDurations(const QVector<double>& durations, const QVector<double>& q)
+{
+    RateHistory h;
+    const int n = qMin(durations.size(), q.size());
+    double start = 0.0;
+    for (int i = 0; i < n; ++i) {
+        if (!std::isfinite(durations[i]) || !std::isfinite(q[i]) || durations[i] <= 0.0) continue;
+        if (h.rate.isEmpty() || h.rate.last() != q[i]) {
+            h.startTime.append(start);
+            h.rate.append(q[i]);
+        }
+        start += durations[i];
+    }
+    return h;
+}
+
+// ===========================================================================
+// RateSuperposition
+// ===========================================================================
+
+RateSuperposition::RateSuperposition(const RateHistory& history, const QVector<double>& evalTime,
+                                     int pointsPerDecade, double binRatio)
+    : m_history(history), m_evalTime(evalTime)
+{
+    const int nChanges = history.size();
+    const int nEval = evalTime.size();
+    if (nChanges == 0 || nEval == 0) return;
+
+    // 1. 产量变化量 Δq_j 及其前缀和 (Σ Δq、Σ Δq·τ)
+    const QVector<double>& tau = history.startTime;
+    std::vector<double> sumQ(nChanges + 1, 0.0), sumQT(nChanges + 1, 0.0);
+    for (int j = 0; j < nChanges; ++j) {
+        double dq = history.rate[j] - (j > 0 ? history.rate[j - 1] : 0.0);
+        sumQ[j + 1] = sumQ[j] + dq;
+        sumQT[j + 1] = sumQT[j] + dq * tau[j];
+    }
+
+    // 2. 时滞范围: 最小时滞来自每个时刻最近一次产量变化，最大时滞来自首次变化
+    std::vector<int> active(nEval);
+    double uMin = std::numeric_limits<double>::max(), uMax = 0.0;
+    for (int i = 0; i < nEval; ++i) {
+        double t = evalTime[i];
+        int k = int(std::lower_bound(tau.constBegin(), tau.constEnd(), t) - tau.constBegin());
+        active[i] = k;      // τ_0 .. τ_{k-1} < t
+        if (k == 0) continue;
+        uMin = qMin(uMin, t - tau[k - 1]);
+        uMax = qMax(uMax, t - tau[0]);
+    }
+    if (uMax <= 0.0) return;
+    // 极小时滞 (评价时刻紧贴产量变化) 不再细分网格，改用线性外推
+    uMin = qMax(uMin, uMax * 1e-10);
+    if (uMax <= uMin * 1.0001) uMin = uMax / 10.0;
+
+    const int ppd = qMax(4, pointsPerDecade);
+    const double decades = std::log10(uMax / uMin);
+    const int nGrid = qMax(4, int(std::ceil(decades * ppd)) + 1);
+    m_logStart = std::log(uMin);
+    m_logStep = std::log(uMax / uMin) / (nGrid - 1);
+    m_unitTime.resize(nGrid);
+    for (int k = 0; k < nGrid; ++k) m_unitTime[k] = std::exp(m_logStart + k * m_logStep);
+
+    // 3. 逐时刻合并同一对数区间内的产量变化，累加到稠密行后取出非零元
+    const double ratio = 1.0 + qMax(0.0, binRatio);
+    std::vector<Eigen::Triplet<double>> pTriplets, dTriplets;
+    std::vector<double> pRow(nGrid), dRow(nGrid);
+    for (int i = 0; i < nEval; ++i) {
+        const double t = evalTime[i];
+        std::fill(pRow.begin(), pRow.end(), 0.0);
+        std::fill(dRow.begin(), dRow.end(), 0.0);
+
+        int hi = active[i] - 1;
+        while (hi >= 0) {
+            // 组内时滞介于 [t - τ_hi, (t - τ_hi)·ratio]
+            double lagLimit = (t - tau[hi]) * ratio;
+            int lo = int(std::lower_bound(tau.constBegin(), tau.constBegin() + hi + 1, t - lagLimit) - tau.constBegin());
+            double s0 = sumQ[hi + 1] - sumQ[lo];
+            double s1 = sumQT[hi + 1] - sumQT[lo];
+            double uc = t - 0.5 * (tau[lo] + tau[hi]);
+            // 一阶矩 M1 = Σ Δq·(u_j - ū)
+            double m1 = s0 * (t - uc) - s1;
+            if (s0 != 0.0 || m1 != 0.0) {
+                // Δp 项: S0·p(ū) + M1·p'(ū)，p' = p_x / ū
+                accumulate(uc, s0, m1 / uc, 0.0, pRow.data());
+                // 导数项 t·Σ Δq·p'(u_j): p' = p_x/u，(p')' = (p_xx - p_x)/u²
+                accumulate(uc, 0.0, t * (s0 / uc - m1 / (uc * uc)), t * m1 / (uc * uc), dRow.data());
+            }
+            hi = lo - 1;
+        }
+
+        for (int k = 0; k < nGrid; ++k) {
+            if (pRow[k] != 0.0) pTriplets.emplace_back(i, k, pRow[k]);
+            if (dRow[k] != 0.0) dTriplets.emplace_back(i, k, dRow[k]);
+        }
+    }
+
+    m_pressureOp.resize(nEval, nGrid);
+    m_derivativeOp.resize(nEval, nGrid);
+    m_pressureOp.setFromTriplets(pTriplets.begin(), pTriplets.end());
+    m_derivativeOp.setFromTriplets(dTriplets.begin(), dTriplets.end());
+    m_valid = true;
+}
+
+void RateSuperposition::accumulate(double u, double c0, double c1, double c2, double* row) const
+{
+    const int n = m_unitTime.size();
+    const double h = m_logStep;
+    const double x = std::log(u);
+
+    // 网格之前: p ≈ p_0·u/u_0 (早期井储段单位斜率)，此时 p_x = p_xx = p
+    if (x < m_logStart) {
+        row[0] += (c0 + c1 + c2) * (u / m_unitTime[0]);
+        return;
+    }
+
+    int k = qBound(0, int((x - m_logStart) / h), n - 2);
+    double s = qBound(0.0, (x - m_logStart) / h - k, 1.0);
+    double s2 = s * s, s3 = s2 * s;
+
+    // Hermite 基函数及其对 s 的一、二阶导数
+    double h00 = 2 * s3 - 3 * s2 + 1, h10 = s3 - 2 * s2 + s, h01 = -2 * s3 + 3 * s2, h11 = s3 - s2;
+    double d00 = 6 * s2 - 6 * s, d10 = 3 * s2 - 4 * s + 1, d01 = -6 * s2 + 6 * s, d11 = 3 * s2 - 2 * s;
+    double e00 = 12 * s - 6, e10 = 6 * s - 4, e01 = -12 * s + 6, e11 = 6 * s - 2;
+
+    // p   = h00·p_k + h01·p_k+1 + h·(h10·m_k + h11·m_k+1)
+    // p_x = (d00·p_k + d01·p_k+1)/h + d10·m_k + d11·m_k+1
+    // p_xx = (e00·p_k + e01·p_k+1)/h² + (e10·m_k + e11·m_k+1)/h
+    double cPk = c0 * h00 + c1 * d00 / h + c2 * e00 / (h * h);
+    double cPk1 = c0 * h01 + c1 * d01 / h + c2 * e01 / (h * h);
+    double cMk = c0 * h * h10 + c1 * d10 + c2 * e10 / h;
+    double cMk1 = c0 * h * h11 + c1 * d11 + c2 * e11 / h;
+
+    row[k] += cPk;
+    row[k + 1] += cPk1;
+
+    // 节点斜率 m_j (对 ln u) 的差分模板: 内点中心差分，端点二阶单侧差分
+    auto addSlope = [&](int j, double c) {
+        if (c == 0.0) return;
+        double w = c / (2.0 * h);
+        if (n < 3) {
+            row[0] -= 2.0 * w; row[1] += 2.0 * w;
+        } else if (j == 0) {
+            row[0] -= 3.0 * w; row[1] += 4.0 * w; row[2] -= w;
+        } else if (j == n - 1) {
+            row[n - 3] += w; row[n - 2] -= 4.0 * w; row[n - 1] += 3.0 * w;
+        } else {
+            row[j - 1] -= w; row[j + 1] += w;
+        }
+    };
+    addSlope(k, cMk);
+    addSlope(k + 1, cMk1);
+}
+
+double RateSuperposition::referenceRate(const ParamVector& params) const
+{
+    double q = params[Param_q];
+    if (q > 0.0) return q;
+    double m = m_history.maxAbsRate();
+    return m > 0.0 ? m : 1.0;
+}
+
+ParamVector RateSuperposition::unitParams(const ParamVector& params) const
+{
+    ParamVector p = params;
+    p[Param_gamaD] = 0.0;
+    p[Param_q] = referenceRate(params);
+    return p;
+}
+
+ModelCurveData RateSuperposition::apply(const ModelCurveData& unitCurve, const ParamVector& params) const
+{
+    const QVector<double>& pu = std::get<1>(unitCurve);
+    if (!m_valid || pu.size() != m_unitTime.size()) return ModelCurveData();
+
+    const int nEval = m_evalTime.size();
+    const double qRef = referenceRate(params);
+    Eigen::Map<const Eigen::VectorXd> unit(pu.constData(), pu.size());
+
+    QVector<double> p(nEval), d(nEval);
+    Eigen::Map<Eigen::VectorXd> pOut(p.data(), nEval), dOut(d.data(), nEval);
+    pOut.noalias() = m_pressureOp * unit / qRef;
+    dOut.noalias() = m_derivativeOp * unit / qRef;
+
+    // 压敏变换: pD = -ln(1 - γ·pD_lin)/γ，导数按链式法则除以 (1 - γ·pD_lin)
+    double gamaD = params[Param_gamaD];
+    if (std::abs(gamaD) > 1e-9) {
+        ParamVector ref = params;
+        ref[Param_q] = qRef;
+        double factor = ModelSolver01_06::pressureScale(ref);
+        if (std::abs(factor) > 1e-300) {
+            for (int i = 0; i < nEval; ++i) {
+                double arg = 1.0 - gamaD * p[i] / factor;
+                if (arg > 1e-12) {
+                    p[i] = -factor / gamaD * std::log(arg);
+                    d[i] /= arg;
+                }
+            }
+        }
+    }
+    return std::make_tuple(m_evalTime, p, d);
+}
+
+ModelSensitivityData RateSuperposition::apply(const ModelSensitivityData& unitSens, const ParamVector& params) const
+{
+    ModelSensitivityData out;
+    if (!m_valid || unitSens.pressure.size() != m_unitTime.size()) return out;
+    if (std::abs(params[Param_gamaD]) > 1e-9) return out;
+
+    const int nEval = m_evalTime.size();
+    const int nGrid = m_unitTime.size();
+    const double invQ = 1.0 / referenceRate(params);
+
+    out.time = m_evalTime;
+    out.paramNames = unitSens.paramNames;
+    out.pressure.resize(nEval);
+    out.derivative.resize(nEval);
+    Eigen::Map<const Eigen::VectorXd> unit(unitSens.pressure.constData(), nGrid);
+    Eigen::Map<Eigen::VectorXd>(out.pressure.data(), nEval).noalias() = m_pressureOp * unit * invQ;
+    Eigen::Map<Eigen::VectorXd>(out.derivative.data(), nEval).noalias() = m_derivativeOp * unit * invQ;
+
+    // 导数输出由压力网格值经算子 D 得到，故偏导也只需对 ∂p_u/∂θ 做同样的叠加；
+    // 单位响应正比于参考产量 q，叠加结果与 q 无关，其偏导为 0
+    const int nSens = unitSens.dPressure.size();
+    out.dPressure = QVector<QVector<double>>(nSens, QVector<double>(nEval, 0.0));
+    out.dDerivative = QVector<QVector<double>>(nSens, QVector<double>(nEval, 0.0));
+    for (int s = 0; s < nSens; ++s) {
+        if (unitSens.dPressure[s].size() != nGrid) return ModelSensitivityData();
+        if (ParameterSchema::indexOf(unitSens.paramNames.value(s)) == Param_q) continue;
+        Eigen::Map<const Eigen::VectorXd> du(unitSens.dPressure[s].constData(), nGrid);
+        Eigen::Map<Eigen::VectorXd>(out.dPressure[s].data(), nEval).noalias() = m_pressureOp * du * invQ;
+        Eigen::Map<Eigen::VectorXd>(out.dDerivative[s].data(), nEval).noalias() = m_derivativeOp * du * invQ;
+    }
+    return out;
+}
+
+ModelCurveData RateSuperposition::calculateCurve(ModelType type, const ParamVector& params, bool highPrecision,
+                                                 const CancellationToken& cancel) const
+{
+    if (!m_valid) return ModelCurveData();
+    ModelCurveData unit = ModelSolver01_06::calculateTheoreticalCurve(type, unitParams(params), m_unitTime, highPrecision, cancel);
+    if (cancel.isCancelled()) return ModelCurveData();
+    return apply(unit, params);
+}
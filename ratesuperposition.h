@@ -0,0 +1,96 @@
+/*
+ * ratesuperposition.h
+ * 文件作用: 变产量历史的快速叠加 (褶积) 计算头文件
+ * 功能描述:
+ * 1. RateHistory 描述阶梯产量历史 (各阶段起始时间与产量)，可由逐行产量数据
+ *    或 "阶段时长 + 产量" (与绘图界面的压力产量阶梯图一致) 构造，相同产量的相邻阶段自动合并。
+ * 2. 叠加原理: Δp(t) = Σ (q_j - q_{j-1}) · p_u(t - τ_j)，p_u 为单位产量响应。
+ *    逐项调用求解器的代价为 O(产量阶段数 × 时间点数) 次反演，这里改为:
+ *    - 单位响应只在覆盖全部时滞的对数网格上计算一次 (每十倍程 pointsPerDecade 个点)；
+ *    - 在 ln(时滞) 上用三次 Hermite 插值 (斜率由网格值差分给出)，插值是网格值的线性组合；
+ *    - 对每个评价时刻，时滞落在同一对数区间 (相对宽度 binRatio) 内的产量变化合并为一项，
+ *      用区间内 Δq 与 Δq·τ 的前缀和做一阶矩修正，每个时刻的项数只随时滞跨越的十倍程数增长。
+ * 3. 上述过程整体是作用在网格值上的稀疏线性算子，构造一次后对压差、导数以及
+ *    各参数偏导 (雅可比列) 都只需一次稀疏矩阵乘法，数千次产量变化也可在毫秒级完成。
+ * 4. 导数输出为 t·dΔp/dt (与实测数据的 Bourdet 导数定义一致)，同样由插值的解析导数给出。
+ * 5. 压敏效应 (gamaD ≠ 0) 使问题非线性: 单位响应按 gamaD = 0 计算，叠加后再对
+ *    以参数 q 为参考产量的无因次压力做压敏变换 (近似处理)；此时不提供解析偏导。
+ */
+
+#ifndef RATESUPERPOSITION_H
+#define RATESUPERPOSITION_H
+
+#include <QVector>
+#include <Eigen/Sparse>
+
+#include "modelsolver01_06.h"
+#include "parameterschema.h"
+#include "cancellationtoken.h"
+
+// 阶梯产量历史: 第 j 个阶段自 startTime[j] 起产量为 rate[j]，直到下一阶段开始
+struct RateHistory {
+    QVector<double> startTime;  // 升序
+    QVector<double> rate;
+
+    bool isEmpty() const { return startTime.isEmpty(); }
+    int size() const { return startTime.size(); }
+
+    // t 时刻的产量 (首个阶段之前为 0)
+    double rateAt(double t) const;
+    double maxAbsRate() const;
+
+    // 逐行产量数据: 第 i 行产量为 (t[i-1], t[i]] 区间内的产量 (t[-1] = 0)
+    static RateHistory fromSamples(const QVector<double>& t, const QVector<double>& q);
+    // 阶段时长 + 产量 (自 0 时刻起依次累加)
+    static RateHistory fromDurations(const QVector<double>& durations, const QVector<double>& q);
+};
+
+class RateSuperposition
+{
+public:
+    // 对评价时刻 evalTime 构造叠加算子 (时刻可以无序，≤ 首个阶段起始时间的时刻输出 0)
+    RateSuperposition(const RateHistory& history, const QVector<double>& evalTime,
+                      int pointsPerDecade = 16, double binRatio = 0.03);
+
+    bool isValid() const { return m_valid; }
+    const RateHistory& history() const { return m_history; }
+    const QVector<double>& evalTime() const { return m_evalTime; }
+
+    // 单位响应的计算网格 (时滞，对数等间距)
+    const QVector<double>& unitTime() const { return m_unitTime; }
+
+    // 计算单位响应所用的参数: 压敏系数置 0，参考产量取参数 q (q ≤ 0 时取历史最大产量)
+    ParamVector unitParams(const ParamVector& params) const;
+
+    // unitCurve 为 unitParams(params) 在 unitTime() 上的理论曲线，返回评价时刻上的 <t, Δp, t·dΔp/dt>
+    ModelCurveData apply(const ModelCurveData& unitCurve, const ParamVector& params) const;
+
+    // 对参数偏导同样做叠加；gamaD ≠ 0 时返回空结果 (调用方应退回有限差分)
+    ModelSensitivityData apply(const ModelSensitivityData& unitSens, const ParamVector& params) const;
+
+    // 独立计算 (不经过 ModelManager)
+    ModelCurveData calculateCurve(ModelType type, const ParamVector& params, bool highPrecision,
+                                  const CancellationToken& cancel = CancellationToken()) const;
+
+    // 算子规模 (非零元个数)，用于性能统计
+    int nonZeros() const { return (int)m_pressureOp.nonZeros(); }
+
+private:
+    using SparseOp = Eigen::SparseMatrix<double, Eigen::RowMajor>;
+
+    double referenceRate(const ParamVector& params) const;
+
+    // 将时滞 u 处 c0·p + c1·dp/dln(u) + c2·d²p/dln(u)² 的插值系数累加到稠密行 row (长度为网格点数)
+    void accumulate(double u, double c0, double c1, double c2, double* row) const;
+
+    RateHistory m_history;
+    QVector<double> m_evalTime;
+    QVector<double> m_unitTime;
+    double m_logStart = 0.0;    // ln(unitTime[0])
+    double m_logStep = 0.0;     // ln 网格步长
+    SparseOp m_pressureOp;      // Δp = P · p_u
+    SparseOp m_derivativeOp;    // t·dΔp/dt = D · p_u
+    bool m_valid = false;
+};
+
+#endif // RATESUPERPOSITION_H
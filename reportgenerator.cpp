@@ -0,0 +1,687 @@
+/*
+ * reportgenerator.cpp
+ * 文件作用: 试井分析报告生成实现文件
+ * 功能描述:
+ * 1. 曲线图的配色、图例名称与坐标轴标题与拟合界面 (FittingWidget::setupPlot) 一致:
+ *    实测压差为深绿空心圆、实测导数为品红空心三角，理论压差/导数为红/蓝实线，置信带为半透明填充。
+ * 2. 绘图只使用 QPainter/QImage (光栅绘制，可在工作线程中进行)；同一像素上的重复数据点只画一次，
+ *    数据量很大时绘图耗时只与图像尺寸有关。
+ * 3. 绘图与编码在专用线程池中并行，写文件线程按分析页顺序等待对应的图片，
+ *    文本经 QTextStream 分段写入并逐页刷新，不在内存中拼接整份报告；写入通过 QSaveFile 完成，失败时不留下半个文件。
+ */
+
+#include "reportgenerator.h"
+#include "fittingparameterchart.h"
+#include "modelparameter.h"
+#include "modelmanager.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QFontMetricsF>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QJsonArray>
+#include <QtConcurrent>
+#include <cmath>
+#include <limits>
+#include <functional>
+
+namespace {
+// 报告插图的像素尺寸 (HTML 中按 600 像素宽显示)
+const QSize PlotSize(800, 600);
+
+// 数据的 log10 范围
+struct LogRange {
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+
+    void add(const QVector<double>& values) {
+        for (double v : values) {
+            if (!(v > 0.0) || !std::isfinite(v)) continue;
+            const double l = std::log10(v);
+            lo = qMin(lo, l);
+            hi = qMax(hi, l);
+        }
+    }
+    bool isValid() const { return lo <= hi; }
+};
+
+// 双对数坐标: 范围取整到整数量级，映射到绘图区像素
+struct LogAxes {
+    QRectF rect;
+    int x0, x1, y0, y1;
+
+    double mapX(double logX) const { return rect.left() + (logX - x0) / (x1 - x0) * rect.width(); }
+    double mapY(double logY) const { return rect.bottom() - (logY - y0) / (y1 - y0) * rect.height(); }
+    bool map(double x, double y, QPointF& pt) const {
+        if (!(x > 0.0) || !(y > 0.0) || !std::isfinite(x) || !std::isfinite(y)) return false;
+        pt = QPointF(mapX(std::log10(x)), mapY(std::log10(y)));
+        return true;
+    }
+};
+
+void decadeBounds(const LogRange& range, int defaultLo, int defaultHi, int& lo, int& hi)
+{
+    if (!range.isValid()) {
+        lo = defaultLo;
+        hi = defaultHi;
+        return;
+    }
+    lo = int(std::floor(range.lo));
+    hi = int(std::ceil(range.hi));
+    if (hi <= lo) hi = lo + 1;
+}
+
+bool hasPositive(const QVector<double>& t, const QVector<double>& v)
+{
+    const int n = qMin(t.size(), v.size());
+    for (int i = 0; i < n; ++i)
+        if (t[i] > 0.0 && v[i] > 0.0) return true;
+    return false;
+}
+
+// 散点 (空心圆或空心三角)，与上一个已画点相距不足一个像素的点跳过
+void drawScatter(QPainter& p, const LogAxes& axes, const QVector<double>& t, const QVector<double>& v,
+                 bool triangle, const QColor& color)
+{
+    const double r = 3.0;
+    p.setPen(QPen(color, 1));
+    p.setBrush(Qt::NoBrush);
+    QPointF last(-1e9, -1e9);
+    const int n = qMin(t.size(), v.size());
+    for (int i = 0; i < n; ++i) {
+        QPointF pt;
+        if (!axes.map(t[i], v[i], pt)) continue;
+        if (std::abs(pt.x() - last.x()) < 1.0 && std::abs(pt.y() - last.y()) < 1.0) continue;
+        last = pt;
+        if (triangle) {
+            const QPointF tri[3] = { pt + QPointF(0.0, -1.15 * r), pt + QPointF(r, 0.58 * r), pt + QPointF(-r, 0.58 * r) };
+            p.drawPolygon(tri, 3);
+        } else {
+            p.drawEllipse(pt, r, r);
+        }
+    }
+}
+
+// 折线，遇到非正值断开
+void drawLine(QPainter& p, const LogAxes& axes, const QVector<double>& t, const QVector<double>& v, const QPen& pen)
+{
+    QPainterPath path;
+    bool open = false;
+    QPointF last;
+    const int n = qMin(t.size(), v.size());
+    for (int i = 0; i < n; ++i) {
+        QPointF pt;
+        if (!axes.map(t[i], v[i], pt)) {
+            open = false;
+            continue;
+        }
+        if (!open) {
+            path.moveTo(pt);
+            open = true;
+        } else if (std::abs(pt.x() - last.x()) >= 0.5 || std::abs(pt.y() - last.y()) >= 0.5 || i == n - 1) {
+            path.lineTo(pt);
+        } else {
+            continue;
+        }
+        last = pt;
+    }
+    p.strokePath(path, pen);
+}
+
+// 置信带: 上下限之间半透明填充，边界为虚线
+void drawBand(QPainter& p, const LogAxes& axes, const QVector<double>& t,
+              const QVector<double>& lower, const QVector<double>& upper, const QColor& color)
+{
+    QPolygonF up, low;
+    const int n = qMin(t.size(), qMin(lower.size(), upper.size()));
+    for (int i = 0; i < n; ++i) {
+        QPointF pu, pl;
+        if (!axes.map(t[i], upper[i], pu) || !axes.map(t[i], lower[i], pl)) continue;
+        up << pu;
+        low << pl;
+    }
+    if (up.size() < 2) return;
+
+    QPolygonF area = up;
+    for (int i = low.size() - 1; i >= 0; --i) area << low[i];
+    QColor fill = color;
+    fill.setAlpha(40);
+    p.setPen(Qt::NoPen);
+    p.setBrush(fill);
+    p.drawPolygon(area);
+    p.setBrush(Qt::NoBrush);
+    p.setPen(QPen(color.lighter(140), 1, Qt::DashLine));
+    p.drawPolyline(up);
+    p.drawPolyline(low);
+}
+
+// "10^exp" 形式的刻度标签，anchor 为标签的对齐点 (AlignHCenter|AlignTop 或 AlignRight|AlignVCenter)
+void drawPowerLabel(QPainter& p, const QFont& font, const QPointF& anchor, int exp, Qt::Alignment align)
+{
+    QFont supFont = font;
+    supFont.setPointSizeF(font.pointSizeF() * 0.7);
+    const QFontMetricsF fm(font, p.device());
+    const QFontMetricsF fs(supFont, p.device());
+    const QString base = "10";
+    const QString sup = QString::number(exp);
+    const double width = fm.horizontalAdvance(base) + fs.horizontalAdvance(sup);
+    const double height = fm.height() + 0.4 * fs.ascent();
+
+    double x = anchor.x();
+    if (align & Qt::AlignHCenter) x -= width / 2.0;
+    else if (align & Qt::AlignRight) x -= width;
+    double top = anchor.y();
+    if (align & Qt::AlignVCenter) top -= height / 2.0;
+    const double baseline = top + 0.4 * fs.ascent() + fm.ascent();
+
+    p.setFont(font);
+    p.drawText(QPointF(x, baseline), base);
+    p.setFont(supFont);
+    p.drawText(QPointF(x + fm.horizontalAdvance(base), baseline - 0.45 * fm.ascent()), sup);
+}
+
+// 图例项
+struct LegendEntry {
+    enum Kind { Circle, Triangle, Line, Band } kind;
+    QColor color;
+    QString text;
+};
+
+void drawLegend(QPainter& p, const QRectF& plotRect, const QList<LegendEntry>& entries)
+{
+    if (entries.isEmpty()) return;
+    const QFont font("Arial", 9);
+    const QFontMetricsF fm(font, p.device());
+    const double iconWidth = 24.0;
+    const double rowHeight = fm.height() + 4.0;
+    double textWidth = 0.0;
+    for (const LegendEntry& e : entries) textWidth = qMax(textWidth, fm.horizontalAdvance(e.text));
+
+    const QSizeF boxSize(iconWidth + textWidth + 20.0, rowHeight * entries.size() + 8.0);
+    const QRectF box(plotRect.right() - boxSize.width() - 8.0, plotRect.top() + 8.0, boxSize.width(), boxSize.height());
+    p.setPen(QPen(Qt::black, 1));
+    p.setBrush(QColor(255, 255, 255, 200));
+    p.drawRect(box);
+
+    p.setFont(font);
+    for (int i = 0; i < entries.size(); ++i) {
+        const LegendEntry& e = entries[i];
+        const double cy = box.top() + 4.0 + rowHeight * (i + 0.5);
+        const QPointF c(box.left() + 6.0 + iconWidth / 2.0, cy);
+        p.setBrush(Qt::NoBrush);
+        switch (e.kind) {
+        case LegendEntry::Circle:
+            p.setPen(QPen(e.color, 1));
+            p.drawEllipse(c, 3.0, 3.0);
+            break;
+        case LegendEntry::Triangle: {
+            p.setPen(QPen(e.color, 1));
+            const QPointF tri[3] = { c + QPointF(0.0, -3.45), c + QPointF(3.0, 1.74), c + QPointF(-3.0, 1.74) };
+            p.drawPolygon(tri, 3);
+            break;
+        }
+        case LegendEntry::Line:
+            p.setPen(QPen(e.color, 2));
+            p.drawLine(QPointF(c.x() - iconWidth / 2.0, cy), QPointF(c.x() + iconWidth / 2.0, cy));
+            break;
+        case LegendEntry::Band: {
+            QColor fill = e.color;
+            fill.setAlpha(40);
+            p.setPen(QPen(e.color.lighter(140), 1, Qt::DashLine));
+            p.setBrush(fill);
+            p.drawRect(QRectF(c.x() - iconWidth / 2.0, cy - 4.0, iconWidth, 8.0));
+            break;
+        }
+        }
+        p.setPen(Qt::black);
+        p.drawText(QRectF(box.left() + iconWidth + 12.0, cy - rowHeight / 2.0, textWidth + 4.0, rowHeight),
+                   Qt::AlignLeft | Qt::AlignVCenter, e.text);
+    }
+}
+
+// HTML 样式与标题
+void writeHead(QTextStream& out)
+{
+    out << "<html><head><meta charset='utf-8'><style>"
+        << "body { font-family: 'Times New Roman', 'SimSun', serif; }"
+        << "h1 { text-align: center; font-size: 24px; font-weight: bold; margin-bottom: 20px; }"
+        << "h2 { font-size: 18px; font-weight: bold; background-color: #f2f2f2; padding: 5px; border-left: 5px solid #2d89ef; margin-top: 20px; }"
+        << "h3 { font-size: 16px; font-weight: bold; border-bottom: 1px solid #2d89ef; margin-top: 16px; }"
+        << "table { width: 100%; border-collapse: collapse; margin-bottom: 15px; font-size: 14px; }"
+        << "td, th { border: 1px solid #888; padding: 6px; text-align: center; }"
+        << "th { background-color: #e0e0e0; font-weight: bold; }"
+        << ".param-table td { text-align: left; padding-left: 10px; }"
+        << "</style></head><body>";
+    out << "<h1>试井解释分析报告</h1>";
+    out << "<p style='text-align:right;'>生成日期: " << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm") << "</p>";
+}
+
+void writeProject(QTextStream& out, const ReportProjectInfo& mp)
+{
+    out << "<h2>1. 基础信息</h2>";
+    out << "<table class='param-table'>";
+    out << "<tr><td width='30%'>项目路径</td><td>" << mp.projectPath.toHtmlEscaped() << "</td></tr>";
+    out << "<tr><td>测试产量 (q)</td><td>" << QString::number(mp.q) << " m³/d</td></tr>";
+    out << "<tr><td>有效厚度 (h)</td><td>" << QString::number(mp.h) << " m</td></tr>";
+    out << "<tr><td>孔隙度 (φ)</td><td>" << QString::number(mp.phi) << "</td></tr>";
+    out << "<tr><td>井筒半径 (rw)</td><td>" << QString::number(mp.rw) << " m</td></tr>";
+    out << "</table>";
+
+    out << "<h2>2. 流体高压物性 (PVT)</h2>";
+    out << "<table class='param-table'>";
+    out << "<tr><td width='30%'>原油粘度 (μ)</td><td>" << QString::number(mp.mu) << " mPa·s</td></tr>";
+    out << "<tr><td>体积系数 (B)</td><td>" << QString::number(mp.B) << "</td></tr>";
+    out << "<tr><td>综合压缩系数 (Ct)</td><td>" << QString::number(mp.Ct) << " MPa⁻¹</td></tr>";
+    out << "</table>";
+}
+
+// 一个分析页的模型、参数与不确定性表格 (曲线图由调用方在图片就绪后写入)
+void writeAnalysisTables(QTextStream& out, const ReportAnalysis& a, const std::function<void(const QString&)>& heading)
+{
+    heading("解释模型选择");
+    out << "<p><strong>当前模型:</strong> " << ModelManager::getModelTypeName(a.modelType) << "</p>";
+    if (a.rateStages > 0)
+        out << QString("<p><strong>产量历史:</strong> 变产量叠加计算，共 %1 个产量阶段</p>").arg(a.rateStages);
+
+    heading("拟合结果参数");
+    out << "<table>";
+    out << "<tr><th>参数名称</th><th>符号</th><th>拟合结果</th><th>单位</th></tr>";
+    for (const ReportParameterRow& row : a.parameters) {
+        out << "<tr><td>" << row.displayName << "</td><td>" << row.symbol << "</td>";
+        if (row.isFit) out << "<td><strong>" << QString::number(row.value, 'g', 6) << "</strong></td>";
+        else out << "<td>" << QString::number(row.value, 'g', 6) << "</td>";
+        out << "<td>" << row.unit << "</td></tr>";
+    }
+    out << "</table>";
+
+    if (!a.uncertainty.valid) return;
+    const UncertaintyResult& u = a.uncertainty;
+    heading("参数不确定性分析");
+    out << QString("<p>置信度 %1%，残差方差 s² = %2 (自由度 %3)；曲线置信带由 %4 组参数抽样得到，"
+                   "参数区间另由 %5 次残差自助法重拟合给出。</p>")
+               .arg(u.confidence * 100.0, 0, 'g', 3).arg(u.sigma2, 0, 'e', 3).arg(u.dof)
+               .arg(u.drawsUsed).arg(u.bootstrapUsed);
+    out << "<table>";
+    out << "<tr><th>参数名称</th><th>拟合结果</th><th>标准误差</th><th>线性化区间</th><th>自助法区间</th></tr>";
+    for (const ParameterInterval& iv : u.intervals) {
+        QString displayName, symbol, uniSym, unit;
+        FittingParameterChart::getParamDisplayInfo(ParameterSchema::nameOf(iv.id), displayName, symbol, uniSym, unit);
+        QString se = iv.logScale ? QString("%1 (log10)").arg(iv.stdError, 0, 'g', 3) : QString::number(iv.stdError, 'g', 3);
+        out << "<tr><td>" << displayName << "</td><td>" << QString::number(iv.value, 'g', 6) << "</td><td>" << se << "</td>";
+        out << QString("<td>[%1, %2]</td>").arg(iv.linearLower, 0, 'g', 4).arg(iv.linearUpper, 0, 'g', 4);
+        out << QString("<td>[%1, %2]</td></tr>").arg(iv.bootstrapLower, 0, 'g', 4).arg(iv.bootstrapUpper, 0, 'g', 4);
+    }
+    out << "</table>";
+}
+}
+
+// ========================= 报告内容 =========================
+
+ReportProjectInfo ReportProjectInfo::fromModelParameter()
+{
+    ModelParameter* mp = ModelParameter::instance();
+    ReportProjectInfo info;
+    info.projectPath = mp->getProjectPath();
+    info.q = mp->getQ();
+    info.h = mp->getH();
+    info.phi = mp->getPhi();
+    info.rw = mp->getRw();
+    info.mu = mp->getMu();
+    info.B = mp->getB();
+    info.Ct = mp->getCt();
+    return info;
+}
+
+void ReportAnalysis::addParameter(const QString& name, const QString& displayName, double value, bool isFit)
+{
+    ReportParameterRow row;
+    QString defaultName, symbol;
+    FittingParameterChart::getParamDisplayInfo(name, defaultName, symbol, row.symbol, row.unit);
+    if (row.unit == "无因次" || row.unit == "小数") row.unit = "-";
+    row.displayName = displayName.isEmpty() ? defaultName : displayName;
+    row.value = value;
+    row.isFit = isFit;
+    parameters.append(row);
+}
+
+// ========================= 绘图 =========================
+
+QImage ReportGenerator::renderPlot(const ReportAnalysis& a, const QSize& size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setRenderHint(QPainter::TextAntialiasing);
+
+    const QFont titleFont("SimHei", 14, QFont::Bold);
+    const QFont labelFont("Arial", 12, QFont::Bold);
+    const QFont tickFont("Arial", 12);
+    const QFontMetricsF titleMetrics(titleFont, &image);
+    const QFontMetricsF labelMetrics(labelFont, &image);
+    const QFontMetricsF tickMetrics(tickFont, &image);
+
+    const QVector<double>& mt = std::get<0>(a.modelCurve);
+    const QVector<double>& mp = std::get<1>(a.modelCurve);
+    const QVector<double>& md = std::get<2>(a.modelCurve);
+    const UncertaintyResult& u = a.uncertainty;
+    const bool hasBand = u.valid && !u.bandTime.isEmpty();
+
+    // 坐标范围: 覆盖全部数据的整数量级 (无数据时与拟合界面的初始范围一致)
+    LogRange xr, yr;
+    xr.add(a.obsTime);
+    xr.add(mt);
+    yr.add(a.obsDeltaP);
+    yr.add(a.obsDerivative);
+    yr.add(mp);
+    yr.add(md);
+    if (hasBand) {
+        xr.add(u.bandTime);
+        yr.add(u.pressureLower);
+        yr.add(u.pressureUpper);
+        yr.add(u.derivativeLower);
+        yr.add(u.derivativeUpper);
+    }
+
+    LogAxes axes;
+    decadeBounds(xr, -3, 3, axes.x0, axes.x1);
+    decadeBounds(yr, -3, 2, axes.y0, axes.y1);
+
+    const double tickLabelWidth = tickMetrics.horizontalAdvance("10") + 0.7 * tickMetrics.horizontalAdvance("-00");
+    const double tickLabelHeight = tickMetrics.height() * 1.3;
+    const double left = labelMetrics.height() + tickLabelWidth + 24.0;
+    const double top = titleMetrics.height() + 20.0;
+    const double bottom = labelMetrics.height() + tickLabelHeight + 20.0;
+    axes.rect = QRectF(left, top, size.width() - left - 24.0, size.height() - top - bottom);
+    const QRectF& rect = axes.rect;
+
+    // 标题
+    p.setPen(Qt::black);
+    p.setFont(titleFont);
+    const QString title = a.name.isEmpty() ? QString("试井解释拟合") : QString("试井解释拟合 - %1").arg(a.name);
+    p.drawText(QRectF(0.0, 8.0, size.width(), titleMetrics.height()), Qt::AlignCenter, title);
+
+    // 网格: 整数量级为主网格，2~9 倍为次网格
+    const QPen gridPen(QColor(220, 220, 220), 1, Qt::SolidLine);
+    const QPen subGridPen(QColor(240, 240, 240), 1, Qt::DotLine);
+    p.setPen(subGridPen);
+    for (int e = axes.x0; e < axes.x1; ++e)
+        for (int k = 2; k <= 9; ++k) {
+            const double x = axes.mapX(e + std::log10(double(k)));
+            p.drawLine(QPointF(x, rect.top()), QPointF(x, rect.bottom()));
+        }
+    for (int e = axes.y0; e < axes.y1; ++e)
+        for (int k = 2; k <= 9; ++k) {
+            const double y = axes.mapY(e + std::log10(double(k)));
+            p.drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
+        }
+    p.setPen(gridPen);
+    for (int e = axes.x0 + 1; e < axes.x1; ++e)
+        p.drawLine(QPointF(axes.mapX(e), rect.top()), QPointF(axes.mapX(e), rect.bottom()));
+    for (int e = axes.y0 + 1; e < axes.y1; ++e)
+        p.drawLine(QPointF(rect.left(), axes.mapY(e)), QPointF(rect.right(), axes.mapY(e)));
+
+    // 数据 (裁剪到绘图区)
+    p.save();
+    p.setClipRect(rect);
+    if (hasBand) {
+        drawBand(p, axes, u.bandTime, u.pressureLower, u.pressureUpper, Qt::red);
+        drawBand(p, axes, u.bandTime, u.derivativeLower, u.derivativeUpper, Qt::blue);
+    }
+    drawScatter(p, axes, a.obsTime, a.obsDeltaP, false, QColor(0, 100, 0));
+    drawScatter(p, axes, a.obsTime, a.obsDerivative, true, Qt::magenta);
+    drawLine(p, axes, mt, mp, QPen(Qt::red, 2));
+    drawLine(p, axes, mt, md, QPen(Qt::blue, 2));
+    p.restore();
+
+    // 四边坐标轴与向内的刻度，刻度标签只标在下方与左侧
+    p.setPen(QPen(Qt::black, 1));
+    p.setBrush(Qt::NoBrush);
+    p.drawRect(rect);
+    for (int e = axes.x0; e <= axes.x1; ++e)
+        for (int k = 1; k <= (e < axes.x1 ? 9 : 1); ++k) {
+            const double x = axes.mapX(e + std::log10(double(k)));
+            const double len = (k == 1) ? 5.0 : 2.0;
+            p.drawLine(QPointF(x, rect.bottom()), QPointF(x, rect.bottom() - len));
+            p.drawLine(QPointF(x, rect.top()), QPointF(x, rect.top() + len));
+        }
+    for (int e = axes.y0; e <= axes.y1; ++e)
+        for (int k = 1; k <= (e < axes.y1 ? 9 : 1); ++k) {
+            const double y = axes.mapY(e + std::log10(double(k)));
+            const double len = (k == 1) ? 5.0 : 2.0;
+            p.drawLine(QPointF(rect.left(), y), QPointF(rect.left() + len, y));
+            p.drawLine(QPointF(rect.right(), y), QPointF(rect.right() - len, y));
+        }
+
+    // 量级过多时隔几个量级标注一次
+    const int xStep = qMax(1, (axes.x1 - axes.x0 + 9) / 10);
+    const int yStep = qMax(1, (axes.y1 - axes.y0 + 9) / 10);
+    for (int e = axes.x0; e <= axes.x1; e += xStep)
+        drawPowerLabel(p, tickFont, QPointF(axes.mapX(e), rect.bottom() + 6.0), e, Qt::AlignHCenter | Qt::AlignTop);
+    for (int e = axes.y0; e <= axes.y1; e += yStep)
+        drawPowerLabel(p, tickFont, QPointF(rect.left() - 6.0, axes.mapY(e)), e, Qt::AlignRight | Qt::AlignVCenter);
+
+    // 坐标轴标题
+    p.setPen(Qt::black);
+    p.setFont(labelFont);
+    p.drawText(QRectF(rect.left(), rect.bottom() + tickLabelHeight + 8.0, rect.width(), labelMetrics.height()),
+               Qt::AlignCenter, "时间 Time (h)");
+    p.save();
+    p.translate(8.0, rect.center().y());
+    p.rotate(-90.0);
+    p.drawText(QRectF(-rect.height() / 2.0, 0.0, rect.height(), labelMetrics.height()),
+               Qt::AlignCenter, "压差 & 导数 Delta P & Derivative (MPa)");
+    p.restore();
+
+    // 图例
+    QList<LegendEntry> legend;
+    if (hasPositive(a.obsTime, a.obsDeltaP)) legend.append({LegendEntry::Circle, QColor(0, 100, 0), "实测压差"});
+    if (hasPositive(a.obsTime, a.obsDerivative)) legend.append({LegendEntry::Triangle, Qt::magenta, "实测导数"});
+    if (hasPositive(mt, mp)) legend.append({LegendEntry::Line, Qt::red, "理论压差"});
+    if (hasPositive(mt, md)) legend.append({LegendEntry::Line, Qt::blue, "理论导数"});
+    if (hasBand) {
+        const QString level = QString::number(u.confidence * 100.0, 'g', 3);
+        legend.append({LegendEntry::Band, Qt::red, QString("压差 %1% 置信带").arg(level)});
+        legend.append({LegendEntry::Band, Qt::blue, QString("导数 %1% 置信带").arg(level)});
+    }
+    drawLegend(p, rect, legend);
+
+    p.end();
+    return image;
+}
+
+QByteArray ReportGenerator::encodePlot(const ReportAnalysis& analysis, const QSize& size)
+{
+    const QImage image = renderPlot(analysis, size);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "PNG")) return QByteArray();
+    return png.toBase64();
+}
+
+void ReportGenerator::ensureModelCurve(ReportAnalysis& a)
+{
+    if (!std::get<0>(a.modelCurve).isEmpty()) return;
+
+    // 时间点与 FittingWidget::updateModelCurve 一致
+    QVector<double> t = a.obsTime;
+    if (t.isEmpty()) {
+        for (double e = -4; e <= 4; e += 0.1) t.append(std::pow(10, e));
+    }
+    if (a.rateStages > 0) {
+        RateSuperposition op(a.rateHistory, t);
+        if (op.isValid()) {
+            ModelCurveData unit = ModelSolver01_06::calculateTheoreticalCurve(a.modelType, op.unitParams(a.params), op.unitTime(), true);
+            a.modelCurve = op.apply(unit, a.params);
+            return;
+        }
+    }
+    a.modelCurve = ModelSolver01_06::calculateTheoreticalCurve(a.modelType, a.params, t, true);
+}
+
+// ========================= 报告文件 =========================
+
+bool ReportGenerator::write(const QString& fileName, const ReportProjectInfo& project,
+                            const QList<ReportAnalysis>& analyses, QString* error)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    // 本函数自身可能运行在全局线程池中，绘图使用专用线程池，避免与调用方争用同一线程池而互相等待
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    QFuture<QByteArray> images = QtConcurrent::mapped(&pool, analyses, [](const ReportAnalysis& analysis) {
+        ReportAnalysis a = analysis;
+        ensureModelCurve(a);
+        return encodePlot(a, PlotSize);
+    });
+
+    QTextStream out(&file);
+    out.setEncoding(QStringConverter::Utf8);
+    writeHead(out);
+    writeProject(out, project);
+
+    // 只有一个分析页时各部分为独立章节 (与单页报告一致)，否则每个分析页一章、各部分为小节
+    const bool single = (analyses.size() == 1);
+    int section = 3;
+    for (int i = 0; i < analyses.size(); ++i) {
+        const ReportAnalysis& a = analyses[i];
+        const int chapter = section;
+        int sub = 1;
+        if (!single) out << "<h2>" << section++ << ". 分析页: " << a.name.toHtmlEscaped() << "</h2>";
+        auto heading = [&](const QString& title) {
+            if (single) out << "<h2>" << section++ << ". " << title << "</h2>";
+            else out << "<h3>" << chapter << '.' << sub++ << ' ' << title << "</h3>";
+        };
+
+        writeAnalysisTables(out, a, heading);
+        heading("拟合曲线图");
+        // 等待本页图片，后续各页的图片仍在后台绘制
+        const QByteArray png = images.resultAt(i);
+        if (!png.isEmpty()) out << "<div style='text-align:center;'><img src='data:image/png;base64," << png << "' width='600' /></div>";
+        else out << "<p>图像导出失败。</p>";
+        out.flush();
+    }
+    out << "</body></html>";
+    out.flush();
+
+    if (out.status() != QTextStream::Ok || !file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QFuture<QString> ReportGenerator::writeAsync(const QString& fileName, const ReportProjectInfo& project,
+                                             const QList<ReportAnalysis>& analyses)
+{
+    return QtConcurrent::run([fileName, project, analyses]() {
+        QString error;
+        if (!write(fileName, project, analyses, &error) && error.isEmpty()) error = "未知错误";
+        return error;
+    });
+}
+
+ReportAnalysis ReportGenerator::fromJsonState(const QJsonObject& state, const QString& name)
+{
+    ReportAnalysis a;
+    a.name = name;
+    a.modelType = static_cast<ModelType>(state["modelType"].toInt());
+
+    QList<FitParameter> params;
+    for (const QJsonValue& v : state["parameters"].toArray()) {
+        const QJsonObject pObj = v.toObject();
+        FitParameter p;
+        p.name = pObj["name"].toString();
+        p.value = pObj["value"].toDouble();
+        p.min = pObj["min"].toDouble();
+        p.max = pObj["max"].toDouble();
+        p.isFit = pObj["isFit"].toBool();
+        p.isVisible = pObj["isVisible"].toBool(true);
+        a.addParameter(p.name, QString(), p.value, p.isFit);
+        params.append(p);
+    }
+    // 派生参数与 FittingWidget::reportSnapshot 相同
+    a.params = FittingParameterChart::compileParameters(a.modelType, params).values;
+
+    const QJsonObject obs = state["observedData"].toObject();
+    for (const QJsonValue& v : obs["time"].toArray()) a.obsTime.append(v.toDouble());
+    for (const QJsonValue& v : obs["pressure"].toArray()) a.obsDeltaP.append(v.toDouble());
+    for (const QJsonValue& v : obs["derivative"].toArray()) a.obsDerivative.append(v.toDouble());
+
+    if (state.contains("rateHistory")) {
+        const QJsonObject rateObj = state["rateHistory"].toObject();
+        RateHistory history;
+        for (const QJsonValue& v : rateObj["startTime"].toArray()) history.startTime.append(v.toDouble());
+        for (const QJsonValue& v : rateObj["rate"].toArray()) history.rate.append(v.toDouble());
+        // 与 FittingWidget::setRateHistory 相同的启用条件
+        if (history.startTime.size() == history.rate.size() && !history.isEmpty() && !a.obsTime.isEmpty()
+            && RateSuperposition(history, a.obsTime).isValid()) {
+            a.rateHistory = history;
+            a.rateStages = history.size();
+        }
+    }
+    return a;
+}
+
+int ReportGenerator::runCli(const QStringList& args)
+{
+    QTextStream out(stdout);
+    QString projectFile, outFile;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--report" && i + 2 < args.size()) {
+            projectFile = args[i + 1];
+            outFile = args[i + 2];
+            i += 2;
+        }
+    }
+    if (projectFile.isEmpty() || outFile.isEmpty()) {
+        out << "用法: WellTest --report <项目文件.pwt> <输出文件.html|.doc>\n";
+        return 1;
+    }
+
+    ModelParameter* mp = ModelParameter::instance();
+    if (!mp->loadProject(projectFile)) {
+        out << "无法读取项目文件: " << projectFile << "\n";
+        return 2;
+    }
+
+    // 与 FittingPage::loadAllFittingStates 相同的保存格式
+    const QJsonObject root = mp->getFittingResult();
+    QList<ReportAnalysis> analyses;
+    if (root.contains("analyses") && root["analyses"].isArray()) {
+        const QJsonArray arr = root["analyses"].toArray();
+        for (int i = 0; i < arr.size(); ++i) {
+            const QJsonObject pageObj = arr[i].toObject();
+            const QString name = pageObj.contains("_tabName") ? pageObj["_tabName"].toString() : QString("Analysis %1").arg(i + 1);
+            analyses.append(fromJsonState(pageObj, name));
+        }
+    } else if (!root.isEmpty()) {
+        analyses.append(fromJsonState(root, "Analysis 1"));
+    }
+    if (analyses.isEmpty()) {
+        out << "项目中没有保存的拟合分析\n";
+        return 3;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (!write(outFile, ReportProjectInfo::fromModelParameter(), analyses, &error)) {
+        out << "写入失败: " << outFile << " (" << error << ")\n";
+        return 4;
+    }
+    out << QString("报告已生成: %1 个分析页, 用时 %2 s -> %3\n")
+               .arg(analyses.size()).arg(timer.elapsed() / 1000.0, 0, 'f', 1).arg(outFile);
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * reportgenerator.h
+ * 文件作用: 试井分析报告生成头文件
+ * 功能描述:
+ * 1. 报告内容先在界面线程整理为值快照 (ReportProjectInfo / ReportAnalysis)，此后生成过程不再访问界面控件，
+ *    可整体放到工作线程执行，导出期间界面保持响应。
+ * 2. 拟合曲线图以 QPainter 直接绘制到 QImage (QCustomPlot 只能在界面线程使用)，
+ *    各分析页的绘图与 PNG/Base64 编码在线程池中并行进行，HTML 按章节顺序边生成边写入文件。
+ * 3. 支持单个分析页报告与 "全部分析页" 合并报告；命令行模式 (--report) 直接读取项目文件生成报告，不创建界面。
+ */
+
+#ifndef REPORTGENERATOR_H
+#define REPORTGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QImage>
+#include <QSize>
+#include <QFuture>
+#include <QJsonObject>
+
+#include "modelenums.h"
+#include "modelsolver01_06.h"
+#include "parameterschema.h"
+#include "ratesuperposition.h"
+#include "uncertaintyanalysis.h"
+
+// 项目基础信息与 PVT 参数 (取自 ModelParameter)
+struct ReportProjectInfo {
+    QString projectPath;
+    double q = 0.0;
+    double h = 0.0;
+    double phi = 0.0;
+    double rw = 0.0;
+    double mu = 0.0;
+    double B = 0.0;
+    double Ct = 0.0;
+
+    // 读取当前项目参数 (须在界面线程调用)
+    static ReportProjectInfo fromModelParameter();
+};
+
+// 拟合结果参数表的一行
+struct ReportParameterRow {
+    QString displayName;
+    QString symbol;         // 带上下标的 HTML 符号
+    QString unit;           // 无因次量显示为 "-"
+    double value = 0.0;
+    bool isFit = false;
+};
+
+// 一个分析页的报告内容
+struct ReportAnalysis {
+    QString name;                   // 分析页名称
+    ModelType modelType = Model_1;
+    int rateStages = 0;             // 变产量阶段数 (0 为定产量)
+    QList<ReportParameterRow> parameters;
+    UncertaintyResult uncertainty;
+
+    // 实测数据
+    QVector<double> obsTime;
+    QVector<double> obsDeltaP;
+    QVector<double> obsDerivative;
+
+    // 理论曲线 <t, Δp, 导数>；为空时由生成器按 params / rateHistory 计算 (命令行模式)
+    ModelCurveData modelCurve;
+    ParamVector params = ParameterSchema::defaults();
+    RateHistory rateHistory;
+
+    // 由参数名与取值生成参数表行 (displayName 为空时取默认中文名)
+    void addParameter(const QString& name, const QString& displayName, double value, bool isFit);
+};
+
+class ReportGenerator
+{
+public:
+    // 在 QImage 上绘制双对数拟合曲线图 (可在任意线程调用)
+    static QImage renderPlot(const ReportAnalysis& analysis, const QSize& size = QSize(800, 600));
+
+    // 生成报告并写入 fileName (HTML，Word 可直接打开 .doc)。
+    // 只有一个分析页时章节编号与单页报告一致，多个分析页时每页一章。失败时返回 false 并写入 error
+    static bool write(const QString& fileName, const ReportProjectInfo& project,
+                      const QList<ReportAnalysis>& analyses, QString* error = nullptr);
+
+    // 在后台线程执行 write()，结果为错误信息 (成功时为空)
+    static QFuture<QString> writeAsync(const QString& fileName, const ReportProjectInfo& project,
+                                       const QList<ReportAnalysis>& analyses);
+
+    // 由项目文件中保存的分析页状态 (FittingWidget::getJsonState) 重建报告内容，不计算理论曲线
+    static ReportAnalysis fromJsonState(const QJsonObject& state, const QString& name);
+
+    // 用法: WellTest --report <项目文件.pwt> <输出文件.html|.doc>
+    static int runCli(const QStringList& args);
+
+private:
+    // 理论曲线为空时按保存的参数计算 (高精度)
+    static void ensureModelCurve(ReportAnalysis& analysis);
+    // 绘图并编码为 Base64 PNG
+    static QByteArray encodePlot(const ReportAnalysis& analysis, const QSize& size);
+};
+
+#endif // REPORTGENERATOR_H
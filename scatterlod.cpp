@@ -0,0 +1,204 @@
+/*
+ * scatterlod.cpp
+ * 文件作用: 大数据量散点图的细节层次 (LOD) 抽稀实现文件
+ * 功能描述:
+ * 1. 抽稀按列进行: 数据已按 x 排序，同一列的点连续出现，每格取第一个出现的点 (以列序号标记已占用的行)，
+ *    最低、最高的格改取该列 y 的最小、最大点。
+ * 2. 粗层网格与细层嵌套 (原点相同、格宽加倍)，格号由细层格号右移得到，
+ *    在细层结果上抽稀与在原始数据上抽稀等价，建立金字塔只需一次对数运算。
+ */
+
+#include "scatterlod.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+ScatterLod::ScatterLod(const QVector<double>& x, const QVector<double>& y, bool logX, bool logY, double minValue)
+    : m_logX(logX)
+    , m_logY(logY)
+    , m_minValue(minValue)
+{
+    const int n = qMin(x.size(), y.size());
+    bool sorted = (x.size() == y.size());
+    for (int i = 1; i < n && sorted; ++i) sorted = !(x[i] < x[i - 1]);
+    if (sorted) {
+        // 已排序时与调用方共享数据
+        m_x = x;
+        m_y = y;
+    } else {
+        QVector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+        m_x.resize(n);
+        m_y.resize(n);
+        for (int i = 0; i < n; ++i) {
+            m_x[i] = x[order[i]];
+            m_y[i] = y[order[i]];
+        }
+    }
+
+    QVector<int> valid;
+    valid.reserve(n);
+    double uMin = std::numeric_limits<double>::max(), uMax = -uMin;
+    double vMin = uMin, vMax = -uMin;
+    for (int i = 0; i < n; ++i) {
+        if (!isValid(i)) continue;
+        valid.append(i);
+        double u = tx(m_x[i]), v = ty(m_y[i]);
+        uMin = qMin(uMin, u); uMax = qMax(uMax, u);
+        vMin = qMin(vMin, v); vMax = qMax(vMax, v);
+    }
+    if (valid.isEmpty()) return;
+    m_u0 = uMin;
+    m_uSpan = qMax(uMax - uMin, 1e-12);
+    m_v0 = vMin;
+    m_vSpan = qMax(vMax - vMin, 1e-12);
+
+    // 最细层的格号只计算一次，粗层格号由移位得到 (网格嵌套)，由细到粗逐层在上一层结果上抽稀
+    const int fine = 1 << MaxLevelBits;
+    QVector<int> src = valid;
+    QVector<int> fx(src.size()), fy(src.size());
+    for (int k = 0; k < src.size(); ++k) {
+        const int i = src[k];
+        fx[k] = qMin(fine - 1, int((tx(m_x[i]) - m_u0) / m_uSpan * fine));
+        fy[k] = qMin(fine - 1, int((ty(m_y[i]) - m_v0) / m_vSpan * fine));
+    }
+
+    QVector<QVector<int>> levels(MaxLevelBits - MinLevelBits + 1);
+    for (int bits = MaxLevelBits; bits >= MinLevelBits; --bits) {
+        QVector<int> pos = decimate(src, fx, fy, MaxLevelBits - bits, 1 << bits);
+        QVector<int> nsrc(pos.size()), nfx(pos.size()), nfy(pos.size());
+        for (int j = 0; j < pos.size(); ++j) {
+            nsrc[j] = src[pos[j]];
+            nfx[j] = fx[pos[j]];
+            nfy[j] = fy[pos[j]];
+        }
+        src = nsrc; fx = nfx; fy = nfy;
+        levels[bits - MinLevelBits] = src;
+    }
+    for (const QVector<int>& idx : levels) m_levels.append(makeContainer(idx));
+}
+
+bool ScatterLod::isValid(int i) const
+{
+    double x = m_x[i], y = m_y[i];
+    if (!std::isfinite(x) || !std::isfinite(y)) return false;
+    if (x <= m_minValue || y <= m_minValue) return false;
+    return (!m_logX || x > 0.0) && (!m_logY || y > 0.0);
+}
+
+int ScatterLod::levelSize(int level) const
+{
+    return (level >= 0 && level < m_levels.size()) ? m_levels[level]->size() : 0;
+}
+
+QVector<int> ScatterLod::decimate(const QVector<int>& src, const QVector<int>& cx, const QVector<int>& cy,
+                                  int shift, int rows) const
+{
+    const int m = src.size();
+    QVector<int> out;
+    QVector<int> stamp(rows, -1);   // 行在哪一列中已有代表点 (列序号)
+    QVector<int> slot(rows, 0);     // 代表点在 keep 中的位置
+    QVector<int> keep;
+    int k = 0;
+    for (int column = 0; k < m; ++column) {
+        const int col = cx[k] >> shift;
+        keep.clear();
+        int kMin = k, kMax = k;
+        for (; k < m && (cx[k] >> shift) == col; ++k) {
+            const int row = cy[k] >> shift;
+            if (stamp[row] != column) {
+                stamp[row] = column;
+                slot[row] = keep.size();
+                keep.append(k);
+            }
+            if (m_y[src[k]] < m_y[src[kMin]]) kMin = k;
+            if (m_y[src[k]] > m_y[src[kMax]]) kMax = k;
+        }
+
+        // 最低、最高格 (即极值点所在格) 的代表点换成极值点本身
+        const int rMin = cy[kMin] >> shift, rMax = cy[kMax] >> shift;
+        keep[slot[rMin]] = kMin;
+        if (rMax != rMin) keep[slot[rMax]] = kMax;
+        else if (kMax != kMin) keep.append(kMax);
+        // 首末点决定数据的 x 范围
+        if (out.isEmpty() && !keep.contains(0)) keep.append(0);
+        if (k == m && !keep.contains(m - 1)) keep.append(m - 1);
+
+        std::sort(keep.begin(), keep.end());
+        out += keep;
+    }
+    return out;
+}
+
+QSharedPointer<QCPGraphDataContainer> ScatterLod::makeContainer(const QVector<int>& idx) const
+{
+    QVector<QCPGraphData> data;
+    data.reserve(idx.size());
+    for (int i : idx) data.append(QCPGraphData(m_x[i], m_y[i]));
+    QSharedPointer<QCPGraphDataContainer> container(new QCPGraphDataContainer);
+    container->set(data, true);
+    return container;
+}
+
+QSharedPointer<QCPGraphDataContainer> ScatterLod::select(const QCPRange& keyRange, const QCPRange& valueRange,
+                                                         int widthPx, int heightPx, double cellPx, int* level)
+{
+    if (level) *level = -1;
+    if (m_levels.isEmpty()) return QSharedPointer<QCPGraphDataContainer>(new QCPGraphDataContainer);
+    if (widthPx <= 0 || heightPx <= 0) {
+        if (level) *level = m_levels.size() - 1;
+        return m_levels.last();
+    }
+
+    // 对数轴上的非正范围按全部数据范围处理
+    double ku0 = m_u0, ku1 = m_u0 + m_uSpan, kv0 = m_v0, kv1 = m_v0 + m_vSpan;
+    if (!m_logX || keyRange.lower > 0.0) { ku0 = tx(keyRange.lower); ku1 = tx(keyRange.upper); }
+    if (!m_logY || valueRange.lower > 0.0) { kv0 = ty(valueRange.lower); kv1 = ty(valueRange.upper); }
+
+    // 可见范围内每 cellPx 像素至少一格所需的层级
+    const int cols = qMax(1, int(widthPx / qMax(1.0, cellPx)));
+    const int rows = qMax(1, int(heightPx / qMax(1.0, cellPx)));
+    auto bitsFor = [](double visibleSpan, double fullSpan, int cells) {
+        if (!(visibleSpan > 0.0)) return MaxLevelBits + 1;
+        return (int)std::ceil(std::log2(qMax(1.0, cells * fullSpan / visibleSpan)));
+    };
+    int bits = qMax(MinLevelBits, qMax(bitsFor(ku1 - ku0, m_uSpan, cols), bitsFor(kv1 - kv0, m_vSpan, rows)));
+    if (bits <= MaxLevelBits) {
+        if (level) *level = bits - MinLevelBits;
+        return m_levels[bits - MinLevelBits];
+    }
+
+    // 超过最细层: 只对可见区间内的原始点按当前像素网格抽稀
+    if (m_cache && m_cacheKey == keyRange && m_cacheValue == valueRange && m_cacheW == widthPx && m_cacheH == heightPx)
+        return m_cache;
+
+    // 两侧各多取一个点，折线可连到视图之外
+    int b = int(std::lower_bound(m_x.constBegin(), m_x.constEnd(), keyRange.lower) - m_x.constBegin()) - 1;
+    int e = int(std::upper_bound(m_x.constBegin(), m_x.constEnd(), keyRange.upper) - m_x.constBegin()) + 1;
+    b = qMax(0, b);
+    e = qMin(m_x.size(), e);
+    // 视图外的点归入两侧的边界列、行 (格号 -1 与 cols / rows，整体平移 1 使其非负)
+    auto cellOf = [](double t, double t0, double dt, int count) {
+        return (int)qBound(-1.0, std::floor((t - t0) / dt), (double)count) + 1;
+    };
+    const double du = (ku1 - ku0) / cols, dv = (kv1 - kv0) / rows;
+    QVector<int> src, cx, cy;
+    src.reserve(qMax(0, e - b));
+    for (int i = b; i < e; ++i) {
+        if (!isValid(i)) continue;
+        src.append(i);
+        cx.append(cellOf(tx(m_x[i]), ku0, du, cols));
+        cy.append(cellOf(ty(m_y[i]), kv0, dv, rows));
+    }
+
+    QVector<int> pos = decimate(src, cx, cy, 0, rows + 2);
+    for (int& p : pos) p = src[p];
+    m_cache = makeContainer(pos);
+    m_cacheKey = keyRange;
+    m_cacheValue = valueRange;
+    m_cacheW = widthPx;
+    m_cacheH = heightPx;
+    return m_cache;
+}
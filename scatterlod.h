@@ -0,0 +1,81 @@
+/*
+ * scatterlod.h
+ * 文件作用: 大数据量散点图的细节层次 (LOD) 抽稀头文件
+ * 功能描述:
+ * 1. QCPGraph 的自适应采样只对线性键轴上的折线有效，双对数诊断图上的实测散点会逐点绘制符号，
+ *    百万点级的压力计数据每次重绘都很慢。这里按像素分桶抽稀: 同一像素格内的点绘制效果相同，只保留一个。
+ * 2. 分桶在坐标轴的显示空间中进行 (对数轴取 log10，线性轴取原值)，与屏幕像素一一对应。
+ * 3. 多分辨率金字塔: 数据加载时一次建立 2^6 ~ 2^13 格 (每轴) 的各层抽稀结果，
+ *    细层每 2×2 格合并为粗层一格，每层都保留每一列的 y 最大、最小点 (极值) 以及首末点，
+ *    因此任何一层的数据范围都与原始数据相同 (rescaleAxes 结果不变)，尖峰不会被抽掉。
+ * 4. 按可见范围与绘图区尺寸选择层级 (每 cellPx 像素至少一格，符号有数个像素大小，
+ *    取 2 像素一格与逐像素绘制看不出差别)；放大到超过最细层时，只对可见区间内的原始点临时抽稀。
+ * 5. 各层数据以共享容器形式交给 QCPGraph，切换层级不复制数据。
+ */
+
+#ifndef SCATTERLOD_H
+#define SCATTERLOD_H
+
+#include <QVector>
+#include <QSharedPointer>
+#include <cmath>
+#include <limits>
+
+#include "qcustomplot.h"
+
+class ScatterLod
+{
+public:
+    // 数据点数不超过此值时不必抽稀
+    static constexpr int MinPoints = 20000;
+    static constexpr int MinLevelBits = 6;
+    static constexpr int MaxLevelBits = 13;
+
+    // x、y 为原始数据 (可无序)；logX / logY 表示对应坐标轴为对数轴 (非正值不参与显示)；
+    // x、y 不大于 minValue 的点同样不参与显示 (见 PlotSeries 的过滤条件)
+    ScatterLod(const QVector<double>& x, const QVector<double>& y, bool logX, bool logY,
+               double minValue = -std::numeric_limits<double>::infinity());
+
+    bool logX() const { return m_logX; }
+    bool logY() const { return m_logY; }
+    double minValue() const { return m_minValue; }
+    int size() const { return m_x.size(); }
+    const QVector<double>& x() const { return m_x; }   // 按 x 升序
+    const QVector<double>& y() const { return m_y; }
+
+    int levelCount() const { return m_levels.size(); }
+    int levelSize(int level) const;
+
+    // 可见范围 (keyRange × valueRange) 与绘图区像素尺寸下应显示的数据；
+    // level 非空时返回所用层级 (-1 表示临时抽稀)
+    QSharedPointer<QCPGraphDataContainer> select(const QCPRange& keyRange, const QCPRange& valueRange,
+                                                 int widthPx, int heightPx, double cellPx = 2.0,
+                                                 int* level = nullptr);
+
+private:
+    // 显示空间坐标 (对数轴取 log10)
+    double tx(double v) const { return m_logX ? std::log10(v) : v; }
+    double ty(double v) const { return m_logY ? std::log10(v) : v; }
+    bool isValid(int i) const;
+
+    // 按格抽稀 src (按 x 升序的下标)，cx / cy 为各点所在列、行 (与 src 一一对应)，右移 shift 位后
+    // 行号在 [0, rows) 内；返回保留点在 src 中的位置 (升序)
+    QVector<int> decimate(const QVector<int>& src, const QVector<int>& cx, const QVector<int>& cy,
+                          int shift, int rows) const;
+
+    QSharedPointer<QCPGraphDataContainer> makeContainer(const QVector<int>& idx) const;
+
+    QVector<double> m_x, m_y;
+    bool m_logX, m_logY;
+    double m_minValue;
+    double m_u0 = 0.0, m_uSpan = 1.0;   // 全部有效点在显示空间中的范围
+    double m_v0 = 0.0, m_vSpan = 1.0;
+    QVector<QSharedPointer<QCPGraphDataContainer>> m_levels;   // 下标 0 为最粗层 (2^MinLevelBits 格)
+
+    // 临时抽稀结果缓存 (视图不变时直接复用)
+    QCPRange m_cacheKey, m_cacheValue;
+    int m_cacheW = 0, m_cacheH = 0;
+    QSharedPointer<QCPGraphDataContainer> m_cache;
+};
+
+#endif // SCATTERLOD_H
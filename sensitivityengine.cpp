@@ -0,0 +1,245 @@
+/*
+ * sensitivityengine.cpp
+ * 文件作用: 异步并行敏感性分析引擎实现文件
+ * 功能描述:
+ * 1. 工况生成 (网格组合 / 单因素) 与 LfD 等派生参数的重新计算。
+ * 2. 基于 QtConcurrent::mapped 的并行计算，结果按完成顺序逐条写入结果表。
+ * 3. 结果表的龙卷风图统计与宽表导出 (经 NumericExport 并行格式化)。
+ */
+
+#include "sensitivityengine.h"
+#include "parameterschema.h"
+
+#include <QtConcurrent>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+
+// ===========================================================================
+// SensitivityResultTable
+// ===========================================================================
+
+void SensitivityResultTable::reset(const QVector<double>& t, const QVector<SensitivityCase>& cases)
+{
+    m_time = t;
+    m_cases = cases;
+    m_pressure = QVector<double>(cases.size() * t.size(), 0.0);
+    m_derivative = QVector<double>(cases.size() * t.size(), 0.0);
+    m_done = QVector<char>(cases.size(), 0);
+    m_completed = 0;
+}
+
+void SensitivityResultTable::setCurve(int caseIndex, const QVector<double>& p, const QVector<double>& d)
+{
+    const int n = m_time.size();
+    if (caseIndex < 0 || caseIndex >= m_cases.size() || p.size() != n || d.size() != n) return;
+    std::copy(p.constBegin(), p.constEnd(), m_pressure.begin() + caseIndex * n);
+    std::copy(d.constBegin(), d.constEnd(), m_derivative.begin() + caseIndex * n);
+    if (!m_done[caseIndex]) {
+        m_done[caseIndex] = 1;
+        m_completed++;
+    }
+}
+
+QVector<TornadoEntry> SensitivityResultTable::tornado() const
+{
+    QVector<TornadoEntry> entries;
+    const int n = m_time.size();
+    if (n == 0 || !isComplete(0)) return entries;
+    double pBase = pressure(0)[n - 1];
+    if (pBase <= 1e-30) return entries;
+
+    QMap<QString, int> entryIndex;
+    for (int c = 1; c < m_cases.size(); ++c) {
+        if (!isComplete(c) || m_cases[c].varied.size() != 1) continue;
+        QString name = m_cases[c].varied.firstKey();
+        double value = m_cases[c].varied.first();
+        double change = pressure(c)[n - 1] / pBase - 1.0;
+
+        auto it = entryIndex.find(name);
+        if (it == entryIndex.end()) {
+            entryIndex.insert(name, entries.size());
+            entries.append(TornadoEntry{name, value, value, change, change});
+            continue;
+        }
+        TornadoEntry& e = entries[it.value()];
+        if (change < e.lowChange) { e.lowChange = change; e.lowValue = value; }
+        if (change > e.highChange) { e.highChange = change; e.highValue = value; }
+    }
+
+    // 以 0 为基准: 只有单侧变化时另一侧取 0
+    for (TornadoEntry& e : entries) {
+        e.lowChange = qMin(e.lowChange, 0.0);
+        e.highChange = qMax(e.highChange, 0.0);
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const TornadoEntry& a, const TornadoEntry& b) {
+        return (a.highChange - a.lowChange) > (b.highChange - b.lowChange);
+    });
+    return entries;
+}
+
+bool SensitivityResultTable::write(const QString& fileName, NumericExport::Format format, QString* error) const
+{
+    QVector<NumericExport::Column> columns;
+    columns.append({"t", m_time.constData()});
+    // 单条曲线保持原有的 t,Dp,dDp 格式；多工况时列名带工况标签
+    for (int c = 0; c < m_cases.size(); ++c) {
+        if (!isComplete(c)) continue;
+        if (m_cases.size() == 1) {
+            columns.append({"Dp", pressure(c)});
+            columns.append({"dDp", derivative(c)});
+        } else {
+            columns.append({QString("Dp[%1]").arg(m_cases[c].label), pressure(c)});
+            columns.append({QString("dDp[%1]").arg(m_cases[c].label), derivative(c)});
+        }
+    }
+    return NumericExport::write(fileName, format, columns, m_time.size(), error);
+}
+
+// ===========================================================================
+// SensitivityEngine
+// ===========================================================================
+
+namespace {
+
+QString formatCaseLabel(const QMap<QString, double>& varied)
+{
+    QStringList parts;
+    for (auto it = varied.constBegin(); it != varied.constEnd(); ++it) {
+        parts << QString("%1=%2").arg(it.key()).arg(it.value(), 0, 'g', 6);
+    }
+    return parts.join(", ");
+}
+
+SensitivityCase makeCase(const QMap<QString, double>& baseParams, const QMap<QString, double>& varied)
+{
+    SensitivityCase c;
+    c.varied = varied;
+    c.params = baseParams;
+    // 逐个写入变化的参数: 修改 L 或 Lf 时重新计算 LfD，修改 LfD 时同步 Lf
+    for (auto it = varied.constBegin(); it != varied.constEnd(); ++it) ParameterSchema::setMapValue(c.params, it.key(), it.value());
+    c.label = varied.isEmpty() ? QString("基准") : formatCaseLabel(varied);
+    return c;
+}
+
+} // namespace
+
+SensitivityEngine::SensitivityEngine(QObject* parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<CaseResult>::resultReadyAt, this, &SensitivityEngine::onResultReady);
+    connect(&m_watcher, &QFutureWatcher<CaseResult>::finished, this, &SensitivityEngine::onFinished);
+}
+
+SensitivityEngine::~SensitivityEngine()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+QVector<SensitivityCase> SensitivityEngine::buildCases(StudyMode mode,
+                                                       const QMap<QString, double>& baseParams,
+                                                       const QMap<QString, QVector<double>>& variations,
+                                                       int maxCases,
+                                                       bool* truncated)
+{
+    QVector<SensitivityCase> cases;
+    if (truncated) *truncated = false;
+
+    QStringList names;
+    for (auto it = variations.constBegin(); it != variations.constEnd(); ++it) {
+        if (!it.value().isEmpty()) names << it.key();
+    }
+    if (names.isEmpty()) {
+        SensitivityCase c = makeCase(baseParams, QMap<QString, double>());
+        c.label = "理论曲线";
+        cases.append(c);
+        return cases;
+    }
+
+    if (mode == Study_Tornado) {
+        // 基准工况 + 每次只改变一个参数 (与基准值相同的取值跳过)
+        cases.append(makeCase(baseParams, QMap<QString, double>()));
+        for (const QString& name : names) {
+            for (double v : variations[name]) {
+                if (v == baseParams.value(name)) continue;
+                if (cases.size() >= maxCases) {
+                    if (truncated) *truncated = true;
+                    return cases;
+                }
+                QMap<QString, double> varied;
+                varied.insert(name, v);
+                cases.append(makeCase(baseParams, varied));
+            }
+        }
+        return cases;
+    }
+
+    // 全组合: 按参数名顺序做计数器遍历，末位变化最快
+    QVector<int> counter(names.size(), 0);
+    while (true) {
+        if (cases.size() >= maxCases) {
+            if (truncated) *truncated = true;
+            break;
+        }
+        QMap<QString, double> varied;
+        for (int a = 0; a < names.size(); ++a) varied.insert(names[a], variations[names[a]][counter[a]]);
+        cases.append(makeCase(baseParams, varied));
+
+        int a = names.size() - 1;
+        while (a >= 0 && ++counter[a] >= variations[names[a]].size()) { counter[a] = 0; --a; }
+        if (a < 0) break;
+    }
+    return cases;
+}
+
+void SensitivityEngine::start(ModelType type, const QVector<SensitivityCase>& cases,
+                              const QVector<double>& t, bool highPrecision)
+{
+    if (m_watcher.isRunning()) {
+        cancel();
+        m_watcher.waitForFinished();
+    }
+
+    m_results.reset(t, cases);
+    m_cancelToken = CancellationToken::create();
+
+    // 参数表在启动前一次性转为稠密向量，工作线程只读
+    QVector<ParamVector> vectors;
+    vectors.reserve(cases.size());
+    for (const SensitivityCase& c : cases) vectors.append(ParameterSchema::fromMap(c.params));
+
+    QVector<int> indices(cases.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    CancellationToken cancel = m_cancelToken;
+    m_watcher.setFuture(QtConcurrent::mapped(indices, [type, vectors, t, highPrecision, cancel](int i) {
+        CaseResult r;
+        r.caseIndex = i;
+        ModelCurveData curve = ModelSolver01_06::calculateTheoreticalCurve(type, vectors[i], t, highPrecision, cancel);
+        r.pressure = std::get<1>(curve);
+        r.derivative = std::get<2>(curve);
+        return r;
+    }));
+}
+
+void SensitivityEngine::cancel()
+{
+    m_cancelToken.cancel();
+    m_watcher.cancel();
+}
+
+void SensitivityEngine::onResultReady(int index)
+{
+    CaseResult r = m_watcher.resultAt(index);
+    // 被取消的工况返回空结果，不写入结果表
+    if (r.pressure.size() != m_results.pointCount()) return;
+    m_results.setCurve(r.caseIndex, r.pressure, r.derivative);
+    emit curveReady(r.caseIndex);
+    emit progress(m_results.completedCount(), m_results.caseCount());
+}
+
+void SensitivityEngine::onFinished()
+{
+    emit finished(m_cancelToken.isCancelled());
+}
@@ -0,0 +1,133 @@
+/*
+ * sensitivityengine.h
+ * 文件作用: 模型界面的异步并行敏感性分析引擎头文件
+ * 功能描述:
+ * 1. 由基准参数与若干"变化参数"(每个参数一组取值) 生成计算工况:
+ *    - 网格组合: 各变化参数取值的全组合 (笛卡尔积)；
+ *    - 单因素 (龙卷风图): 基准工况 + 每次只改变一个参数的工况。
+ * 2. 各工况在线程池中并行计算 (QtConcurrent::mapped)，每完成一条曲线即发出 curveReady，
+ *    界面可边算边画，计算期间界面保持响应；cancel() 通过取消令牌使求解器在当前时间点后返回。
+ * 3. 计算结果保存在紧凑的结果表 SensitivityResultTable 中:
+ *    时间列只存一份，各工况的压差与导数按行连续存放，可整体导出为宽表 (CSV / TSV / 二进制)。
+ * 4. 单因素分析额外给出各参数对末时刻压差的相对影响排序 (龙卷风图数据)。
+ */
+
+#ifndef SENSITIVITYENGINE_H
+#define SENSITIVITYENGINE_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QFutureWatcher>
+
+#include "modelenums.h"
+#include "modelsolver01_06.h"
+#include "cancellationtoken.h"
+#include "numericexport.h"
+
+// 一个计算工况
+struct SensitivityCase {
+    QString label;                  // 图例名称，如 "kf=0.001, L=800" (基准工况为 "基准")
+    QMap<QString, double> varied;   // 本工况中偏离基准值的参数
+    QMap<QString, double> params;   // 完整参数表 (已重新计算 LfD)
+};
+
+// 龙卷风图的一行: 某参数在其取值范围内引起的末时刻压差相对变化
+struct TornadoEntry {
+    QString name;
+    double lowValue;        // 引起最小变化的参数取值
+    double highValue;       // 引起最大变化的参数取值
+    double lowChange;       // 相对基准的最小变化 (Δp/Δp基准 - 1)
+    double highChange;      // 相对基准的最大变化
+};
+
+// 紧凑的敏感性结果表
+class SensitivityResultTable
+{
+public:
+    void reset(const QVector<double>& t, const QVector<SensitivityCase>& cases);
+
+    void setCurve(int caseIndex, const QVector<double>& p, const QVector<double>& d);
+
+    int caseCount() const { return m_cases.size(); }
+    int pointCount() const { return m_time.size(); }
+    int completedCount() const { return m_completed; }
+    bool isComplete(int caseIndex) const { return m_done.value(caseIndex, 0) != 0; }
+
+    const QVector<double>& time() const { return m_time; }
+    const SensitivityCase& caseAt(int caseIndex) const { return m_cases[caseIndex]; }
+    const double* pressure(int caseIndex) const { return m_pressure.constData() + caseIndex * m_time.size(); }
+    const double* derivative(int caseIndex) const { return m_derivative.constData() + caseIndex * m_time.size(); }
+
+    // 以第 0 个工况为基准计算龙卷风图数据 (按影响幅度降序)，仅对单因素工况有意义
+    QVector<TornadoEntry> tornado() const;
+
+    // 导出宽表: 首列时间，其后每个已完成工况各占压差、导数两列 (各列直接引用结果表数据，不复制)
+    bool write(const QString& fileName, NumericExport::Format format, QString* error = nullptr) const;
+
+private:
+    QVector<double> m_time;
+    QVector<SensitivityCase> m_cases;
+    QVector<double> m_pressure;     // caseCount × pointCount，按工况连续存放
+    QVector<double> m_derivative;
+    QVector<char> m_done;
+    int m_completed = 0;
+};
+
+class SensitivityEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum StudyMode {
+        Study_Grid = 0,     // 全组合网格
+        Study_Tornado = 1   // 单因素 (龙卷风图)
+    };
+
+    // 单个工况批次的上限，防止多参数全组合时工况数爆炸
+    static constexpr int MaxCases = 400;
+
+    explicit SensitivityEngine(QObject* parent = nullptr);
+    ~SensitivityEngine();
+
+    // 生成工况。variations 中每个参数给出一组取值 (单值参数不必列出)；
+    // 工况数超过 maxCases 时截断，truncated 非空时返回是否发生截断
+    static QVector<SensitivityCase> buildCases(StudyMode mode,
+                                               const QMap<QString, double>& baseParams,
+                                               const QMap<QString, QVector<double>>& variations,
+                                               int maxCases = MaxCases,
+                                               bool* truncated = nullptr);
+
+    // 启动异步计算；若上一批仍在计算则先取消
+    void start(ModelType type, const QVector<SensitivityCase>& cases,
+               const QVector<double>& t, bool highPrecision);
+    void cancel();
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+    const SensitivityResultTable& results() const { return m_results; }
+
+signals:
+    // 第 caseIndex 个工况已写入结果表 (在界面线程中发出)
+    void curveReady(int caseIndex);
+    void progress(int done, int total);
+    void finished(bool cancelled);
+
+private slots:
+    void onResultReady(int index);
+    void onFinished();
+
+private:
+    struct CaseResult {
+        int caseIndex;
+        QVector<double> pressure;
+        QVector<double> derivative;
+    };
+
+    QFutureWatcher<CaseResult> m_watcher;
+    CancellationToken m_cancelToken;
+    SensitivityResultTable m_results;
+};
+
+#endif // SENSITIVITYENGINE_H
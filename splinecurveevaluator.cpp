@@ -0,0 +1,259 @@
+/*
+ * splinecurveevaluator.cpp
+ * 文件作用: 理论曲线的样条插值计算实现文件
+ * 功能描述:
+ * 1. 网格节点取 10^(k/pointsPerDecade) 并向两端各多取一个节点，
+ *    不同参数下网格一致，观测区间端点也不落在单侧差分的网格端点上。
+ * 2. 每层加密的新节点合并为一次求解器调用。
+ * 3. 曲线与参数偏导共用同一加密过程 (refineGrid)，偏导计算时各节点的偏导随压差一起求得。
+ */
+
+#include "splinecurveevaluator.h"
+#include "pressurederivativecalculator.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+// 取对数后参与样条的值 (非正值标记为 NaN)
+QVector<double> logValues(const QVector<double>& v)
+{
+    QVector<double> out(v.size());
+    for (int i = 0; i < v.size(); ++i) {
+        out[i] = (v[i] > 0.0) ? std::log(v[i]) : std::numeric_limits<double>::quiet_NaN();
+    }
+    return out;
+}
+
+} // namespace
+
+QVector<double> SplineCurveEvaluator::baseGrid(const QVector<double>& t, int pointsPerDecade)
+{
+    double tMin = std::numeric_limits<double>::max(), tMax = 0.0;
+    for (double v : t) {
+        if (v <= 0.0) continue;
+        tMin = qMin(tMin, v);
+        tMax = qMax(tMax, v);
+    }
+    QVector<double> x;
+    if (tMax <= 0.0) return x;
+    const int ppd = qMax(2, pointsPerDecade);
+    int k0 = int(std::floor(std::log10(tMin) * ppd)) - 1;
+    int k1 = int(std::ceil(std::log10(tMax) * ppd)) + 1;
+    for (int k = k0; k <= k1; ++k) x.append(k * std::log(10.0) / ppd);
+    return x;
+}
+
+int SplineCurveEvaluator::baseGridSize(const QVector<double>& t, int pointsPerDecade)
+{
+    return baseGrid(t, pointsPerDecade).size();
+}
+
+QVector<double> SplineCurveEvaluator::monotoneSlopes(const QVector<double>& x, const QVector<double>& y)
+{
+    const int n = x.size();
+    QVector<double> m(n, 0.0);
+    if (n < 2) return m;
+
+    QVector<double> delta(n - 1);
+    for (int k = 0; k < n - 1; ++k) delta[k] = (y[k + 1] - y[k]) / (x[k + 1] - x[k]);
+
+    // 内点: 割线斜率同号时取加权调和平均，否则为 0 (Fritsch-Butland 形式，保证单调)
+    for (int k = 1; k < n - 1; ++k) {
+        if (delta[k - 1] * delta[k] <= 0.0) continue;
+        double h0 = x[k] - x[k - 1], h1 = x[k + 1] - x[k];
+        double w0 = 2.0 * h1 + h0, w1 = h1 + 2.0 * h0;
+        m[k] = (w0 + w1) / (w0 / delta[k - 1] + w1 / delta[k]);
+    }
+    // 端点: 三点公式，并限制在单调范围内
+    auto endSlope = [](double h0, double h1, double d0, double d1) {
+        double s = ((2.0 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+        if (s * d0 <= 0.0) return 0.0;
+        if (d0 * d1 <= 0.0 && std::abs(s) > 3.0 * std::abs(d0)) return 3.0 * d0;
+        return s;
+    };
+    if (n == 2) {
+        m[0] = m[1] = delta[0];
+    } else {
+        m[0] = endSlope(x[1] - x[0], x[2] - x[1], delta[0], delta[1]);
+        m[n - 1] = endSlope(x[n - 1] - x[n - 2], x[n - 2] - x[n - 3], delta[n - 2], delta[n - 3]);
+    }
+    return m;
+}
+
+double SplineCurveEvaluator::hermite(const QVector<double>& x, const QVector<double>& y,
+                                     const QVector<double>& m, int k, double xv)
+{
+    double h = x[k + 1] - x[k];
+    double s = (xv - x[k]) / h;
+    double s2 = s * s, s3 = s2 * s;
+    return (2 * s3 - 3 * s2 + 1) * y[k] + (s3 - 2 * s2 + s) * h * m[k]
+         + (-2 * s3 + 3 * s2) * y[k + 1] + (s3 - s2) * h * m[k + 1];
+}
+
+bool SplineCurveEvaluator::refineGrid(const PressureFunction& fn, const SplineEvalOptions& options,
+                                      QVector<double>& x, QVector<double>& p, QVector<int>& sampleIds)
+{
+    // 1. 基础网格
+    const int nBase = x.size();
+    QVector<double> gridT(nBase);
+    for (int k = 0; k < nBase; ++k) gridT[k] = std::exp(x[k]);
+    p = fn(gridT);
+    if (p.size() != nBase) return false;
+    sampleIds.resize(nBase);
+    std::iota(sampleIds.begin(), sampleIds.end(), 0);
+    int sampleCount = nBase;
+
+    // 2. 自适应加密: 三阶差分估计误差 → 中点验证 → 超差区间继续二分
+    const double tol = qMax(1e-8, options.tolerance);
+    QVector<char> suspect(nBase - 1, 0);
+    {
+        QVector<double> y = logValues(p);
+        for (int k = 0; k < nBase - 1; ++k) {
+            int a = qMax(0, qMin(k - 1, nBase - 4));
+            double d3 = y[a + 3] - 3.0 * y[a + 2] + 3.0 * y[a + 1] - y[a];
+            // 非正值、端部区间或三阶差分较大的区间需要验证
+            suspect[k] = (!std::isfinite(d3) || k == 0 || k == nBase - 2 || std::abs(d3) > tol) ? 1 : 0;
+        }
+    }
+
+    for (int level = 0; level < qMax(0, options.maxLevels); ++level) {
+        QVector<int> intervals;
+        for (int k = 0; k < suspect.size(); ++k) if (suspect[k]) intervals.append(k);
+        if (intervals.isEmpty()) break;
+
+        QVector<double> y = logValues(p);
+        QVector<double> slopes = monotoneSlopes(x, y);
+        QVector<double> midX(intervals.size()), midT(intervals.size());
+        for (int i = 0; i < intervals.size(); ++i) {
+            int k = intervals[i];
+            midX[i] = 0.5 * (x[k] + x[k + 1]);
+            midT[i] = std::exp(midX[i]);
+        }
+        QVector<double> midP = fn(midT);
+        if (midP.size() != midT.size()) return false;
+
+        // 合并新节点；超差区间的两个子区间在下一层继续验证
+        QVector<double> nx, np;
+        QVector<int> nIds;
+        QVector<char> nSuspect;
+        int next = 0;
+        for (int k = 0; k < x.size(); ++k) {
+            nx.append(x[k]); np.append(p[k]); nIds.append(sampleIds[k]);
+            if (k == x.size() - 1) break;
+            if (next < intervals.size() && intervals[next] == k) {
+                double yInterp = hermite(x, y, slopes, k, midX[next]);
+                double yTrue = (midP[next] > 0.0) ? std::log(midP[next]) : std::numeric_limits<double>::quiet_NaN();
+                bool bad = !(std::abs(yTrue - yInterp) <= tol);
+                nx.append(midX[next]); np.append(midP[next]); nIds.append(sampleCount + next);
+                nSuspect.append(bad ? 1 : 0);
+                nSuspect.append(bad ? 1 : 0);
+                next++;
+            } else {
+                nSuspect.append(0);
+            }
+        }
+        x = nx; p = np; sampleIds = nIds; suspect = nSuspect;
+        sampleCount += midT.size();
+    }
+    return true;
+}
+
+ModelCurveData SplineCurveEvaluator::evaluate(const CurveFunction& fn, const QVector<double>& t,
+                                              const SplineEvalOptions& options, int* gridPoints)
+{
+    if (gridPoints) *gridPoints = 0;
+    QVector<double> x = baseGrid(t, options.pointsPerDecade);
+    if (x.size() < 4) {
+        ModelCurveData direct = fn(t);
+        if (gridPoints) *gridPoints = t.size();
+        return direct;
+    }
+
+    // 1-2. 基础网格与自适应加密
+    QVector<double> p;
+    QVector<int> sampleIds;
+    if (!refineGrid([&fn](const QVector<double>& gridT) { return std::get<1>(fn(gridT)); }, options, x, p, sampleIds))
+        return ModelCurveData();
+
+    // 3. 最终网格上的 Bourdet 导数 (与直接计算相同的定义)
+    const int nGrid = x.size();
+    QVector<double> gridT(nGrid);
+    for (int k = 0; k < nGrid; ++k) gridT[k] = std::exp(x[k]);
+    QVector<double> d = PressureDerivativeCalculator::calculateBourdetDerivative(gridT, p, 0.1);
+    if (gridPoints) *gridPoints = nGrid;
+
+    // 4. 插值到目标时刻
+    return std::make_tuple(t, interpolate(x, p, t, true), interpolate(x, d, t, true));
+}
+
+ModelSensitivityData SplineCurveEvaluator::evaluateSensitivity(const SensitivityFunction& fn, const QVector<double>& t,
+                                                               const SplineEvalOptions& options)
+{
+    QVector<double> x = baseGrid(t, options.pointsPerDecade);
+    if (x.size() < 4) return fn(t);
+
+    // 与 evaluate 相同的网格加密，各次调用的压差偏导按调用顺序保存
+    QStringList paramNames;
+    QVector<QVector<double>> samples;   // samples[k] 为各次调用首尾相接的 ∂P/∂θ_k
+    QVector<double> p;
+    QVector<int> sampleIds;
+    auto pressureAt = [&](const QVector<double>& gridT) {
+        ModelSensitivityData s = fn(gridT);
+        if (s.time.size() != gridT.size()) return QVector<double>();
+        if (samples.isEmpty()) {
+            paramNames = s.paramNames;
+            samples.resize(s.dPressure.size());
+        }
+        for (int k = 0; k < samples.size(); ++k) samples[k] += s.dPressure.value(k, QVector<double>(gridT.size(), 0.0));
+        return s.pressure;
+    };
+    if (!refineGrid(pressureAt, options, x, p, sampleIds)) return ModelSensitivityData();
+
+    // 最终网格上的导数及其偏导与 evaluate 使用同一 Bourdet 差分
+    const int nGrid = x.size();
+    QVector<double> gridT(nGrid);
+    for (int k = 0; k < nGrid; ++k) gridT[k] = std::exp(x[k]);
+    QVector<QVector<double>> dPressure(samples.size(), QVector<double>(nGrid));
+    for (int k = 0; k < samples.size(); ++k) {
+        for (int i = 0; i < nGrid; ++i) dPressure[k][i] = samples[k][sampleIds[i]];
+    }
+    QVector<double> d = PressureDerivativeCalculator::calculateBourdetDerivative(gridT, p, 0.1);
+    QVector<QVector<double>> dDerivative = PressureDerivativeCalculator::calculateBourdetSensitivity(gridT, p, dPressure, 0.1);
+
+    ModelSensitivityData out;
+    out.time = t;
+    out.pressure = interpolate(x, p, t, true);
+    out.derivative = interpolate(x, d, t, true);
+    out.paramNames = paramNames;
+    for (const QVector<double>& col : dPressure) out.dPressure.append(interpolate(x, col, t, false));
+    for (const QVector<double>& col : dDerivative) out.dDerivative.append(interpolate(x, col, t, false));
+    return out;
+}
+
+QVector<double> SplineCurveEvaluator::interpolate(const QVector<double>& x, const QVector<double>& v,
+                                                  const QVector<double>& t, bool logSpace)
+{
+    const int nGrid = x.size();
+    QVector<double> y = logSpace ? logValues(v) : v;
+    QVector<double> m = monotoneSlopes(x, y);
+    QVector<double> out(t.size(), 0.0);
+    for (int i = 0; i < t.size(); ++i) {
+        if (t[i] <= 0.0) continue;
+        double xv = std::log(t[i]);
+        int k = int(std::upper_bound(x.constBegin(), x.constEnd(), xv) - x.constBegin()) - 1;
+        k = qBound(0, k, nGrid - 2);
+
+        if (std::isfinite(y[k]) && std::isfinite(y[k + 1]) && std::isfinite(m[k]) && std::isfinite(m[k + 1])) {
+            double yv = hermite(x, y, m, k, xv);
+            out[i] = logSpace ? std::exp(yv) : yv;
+        } else {
+            double s = (xv - x[k]) / (x[k + 1] - x[k]);
+            out[i] = v[k] + s * (v[k + 1] - v[k]);
+        }
+    }
+    return out;
+}
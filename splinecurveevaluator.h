@@ -0,0 +1,74 @@
+/*
+ * splinecurveevaluator.h
+ * 文件作用: 理论曲线的样条插值计算头文件
+ * 功能描述:
+ * 1. 理论曲线在双对数坐标中光滑，观测点很密时不必在每个观测时刻做数值反演:
+ *    先在对齐到十倍程的对数网格 (默认每十倍程 10 点) 上计算，再插值到观测时刻，
+ *    反演次数只取决于时间跨度 (十倍程数) 与曲线形状，与观测点数无关。
+ * 2. 插值为 (ln t, ln p) 上的单调三次 Hermite (Fritsch-Carlson)，不产生过冲；
+ *    压差或导数非正的区间退化为线性插值。
+ * 3. 自适应加密: 由三阶差分估计各区间的插值误差，可疑区间在中点补算真实值并与插值比较，
+ *    误差超过容差 (ln p 单位) 的区间继续二分，直到满足容差或达到最大层数。
+ * 4. 导数列与直接计算一致: 在最终网格上对压差做 Bourdet 导数 (L = 0.1)，再同样插值。
+ * 5. 参数偏导 (雅可比) 在与曲线相同的加密网格上计算，导数的偏导由同一 Bourdet 差分作用于压差偏导得到，
+ *    与曲线的导数定义一致；偏导可能变号，在 ln t 上对原值做单调插值。
+ */
+
+#ifndef SPLINECURVEEVALUATOR_H
+#define SPLINECURVEEVALUATOR_H
+
+#include <QVector>
+#include <functional>
+
+#include "modelsolver01_06.h"
+
+// 插值计算设置
+struct SplineEvalOptions {
+    int pointsPerDecade = 10;   // 基础网格密度
+    double tolerance = 1e-3;    // 允许的 ln p 插值误差 (约 0.1% 相对误差)
+    int maxLevels = 4;          // 最大加密层数 (每层区间二分)
+};
+
+class SplineCurveEvaluator
+{
+public:
+    // 在给定时刻计算理论曲线 <t, p, dp>，返回空结果表示被取消
+    using CurveFunction = std::function<ModelCurveData(const QVector<double>&)>;
+    using SensitivityFunction = std::function<ModelSensitivityData(const QVector<double>&)>;
+
+    // 在时刻 t (可无序，≤ 0 的时刻输出 0) 上计算曲线；gridPoints 非空时返回实际反演的网格点数
+    static ModelCurveData evaluate(const CurveFunction& fn, const QVector<double>& t,
+                                   const SplineEvalOptions& options, int* gridPoints = nullptr);
+
+    // 曲线及参数偏导在时刻 t 上的插值结果，返回空结果 (time 为空) 表示被取消
+    static ModelSensitivityData evaluateSensitivity(const SensitivityFunction& fn, const QVector<double>& t,
+                                                    const SplineEvalOptions& options);
+
+    // 覆盖 t 的基础网格点数 (用于判断插值是否划算)
+    static int baseGridSize(const QVector<double>& t, int pointsPerDecade);
+
+    // 单调三次 Hermite 的节点斜率 (Fritsch-Carlson)
+    static QVector<double> monotoneSlopes(const QVector<double>& x, const QVector<double>& y);
+
+private:
+    // 在给定时刻计算压差，返回长度不符表示被取消
+    using PressureFunction = std::function<QVector<double>(const QVector<double>&)>;
+
+    // 由基础网格 x (ln t) 自适应加密，返回最终网格及其压差；
+    // sampleIds[i] 为节点 i 在各次 fn 调用中首尾相接的序号。被取消时返回 false
+    static bool refineGrid(const PressureFunction& fn, const SplineEvalOptions& options,
+                           QVector<double>& x, QVector<double>& p, QVector<int>& sampleIds);
+
+    // 基础网格节点 (ln t)
+    static QVector<double> baseGrid(const QVector<double>& t, int pointsPerDecade);
+
+    // 区间 [k, k+1] 上的 Hermite 插值
+    static double hermite(const QVector<double>& x, const QVector<double>& y,
+                          const QVector<double>& m, int k, double xv);
+
+    // 把网格 x (ln t) 上的值 v 插值到时刻 t；logSpace 时在 ln v 上插值 (非正区间退化为线性)
+    static QVector<double> interpolate(const QVector<double>& x, const QVector<double>& v,
+                                       const QVector<double>& t, bool logSpace);
+};
+
+#endif // SPLINECURVEEVALUATOR_H
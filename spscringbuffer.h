@@ -0,0 +1,66 @@
+/*
+ * spscringbuffer.h
+ * 文件作用: 单生产者单消费者无锁环形缓冲区
+ * 功能描述:
+ * 1. 容量固定 (取不小于请求值的 2 的幂)，构造时一次性分配，运行中不再分配内存。
+ * 2. 生产者线程只写尾指针、消费者线程只写头指针，两端以 acquire/release 原子操作同步，不加锁。
+ * 3. 缓冲区满时 push() 返回 false，由生产者决定等待还是丢弃 (内存占用始终有界)。
+ */
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(int capacity) : m_head(0), m_tail(0) {
+        int size = 2;
+        while (size < capacity) size <<= 1;
+        m_buffer.resize(size);
+        m_mask = size - 1;
+    }
+
+    int capacity() const { return m_buffer.size(); }
+
+    // 生产者: 放入一个元素，缓冲区满时返回 false
+    bool push(const T& value) {
+        const quint64 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= quint64(m_buffer.size())) return false;
+        m_buffer[int(tail & m_mask)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者: 最多取出 maxCount 个元素追加到 out，返回取出个数
+    int pop(QVector<T>& out, int maxCount) {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        const quint64 available = m_tail.load(std::memory_order_acquire) - head;
+        const int n = int(qMin<quint64>(available, quint64(qMax(0, maxCount))));
+        for (int i = 0; i < n; ++i) out.append(m_buffer[int((head + i) & m_mask)]);
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // 当前元素个数 (近似值，仅供显示)
+    int size() const {
+        return int(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+    }
+
+    // 消费者: 丢弃全部元素
+    void clear() { m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+    Q_DISABLE_COPY(SpscRingBuffer)
+
+    QVector<T> m_buffer;
+    quint64 m_mask;
+    std::atomic<quint64> m_head;   // 下一个待读位置 (消费者写)
+    std::atomic<quint64> m_tail;   // 下一个待写位置 (生产者写)
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,176 @@
+/*
+ * stehfestbenchmark.cpp
+ * 文件作用: Stehfest 反演精度与耗时的微基准实现文件
+ * 功能描述:
+ * 1. 解析算例的象函数: 1/(s(s+1)) ↔ 1 - e^(-t)，s^(-3/2) ↔ 2√(t/π)，
+ *    K0(√s)/s ↔ E1(1/(4t))/2 (无限大地层线源解)。
+ * 2. 求和耗时只统计加权求和 (核函数值预先算好)，反映双双精度累加本身的开销。
+ */
+
+#include "stehfestbenchmark.h"
+#include "modelsolver01_06.h"
+#include "modelmanager.h"
+
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QMap>
+#include <boost/math/special_functions/bessel.hpp>
+#include <boost/math/special_functions/expint.hpp>
+#include <functional>
+#include <cmath>
+
+namespace {
+
+struct AnalyticCase {
+    QString name;
+    std::function<double(double)> laplace;
+    std::function<double(double)> exact;
+};
+
+QVector<AnalyticCase> analyticCases()
+{
+    const double pi = 3.14159265358979323846;
+    return {
+        { "1/(s(s+1))", [](double s) { return 1.0 / (s * (s + 1.0)); },
+                        [](double t) { return 1.0 - std::exp(-t); } },
+        { "s^(-3/2)", [](double s) { return 1.0 / (s * std::sqrt(s)); },
+                      [pi](double t) { return 2.0 * std::sqrt(t / pi); } },
+        { "K0(√s)/s", [](double s) { return boost::math::cyl_bessel_k(0, std::sqrt(s)) / s; },
+                      [](double t) { return 0.5 * boost::math::expint(1, 1.0 / (4.0 * t)); } },
+    };
+}
+
+// 按双精度或双双精度权重求和，pf[m-1] 为 F(m·ln2/t)
+double stehfestSum(const QVector<double>& pf, const QVector<double>& V)
+{
+    double s = 0.0;
+    for (int m = 0; m < V.size(); ++m) s += V[m] * pf[m];
+    return s;
+}
+
+double stehfestSum(const QVector<double>& pf, const QVector<DoubleDouble>& V)
+{
+    DoubleDouble s;
+    for (int m = 0; m < V.size(); ++m) s += V[m] * pf[m];
+    return s.toDouble();
+}
+
+} // namespace
+
+int StehfestBenchmark::runCli(const QStringList& args)
+{
+    QTextStream out(stdout);
+    int model = 1;
+    int nTime = 40;
+    int repeat = 3;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--model" && i + 1 < args.size()) model = args[++i].toInt();
+        else if (args[i] == "--points" && i + 1 < args.size()) nTime = args[++i].toInt();
+        else if (args[i] == "--repeat" && i + 1 < args.size()) repeat = args[++i].toInt();
+    }
+    if (model < 1 || model > 6 || nTime < 3 || repeat < 1) {
+        out << "用法: WellTest --bench-stehfest [--model <1-6>] [--points <时间点数>] [--repeat <重复次数>]\n";
+        return 1;
+    }
+
+    const double ln2 = std::log(2.0);
+    const QVector<int> Ns = {8, 10, 12, 14, 16, 18, 20};
+
+    // 1. 解析算例的最大相对误差
+    QVector<double> tAnalytic = ModelManager::generateLogTimeSteps(51, -2.0, 3.0);
+    for (const AnalyticCase& c : analyticCases()) {
+        out << "解析算例 " << c.name << ": 最大相对误差 (双精度 / 双双精度)\n";
+        for (int N : Ns) {
+            QVector<double> V = ModelSolver01_06::stehfestWeights(N);
+            QVector<DoubleDouble> VX = ModelSolver01_06::stehfestWeightsExtended(N);
+            double errD = 0.0, errX = 0.0;
+            QVector<double> pf(N);
+            for (double t : tAnalytic) {
+                for (int m = 1; m <= N; ++m) pf[m - 1] = c.laplace(m * ln2 / t);
+                double exact = c.exact(t);
+                errD = qMax(errD, std::abs(stehfestSum(pf, V) * ln2 / t - exact) / std::abs(exact));
+                errX = qMax(errX, std::abs(stehfestSum(pf, VX) * ln2 / t - exact) / std::abs(exact));
+            }
+            out << QString("  N=%1  %2 / %3\n").arg(N, 2)
+                       .arg(errD, 0, 'e', 2).arg(errX, 0, 'e', 2);
+        }
+    }
+
+    // 2. 求和耗时 (每次反演, 纳秒)
+    {
+        const int nSums = 200000;
+        auto timeSum = [&](int N, bool extended) {
+            QVector<double> V = ModelSolver01_06::stehfestWeights(N);
+            QVector<DoubleDouble> VX = ModelSolver01_06::stehfestWeightsExtended(N);
+            QVector<double> pf(N);
+            for (int m = 1; m <= N; ++m) pf[m - 1] = 1.0 / (m * (m + 1.0));
+            volatile double sink = 0.0;
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < nSums; ++i) {
+                pf[i % N] += 1e-300;
+                sink = sink + (extended ? stehfestSum(pf, VX) : stehfestSum(pf, V));
+            }
+            return double(timer.nsecsElapsed()) / nSums;
+        };
+        double base = timeSum(8, false);
+        out << "加权求和耗时 (不含核函数):\n";
+        out << QString("  N=8  双精度    %1 ns\n").arg(base, 0, 'f', 1);
+        for (int N : {16, 20}) {
+            double d = timeSum(N, false), x = timeSum(N, true);
+            out << QString("  N=%1 双精度    %2 ns\n").arg(N).arg(d, 0, 'f', 1);
+            out << QString("  N=%1 双双精度  %2 ns (N=8 双精度的 %3 倍)\n").arg(N).arg(x, 0, 'f', 1).arg(x / base, 0, 'f', 1);
+        }
+    }
+
+    // 3. 模型算例: 求解器实际路径
+    QMap<QString, double> params;
+    params["kf"] = 1.0;
+    params["km"] = 0.1;
+    params["LfD"] = 0.1;
+    params["rmD"] = 5.0;
+    params["omega1"] = 0.1;
+    params["omega2"] = 0.01;
+    params["lambda1"] = 1e-6;
+    params["nf"] = 4.0;
+    params["reD"] = 20.0;
+    params["cD"] = 0.01;
+    params["S"] = 0.0;
+    params["gamaD"] = 0.0;
+
+    const ModelType type = static_cast<ModelType>(model - 1);
+    QVector<double> tD = ModelManager::generateLogTimeSteps(nTime, -2.0, 4.0);
+    out << "模型算例: " << ModelManager::getModelTypeName(type) << ", " << nTime << " 个时间点\n";
+    out.flush();
+
+    double baseMs = 0.0;
+    QVector<double> prev;
+    for (int N : Ns) {
+        params["N"] = N;
+        QVector<double> pd;
+        QElapsedTimer timer;
+        timer.start();
+        for (int r = 0; r < repeat; ++r)
+            pd = std::get<1>(ModelSolver01_06::calculateDimensionlessCurve(type, params, tD, true));
+        double ms = timer.nsecsElapsed() / 1e6 / repeat;
+        if (N == 8) baseMs = ms;
+
+        QString diff = "-";
+        if (prev.size() == pd.size()) {
+            double d = 0.0;
+            for (int i = 0; i < pd.size(); ++i) {
+                if (pd[i] > 0.0 && prev[i] > 0.0) d = qMax(d, std::abs(std::log(pd[i] / prev[i])));
+            }
+            diff = QString::number(d, 'e', 2);
+        }
+        out << QString("  N=%1 %2  %3 ms (%4 倍)  与 N-2 的最大 ln pD 差 %5\n")
+                   .arg(N, 2)
+                   .arg(ModelSolver01_06::usesExtendedPrecision(N) ? "双双精度" : "双精度  ")
+                   .arg(ms, 0, 'f', 1)
+                   .arg(baseMs > 0.0 ? ms / baseMs : 1.0, 0, 'f', 2)
+                   .arg(diff);
+        out.flush();
+        prev = pd;
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * stehfestbenchmark.h
+ * 文件作用: Stehfest 反演精度与耗时的微基准头文件 (命令行 --bench-stehfest)
+ * 功能描述:
+ * 1. 解析算例: 对逆变换已知的象函数 (核函数值精确到末位)，比较各 N 下双精度权重/求和
+ *    与双双精度权重/求和的最大相对误差，以及两种求和方式单独的耗时。
+ * 2. 模型算例: 以求解器的实际路径 (N ≤ 14 双精度，N > 14 双双精度) 计算无因次理论曲线，
+ *    给出各 N 的耗时、相对 N = 8 的倍数，以及与 N - 2 结果的最大 ln pD 差 (收敛程度)。
+ */
+
+#ifndef STEHFESTBENCHMARK_H
+#define STEHFESTBENCHMARK_H
+
+#include <QStringList>
+
+class StehfestBenchmark
+{
+public:
+    // 用法: WellTest --bench-stehfest [--model <1-6>] [--points <时间点数>] [--repeat <重复次数>]
+    static int runCli(const QStringList& args);
+};
+
+#endif // STEHFESTBENCHMARK_H
@@ -0,0 +1,72 @@
+/*
+ * stehfestprecision.h
+ * 文件作用: 拟合迭代中 Stehfest 反演精度的自适应控制头文件
+ * 功能描述:
+ * 1. 反演误差估计: 在观测时间范围内取少量对数均布的探测时刻 (每个探测时刻另取 t·e^(±0.1)
+ *    两个邻点以估计对数导数)，分别以 N 与 N+2 项计算，取 ln p 与 ln(dp/dln t) 的最大差作为 N 项的误差。
+ * 2. 精度随步长提高: 目标误差 = stepScale × 最近一步的步长 (迭代坐标，对数参数为 log10)，
+ *    并夹在 [tightTolerance, looseTolerance] 之间；误差超过目标时 N 逐次加 2，直到满足或达到 maxN。
+ *    远离最优点时步长大，低阶反演的误差不影响下降方向；接近收敛时步长小，反演误差需随之减小。
+ * 3. 一次拟合中 N 只增不减，调用方在 N 改变后须在新精度下重算目标函数再比较步长。
+ * 4. 探测只有十余个时刻，代价远小于一次残差计算。
+ */
+
+#ifndef STEHFESTPRECISION_H
+#define STEHFESTPRECISION_H
+
+#include <QVector>
+#include <functional>
+
+#include "modelsolver01_06.h"
+#include "parameterschema.h"
+
+// 精度控制设置
+struct StehfestPrecisionOptions {
+    int minN = 4;                   // 起始项数
+    int maxN = 12;                  // 最大项数 (再高收益很小，N ≥ 20 时核函数舍入误差被权重放大)
+    int probePoints = 4;            // 探测时刻个数
+    double looseTolerance = 3e-2;   // 步长较大时允许的反演误差 (ln 单位)
+    double tightTolerance = 1e-3;   // 收敛阶段的反演误差目标
+    double stepScale = 0.1;         // 目标误差与步长之比
+};
+
+class StehfestPrecisionController
+{
+public:
+    // 以 params (其中 Param_N 已设为待测项数) 在时刻 t 上计算理论曲线，返回空结果表示被取消
+    using CurveFunction = std::function<ModelCurveData(const ParamVector&, const QVector<double>&)>;
+
+    // time 为观测时间 (用于确定探测时刻)
+    StehfestPrecisionController(const CurveFunction& fn, const QVector<double>& time,
+                                const StehfestPrecisionOptions& options = StehfestPrecisionOptions());
+
+    int currentN() const { return m_N; }
+    double lastError() const { return m_lastError; }    // 最近一次估计的 N 项反演误差 (未估计时为 -1)
+    double tolerance() const { return m_tolerance; }    // 最近一次的目标误差
+    const QVector<double>& probeTimes() const { return m_probeTimes; }
+
+    // 把当前项数写入参数向量
+    void apply(ParamVector& params) const { params[Param_N] = m_N; }
+
+    // 估计 N 项反演在 params 处的误差 (N 与 N+2 比较)，被取消或无法估计时返回 -1
+    double estimateError(const ParamVector& params, int N) const;
+
+    // 按最近一步的步长更新目标误差并在需要时提高项数 (stepNorm 非有限时取最宽松目标)；
+    // 返回 true 表示项数已改变
+    bool update(const ParamVector& params, double stepNorm);
+
+private:
+    // 探测时刻上的 ln p 与 ln(dp/dln t) (无法取对数的位置为 NaN)，被取消时返回 false
+    bool probe(const ParamVector& params, int N, QVector<double>& out) const;
+
+    static double maxDifference(const QVector<double>& a, const QVector<double>& b);
+
+    CurveFunction m_fn;
+    StehfestPrecisionOptions m_options;
+    QVector<double> m_probeTimes;   // 每个探测时刻依次为 t·e^(-L), t, t·e^(L)
+    int m_N;
+    double m_lastError = -1.0;
+    double m_tolerance;
+};
+
+#endif // STEHFESTPRECISION_H
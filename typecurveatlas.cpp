@@ -0,0 +1,520 @@
+/*
+ * typecurveatlas.cpp
+ * 文件作用: 类型曲线图版实现文件
+ * 功能描述:
+ * 1. 按参数网格并行调用 ModelSolver01_06 生成无因次曲线，以 float 存储 log10 值。
+ * 2. 图版文件格式: 64 字节文件头 + 坐标轴记录 + 基准参数记录 + 16 字节对齐的曲线数据，
+ *    数据区按节点顺序连续存放 [log10(pD) × nTime][log10(导数) × nTime]，可直接内存映射使用。
+ * 3. 多线性插值: 在各轴 (对数轴取 log10) 上定位网格单元，对 2^D 个角点加权求和。
+ */
+
+#include "typecurveatlas.h"
+#include "modelmanager.h"
+
+#include <QtConcurrent>
+#include <QDir>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char AtlasMagic[8] = { 'W', 'T', 'A', 'T', 'L', 'A', 'S', '1' };
+const qint32 AtlasVersion = 1;
+const int AtlasNameSize = 24;
+
+// 图版文件头 (小端序，64 字节)
+struct AtlasFileHeader {
+    char magic[8];
+    qint32 version;
+    qint32 modelType;
+    qint32 nAxes;
+    qint32 nTime;
+    double logTdMin;
+    double logTdMax;
+    qint64 nodeCount;
+    qint32 nBaseParams;
+    qint32 reserved;
+    qint64 dataOffset;
+};
+
+// 坐标轴记录头，其后紧跟 count 个 double 节点值
+struct AtlasAxisRecord {
+    char name[AtlasNameSize];
+    qint32 logScale;
+    qint32 count;
+};
+
+// 基准参数记录
+struct AtlasParamRecord {
+    char name[AtlasNameSize];
+    double value;
+};
+
+void copyName(char* dst, const QString& name)
+{
+    std::memset(dst, 0, AtlasNameSize);
+    QByteArray utf8 = name.toUtf8().left(AtlasNameSize - 1);
+    std::memcpy(dst, utf8.constData(), utf8.size());
+}
+
+QString readName(const char* src)
+{
+    return QString::fromUtf8(src, (int)qstrnlen(src, AtlasNameSize));
+}
+
+// 生成图版时未进入网格的参数取值 (与拟合参数表的默认值一致)
+QMap<QString, double> defaultBaseParams()
+{
+    QMap<QString, double> p;
+    p["kf"] = 1.0;
+    p["km"] = 0.1;
+    p["LfD"] = 0.1;
+    p["rmD"] = 5.0;
+    p["omega1"] = 0.1;
+    p["omega2"] = 0.01;
+    p["lambda1"] = 1e-6;
+    p["nf"] = 4.0;
+    p["reD"] = 20.0;
+    p["cD"] = 0.01;
+    p["S"] = 0.0;
+    p["gamaD"] = 0.0;
+    return p;
+}
+
+} // namespace
+
+TypeCurveAtlas::TypeCurveAtlas()
+    : m_type(Model_1)
+    , m_nTime(0)
+    , m_logTdMin(0.0)
+    , m_logTdMax(0.0)
+    , m_nodeCount(0)
+    , m_data(nullptr)
+    , m_map(nullptr)
+{
+}
+
+TypeCurveAtlas::~TypeCurveAtlas()
+{
+    unload();
+}
+
+QString TypeCurveAtlas::defaultFileName(ModelType type)
+{
+    return QString("atlas_model%1.wta").arg((int)type + 1);
+}
+
+QVector<AtlasAxis> TypeCurveAtlas::defaultAxes(ModelType type)
+{
+    QVector<AtlasAxis> axes;
+    axes.append(AtlasAxis{"LfD", true, {0.02, 0.05, 0.1, 0.2, 0.4}});
+    axes.append(AtlasAxis{"M12", true, {1.0, 3.0, 10.0, 30.0, 100.0}});
+    axes.append(AtlasAxis{"omega1", true, {0.01, 0.05, 0.2, 0.6}});
+    axes.append(AtlasAxis{"lambda1", true, {1e-8, 1e-6, 1e-4, 1e-2}});
+    axes.append(AtlasAxis{"nf", true, {1.0, 2.0, 4.0, 8.0, 16.0}});
+
+    bool hasBoundary = (type == Model_3 || type == Model_4 || type == Model_5 || type == Model_6);
+    if (hasBoundary) axes.append(AtlasAxis{"reD", true, {5.0, 10.0, 30.0, 100.0}});
+
+    bool hasStorage = (type == Model_1 || type == Model_3 || type == Model_5);
+    if (hasStorage) {
+        axes.append(AtlasAxis{"cD", true, {1e-4, 1e-3, 1e-2, 1e-1}});
+        axes.append(AtlasAxis{"S", false, {-2.0, 0.0, 3.0, 10.0}});
+    }
+    return axes;
+}
+
+double TypeCurveAtlas::axisParamValue(const QString& axisName, const QMap<QString, double>& params)
+{
+    if (axisName == "M12") {
+        double km = params.value("km", 0.0);
+        return (km > 0.0) ? params.value("kf", 0.0) / km : 0.0;
+    }
+    if (axisName == "LfD" && !params.contains("LfD")) {
+        double L = params.value("L", 0.0);
+        return (L > 1e-9) ? params.value("Lf", 0.0) / L : 0.0;
+    }
+    return params.value(axisName, 0.0);
+}
+
+void TypeCurveAtlas::setAxisParam(QMap<QString, double>& params, const QString& axisName, double value)
+{
+    if (axisName == "M12") {
+        double kf = params.value("kf", 1.0);
+        params["km"] = (value > 0.0) ? kf / value : kf;
+    } else {
+        // LfD 轴同步改写 Lf，否则求解时 fromMap 会按 Lf/L 覆盖节点的 LfD
+        ParameterSchema::setMapValue(params, axisName, value);
+    }
+}
+
+void TypeCurveAtlas::prepareAxes()
+{
+    int nAxes = m_axes.size();
+    m_axisT.clear();
+    m_axisOffset.resize(nAxes);
+    m_strides.resize(nAxes);
+
+    for (int a = 0; a < nAxes; ++a) {
+        m_axisOffset[a] = m_axisT.size();
+        for (double v : m_axes[a].values) {
+            m_axisT.append(m_axes[a].logScale ? std::log10(qMax(v, 1e-300)) : v);
+        }
+    }
+
+    m_nodeCount = 1;
+    for (int a = nAxes - 1; a >= 0; --a) {
+        m_strides[a] = m_nodeCount;
+        m_nodeCount *= qMax(1, (int)m_axes[a].values.size());
+    }
+}
+
+QVector<double> TypeCurveAtlas::timeGrid() const
+{
+    return ModelManager::generateLogTimeSteps(m_nTime, m_logTdMin, m_logTdMax);
+}
+
+QMap<QString, double> TypeCurveAtlas::nodeParams(qint64 node) const
+{
+    QMap<QString, double> p = m_baseParams;
+    for (int a = 0; a < m_axes.size(); ++a) {
+        int count = m_axes[a].values.size();
+        int idx = (int)((node / m_strides[a]) % count);
+        setAxisParam(p, m_axes[a].name, m_axes[a].values[idx]);
+    }
+    return p;
+}
+
+QSharedPointer<TypeCurveAtlas> TypeCurveAtlas::generate(ModelType type,
+                                                        const QVector<AtlasAxis>& axes,
+                                                        const QMap<QString, double>& baseParams,
+                                                        int nTime, double logTdMin, double logTdMax,
+                                                        int stehfestN,
+                                                        std::function<void(int, int)> progress,
+                                                        const CancellationToken& cancel)
+{
+    QSharedPointer<TypeCurveAtlas> atlas(new TypeCurveAtlas);
+    atlas->m_type = type;
+    atlas->m_axes = axes;
+    atlas->m_baseParams = baseParams;
+    atlas->m_baseParams["kf"] = 1.0;    // 无因次计算只依赖 M12
+    atlas->m_baseParams["gamaD"] = 0.0; // 压敏效应在插值后叠加
+    atlas->m_nTime = qMax(2, nTime);
+    atlas->m_logTdMin = logTdMin;
+    atlas->m_logTdMax = logTdMax;
+    atlas->prepareAxes();
+
+    const qint64 nodeCount = atlas->m_nodeCount;
+    const int nt = atlas->m_nTime;
+    atlas->m_ownedData.resize(nodeCount * 2 * nt);
+    float* data = atlas->m_ownedData.data();
+    const QVector<double> tD = atlas->timeGrid();
+
+    QVector<qint64> nodes(nodeCount);
+    std::iota(nodes.begin(), nodes.end(), 0);
+    QAtomicInt done(0);
+
+    // 每个网格节点独立求解，写入各自的数据区，无需加锁
+    QtConcurrent::blockingMap(nodes, [&](qint64 node) {
+        if (cancel.isCancelled()) return;
+        QMap<QString, double> p = atlas->nodeParams(node);
+        p["N"] = stehfestN;
+        ModelCurveData curve = ModelSolver01_06::calculateDimensionlessCurve(type, p, tD, true, cancel);
+        if (cancel.isCancelled()) return;
+        const QVector<double>& pD = std::get<1>(curve);
+        const QVector<double>& dpD = std::get<2>(curve);
+
+        float* dst = data + node * 2 * nt;
+        for (int i = 0; i < nt; ++i) {
+            dst[i] = (float)std::log10(qMax(pD[i], 1e-30));
+            dst[nt + i] = (float)std::log10(qMax(dpD[i], 1e-30));
+        }
+        int n = done.fetchAndAddRelaxed(1) + 1;
+        if (progress) progress(n, (int)nodeCount);
+    });
+    if (cancel.isCancelled()) return QSharedPointer<TypeCurveAtlas>();
+
+    atlas->m_data = atlas->m_ownedData.constData();
+    return atlas;
+}
+
+bool TypeCurveAtlas::save(const QString& path) const
+{
+    if (!isValid()) return false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    AtlasFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, AtlasMagic, sizeof(AtlasMagic));
+    header.version = AtlasVersion;
+    header.modelType = (qint32)m_type;
+    header.nAxes = m_axes.size();
+    header.nTime = m_nTime;
+    header.logTdMin = m_logTdMin;
+    header.logTdMax = m_logTdMax;
+    header.nodeCount = m_nodeCount;
+    header.nBaseParams = m_baseParams.size();
+
+    QByteArray meta;
+    for (const AtlasAxis& axis : m_axes) {
+        AtlasAxisRecord rec;
+        copyName(rec.name, axis.name);
+        rec.logScale = axis.logScale ? 1 : 0;
+        rec.count = axis.values.size();
+        meta.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        meta.append(reinterpret_cast<const char*>(axis.values.constData()), axis.values.size() * sizeof(double));
+    }
+    for (auto it = m_baseParams.constBegin(); it != m_baseParams.constEnd(); ++it) {
+        AtlasParamRecord rec;
+        copyName(rec.name, it.key());
+        rec.value = it.value();
+        meta.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    }
+
+    qint64 offset = sizeof(header) + meta.size();
+    header.dataOffset = (offset + 15) & ~qint64(15);
+    meta.append(QByteArray(int(header.dataOffset - offset), '\0'));
+
+    qint64 dataBytes = m_nodeCount * 2 * m_nTime * (qint64)sizeof(float);
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == (qint64)sizeof(header)
+              && file.write(meta) == meta.size()
+              && file.write(reinterpret_cast<const char*>(m_data), dataBytes) == dataBytes;
+    file.close();
+    return ok;
+}
+
+bool TypeCurveAtlas::load(const QString& path)
+{
+    unload();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+
+    qint64 fileSize = m_file.size();
+    if (fileSize < (qint64)sizeof(AtlasFileHeader)) { unload(); return false; }
+
+    m_map = m_file.map(0, fileSize);
+    if (!m_map) { unload(); return false; }
+
+    AtlasFileHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+    if (std::memcmp(header.magic, AtlasMagic, sizeof(AtlasMagic)) != 0 || header.version != AtlasVersion
+        || header.nAxes < 0 || header.nTime < 2 || header.modelType < Model_1 || header.modelType > Model_6) {
+        qWarning() << "图版文件格式无效:" << path;
+        unload();
+        return false;
+    }
+
+    // 解析坐标轴与基准参数
+    const uchar* cursor = m_map + sizeof(header);
+    const uchar* end = m_map + fileSize;
+    for (int a = 0; a < header.nAxes; ++a) {
+        AtlasAxisRecord rec;
+        if (cursor + sizeof(rec) > end) { unload(); return false; }
+        std::memcpy(&rec, cursor, sizeof(rec));
+        cursor += sizeof(rec);
+        if (rec.count < 1 || cursor + rec.count * sizeof(double) > end) { unload(); return false; }
+
+        AtlasAxis axis;
+        axis.name = readName(rec.name);
+        axis.logScale = (rec.logScale != 0);
+        axis.values.resize(rec.count);
+        std::memcpy(axis.values.data(), cursor, rec.count * sizeof(double));
+        cursor += rec.count * sizeof(double);
+        m_axes.append(axis);
+    }
+    for (int i = 0; i < header.nBaseParams; ++i) {
+        AtlasParamRecord rec;
+        if (cursor + sizeof(rec) > end) { unload(); return false; }
+        std::memcpy(&rec, cursor, sizeof(rec));
+        cursor += sizeof(rec);
+        m_baseParams[readName(rec.name)] = rec.value;
+    }
+
+    m_type = (ModelType)header.modelType;
+    m_nTime = header.nTime;
+    m_logTdMin = header.logTdMin;
+    m_logTdMax = header.logTdMax;
+    prepareAxes();
+
+    qint64 dataBytes = m_nodeCount * 2 * m_nTime * (qint64)sizeof(float);
+    if (m_nodeCount != header.nodeCount || header.dataOffset + dataBytes > fileSize) {
+        qWarning() << "图版文件数据区不完整:" << path;
+        unload();
+        return false;
+    }
+
+    m_data = reinterpret_cast<const float*>(m_map + header.dataOffset);
+    return true;
+}
+
+void TypeCurveAtlas::unload()
+{
+    m_data = nullptr;
+    m_ownedData.clear();
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) m_file.close();
+    m_axes.clear();
+    m_axisT.clear();
+    m_baseParams.clear();
+    m_nodeCount = 0;
+}
+
+bool TypeCurveAtlas::interpolateDimensionless(const QMap<QString, double>& params,
+                                              QVector<double>& logPD, QVector<double>& logDeriv) const
+{
+    if (!isValid()) return false;
+
+    const int nAxes = m_axes.size();
+    QVector<int> lo(nAxes, 0);
+    QVector<double> frac(nAxes, 0.0);
+
+    // 1. 在各轴上定位网格单元 (超出范围时截断到边界)
+    for (int a = 0; a < nAxes; ++a) {
+        const AtlasAxis& axis = m_axes[a];
+        int n = axis.values.size();
+        if (n < 2) continue;
+
+        double x = axisParamValue(axis.name, params);
+        double tx = axis.logScale ? std::log10(qMax(x, 1e-300)) : x;
+        const double* T = m_axisT.constData() + m_axisOffset[a];
+
+        int i = int(std::upper_bound(T, T + n, tx) - T) - 1;
+        i = qBound(0, i, n - 2);
+        lo[a] = i;
+        frac[a] = qBound(0.0, (tx - T[i]) / (T[i + 1] - T[i]), 1.0);
+    }
+
+    // 2. 对 2^D 个角点加权求和 (权重为 0 的角点跳过)
+    logPD.fill(0.0, m_nTime);
+    logDeriv.fill(0.0, m_nTime);
+    const int corners = 1 << nAxes;
+    for (int c = 0; c < corners; ++c) {
+        double w = 1.0;
+        qint64 node = 0;
+        for (int a = 0; a < nAxes && w > 0.0; ++a) {
+            int bit = (c >> a) & 1;
+            if (bit && m_axes[a].values.size() < 2) { w = 0.0; break; }
+            w *= bit ? frac[a] : (1.0 - frac[a]);
+            node += (lo[a] + bit) * m_strides[a];
+        }
+        if (w <= 0.0) continue;
+
+        const float* lp = nodeLogPressure(node);
+        const float* ld = nodeLogDerivative(node);
+        for (int i = 0; i < m_nTime; ++i) {
+            logPD[i] += w * lp[i];
+            logDeriv[i] += w * ld[i];
+        }
+    }
+    return true;
+}
+
+bool TypeCurveAtlas::evaluate(const QMap<QString, double>& params, const QVector<double>& t, ModelCurveData& out) const
+{
+    QVector<double> logPD, logDeriv;
+    if (!interpolateDimensionless(params, logPD, logDeriv)) return false;
+
+    QVector<double> tPoints = t;
+    if (tPoints.isEmpty()) tPoints = ModelManager::generateLogTimeSteps(100, -3.0, 3.0);
+
+    // 量纲换算与 ModelSolver01_06::calculateTheoreticalCurve 保持一致
+    double phi = params.value("phi", 0.05);
+    double mu = params.value("mu", 0.5);
+    double B = params.value("B", 1.05);
+    double Ct = params.value("Ct", 5e-4);
+    double q = params.value("q", 5.0);
+    double h = params.value("h", 20.0);
+    double kf = params.value("kf", 1e-3);
+    double L = params.value("L", 1000.0);
+    double gamaD = params.value("gamaD", 0.0);
+
+    double timeScale = 14.4 * kf / (phi * mu * Ct * L * L);
+    double factor = 1.842e-3 * q * mu * B / (kf * h);
+    double dlog = (m_logTdMax - m_logTdMin) / (m_nTime - 1);
+
+    QVector<double> P(tPoints.size(), 0.0), DP(tPoints.size(), 0.0);
+    for (int k = 0; k < tPoints.size(); ++k) {
+        double tD = timeScale * tPoints[k];
+        if (tD <= 1e-12) continue;
+
+        double x = (std::log10(tD) - m_logTdMin) / dlog;
+        int i = qBound(0, (int)std::floor(x), m_nTime - 2);
+        double f = qBound(0.0, x - i, 1.0);
+        double pD = std::pow(10.0, logPD[i] + f * (logPD[i + 1] - logPD[i]));
+        double dD = std::pow(10.0, logDeriv[i] + f * (logDeriv[i + 1] - logDeriv[i]));
+
+        // 压敏效应: pD → -ln(1-γpD)/γ，对数导数同乘 1/(1-γpD)
+        if (std::abs(gamaD) > 1e-9) {
+            double arg = 1.0 - gamaD * pD;
+            if (arg > 1e-12) {
+                pD = -std::log(arg) / gamaD;
+                dD = dD / arg;
+            }
+        }
+        P[k] = factor * pD;
+        DP[k] = factor * dD;
+    }
+
+    out = std::make_tuple(tPoints, P, DP);
+    return true;
+}
+
+int TypeCurveAtlas::runGeneratorCli(const QStringList& args)
+{
+    QTextStream out(stdout);
+    QString outDir;
+    int modelFilter = 0;
+    int nTime = 60;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--generate-atlas" && i + 1 < args.size()) outDir = args[++i];
+        else if (args[i] == "--model" && i + 1 < args.size()) modelFilter = args[++i].toInt();
+        else if (args[i] == "--points" && i + 1 < args.size()) nTime = args[++i].toInt();
+    }
+    if (outDir.isEmpty()) {
+        out << "用法: WellTest --generate-atlas <输出目录> [--model <1-6>] [--points <时间点数>]\n";
+        return 1;
+    }
+    QDir().mkpath(outDir);
+
+    QMutex outMutex;
+    for (int i = 0; i < 6; ++i) {
+        if (modelFilter > 0 && modelFilter != i + 1) continue;
+        ModelType type = static_cast<ModelType>(i);
+
+        out << "生成图版: " << ModelManager::getModelTypeName(type) << "\n";
+        out.flush();
+        QElapsedTimer timer;
+        timer.start();
+
+        QSharedPointer<TypeCurveAtlas> atlas = generate(type, defaultAxes(type), defaultBaseParams(), nTime, -4.0, 6.0, 8,
+            [&](int done, int total) {
+                if (done % 200 != 0 && done != total) return;
+                QMutexLocker locker(&outMutex);
+                out << QString("  %1 / %2\r").arg(done).arg(total);
+                out.flush();
+            });
+
+        QString path = QDir(outDir).filePath(defaultFileName(type));
+        if (!atlas->save(path)) {
+            out << "\n写入失败: " << path << "\n";
+            return 2;
+        }
+        out << QString("\n  完成: %1 个节点, 用时 %2 s -> %3\n")
+                   .arg(atlas->nodeCount()).arg(timer.elapsed() / 1000.0, 0, 'f', 1).arg(path);
+        out.flush();
+    }
+    return 0;
+}
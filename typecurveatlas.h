@@ -0,0 +1,112 @@
+/*
+ * typecurveatlas.h
+ * 文件作用: 类型曲线图版 (Type-Curve Atlas) 头文件
+ * 功能描述:
+ * 1. 离线按参数网格 (LfD, M12, omega1, lambda1, nf, reD, cD, S) 预先计算各模型的
+ *    无因次压力 pD 与导数曲线，并行生成，保存为紧凑的二进制图版文件 (*.wta)。
+ * 2. 运行时以内存映射方式加载图版文件，不做整体读取与拷贝。
+ * 3. 通过对数空间的多线性插值，瞬时给出任意参数组合的近似曲线，
+ *    供模型界面预览、参数滑块联动等交互场景使用 (精确结果仍由 ModelSolver 计算)。
+ * 4. 未进入网格的参数 (rmD, omega2 等) 固定为生成时的基准值，记录在文件头中；
+ *    压敏系数 gamaD 在插值后解析叠加，不占用网格维度。
+ */
+
+#ifndef TYPECURVEATLAS_H
+#define TYPECURVEATLAS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QFile>
+#include <QSharedPointer>
+#include <functional>
+
+#include "modelenums.h"
+#include "modelsolver01_06.h"
+
+// 图版网格坐标轴
+struct AtlasAxis {
+    QString name;           // 参数名 (M12 表示渗透率比 kf/km)
+    bool logScale;          // 是否在对数空间插值
+    QVector<double> values; // 网格节点 (严格升序)
+};
+
+class TypeCurveAtlas
+{
+public:
+    TypeCurveAtlas();
+    ~TypeCurveAtlas();
+
+    // 图版文件的默认文件名 (atlas_model1.wta ... atlas_model6.wta)
+    static QString defaultFileName(ModelType type);
+
+    // 各模型的默认网格 (无限大模型不含 reD 轴，恒定井储模型不含 cD/S 轴)
+    static QVector<AtlasAxis> defaultAxes(ModelType type);
+
+    // 并行生成图版 (QtConcurrent)，progress(已完成节点数, 总节点数) 在工作线程中回调
+    // cancel 被取消时未开始的节点直接跳过，返回空指针
+    static QSharedPointer<TypeCurveAtlas> generate(ModelType type,
+                                                   const QVector<AtlasAxis>& axes,
+                                                   const QMap<QString, double>& baseParams,
+                                                   int nTime = 60, double logTdMin = -4.0, double logTdMax = 6.0,
+                                                   int stehfestN = 8,
+                                                   std::function<void(int, int)> progress = nullptr,
+                                                   const CancellationToken& cancel = CancellationToken());
+
+    // 离线生成命令行入口: --generate-atlas <输出目录> [--model <1-6>] [--points <n>]
+    static int runGeneratorCli(const QStringList& args);
+
+    // 保存 / 以内存映射方式加载图版文件
+    bool save(const QString& path) const;
+    bool load(const QString& path);
+
+    bool isValid() const { return m_data != nullptr; }
+    ModelType modelType() const { return m_type; }
+    const QVector<AtlasAxis>& axes() const { return m_axes; }
+    qint64 nodeCount() const { return m_nodeCount; }
+    int timeCount() const { return m_nTime; }
+    QVector<double> timeGrid() const;
+
+    // 读取第 node 个网格节点的参数组合 (供初值搜索等按节点遍历的场合)
+    QMap<QString, double> nodeParams(qint64 node) const;
+    // 第 node 个节点的 log10(pD) 与 log10(导数) 数据 (各 timeCount() 个)
+    const float* nodeLogPressure(qint64 node) const { return m_data + node * 2 * m_nTime; }
+    const float* nodeLogDerivative(qint64 node) const { return m_data + node * 2 * m_nTime + m_nTime; }
+
+    // 插值得到无因次曲线 (在 timeGrid() 上)，返回 log10(pD) 与 log10(导数)
+    bool interpolateDimensionless(const QMap<QString, double>& params,
+                                  QVector<double>& logPD, QVector<double>& logDeriv) const;
+
+    // 插值得到有量纲预览曲线 (量纲换算与 ModelSolver01_06 一致)
+    bool evaluate(const QMap<QString, double>& params, const QVector<double>& t, ModelCurveData& out) const;
+
+    // 图版网格参数在给定参数表中的取值 (M12 = kf/km，LfD 缺省时取 Lf/L)
+    static double axisParamValue(const QString& axisName, const QMap<QString, double>& params);
+    // 把网格参数写回模型参数表 (M12 换算为 km = kf/M12，LfD 同步 Lf = LfD·L)
+    static void setAxisParam(QMap<QString, double>& params, const QString& axisName, double value);
+
+private:
+    void unload();
+    void prepareAxes();
+
+    ModelType m_type;
+    QVector<AtlasAxis> m_axes;
+    QVector<double> m_axisT;         // 各轴节点变换后的坐标 (对数轴取 log10)，按轴顺序拼接
+    QVector<int> m_axisOffset;       // 各轴在 m_axisT 中的起始位置
+    QVector<qint64> m_strides;       // 各轴在节点序号中的步长 (最后一轴最快)
+    QMap<QString, double> m_baseParams;
+    int m_nTime;
+    double m_logTdMin;
+    double m_logTdMax;
+    qint64 m_nodeCount;
+
+    const float* m_data;             // 指向节点数据 (映射内存或 m_ownedData)
+    QVector<float> m_ownedData;      // 内存中生成的图版
+    QFile m_file;                    // 内存映射的图版文件
+    uchar* m_map;
+
+    Q_DISABLE_COPY(TypeCurveAtlas)
+};
+
+#endif // TYPECURVEATLAS_H
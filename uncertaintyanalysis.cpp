@@ -0,0 +1,267 @@
+/*
+ * uncertaintyanalysis.cpp
+ * 文件作用: 参数不确定性分析实现文件
+ * 功能描述:
+ * 1. 雅可比只分解一次 (SVD)，协方差、抽样矩阵与自助法重拟合的伪逆共用该分解。
+ * 2. 蒙特卡洛样本与自助法样本均用 QtConcurrent::blockingMap 并行计算，
+ *    每个样本写入各自的结果行，无需加锁。
+ */
+
+#include "uncertaintyanalysis.h"
+
+#include <QtConcurrent>
+#include <QAtomicInt>
+#include <random>
+#include <numeric>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 在迭代坐标中对参数施加增量并截断到上下限
+void applyDelta(const CompiledFitParams& spec, const QVector<int>& ids, const Eigen::VectorXd& delta,
+                const ParamVector& from, ParamVector& to)
+{
+    to = from;
+    for (int j = 0; j < ids.size(); ++j) {
+        int id = ids[j];
+        double v = ParameterSchema::applyStep(id, from[id], delta(j));
+        to[id] = qMax(spec.lower[id], qMin(v, spec.upper[id]));
+    }
+    ParameterSchema::applyDependencies(to);
+}
+
+} // namespace
+
+double UncertaintyAnalysis::twoSidedNormalQuantile(double confidence)
+{
+    // 二分求解 erfc(z/√2) = 1 - confidence
+    double target = 1.0 - qBound(1e-9, confidence, 1.0 - 1e-9);
+    double lo = 0.0, hi = 10.0;
+    for (int i = 0; i < 80; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (std::erfc(mid / std::sqrt(2.0)) > target) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+double UncertaintyAnalysis::quantile(QVector<double>& values, double q)
+{
+    if (values.isEmpty()) return std::numeric_limits<double>::quiet_NaN();
+    std::sort(values.begin(), values.end());
+    double pos = qBound(0.0, q, 1.0) * (values.size() - 1);
+    int k = (int)pos;
+    if (k >= values.size() - 1) return values.last();
+    double frac = pos - k;
+    return values[k] * (1.0 - frac) + values[k + 1] * frac;
+}
+
+UncertaintyResult UncertaintyAnalysis::analyze(const CompiledFitParams& spec,
+                                               const Eigen::MatrixXd& J,
+                                               const QVector<double>& residuals,
+                                               int nPressureRows,
+                                               const ResidualFunction& residualFn,
+                                               const CurveFunction& curveFn,
+                                               const QVector<double>& bandTime,
+                                               const UncertaintyOptions& options,
+                                               const CancellationToken& cancel,
+                                               std::function<void(int, int)> progress)
+{
+    UncertaintyResult result;
+    result.confidence = options.confidence;
+
+    // 1. 参与分析的列 (排除整数参数 nf)
+    QVector<int> ids, cols;
+    for (int j = 0; j < spec.fitIds.size(); ++j) {
+        if (spec.fitIds[j] == Param_nf) continue;
+        ids.append(spec.fitIds[j]);
+        cols.append(j);
+    }
+    const int m = residuals.size();
+    const int n = ids.size();
+    if (n == 0) { result.message = "没有可分析的拟合参数。"; return result; }
+    if (J.rows() != m || J.cols() != spec.fitIds.size()) { result.message = "雅可比矩阵与残差维数不一致。"; return result; }
+    if (m <= n) { result.message = "数据点数不足 (自由度 ≤ 0)。"; return result; }
+
+    Eigen::MatrixXd Jr(m, n);
+    for (int j = 0; j < n; ++j) Jr.col(j) = J.col(cols[j]);
+    Eigen::Map<const Eigen::VectorXd> r0(residuals.constData(), m);
+
+    result.nResiduals = m;
+    result.dof = m - n;
+    result.sigma2 = r0.squaredNorm() / result.dof;
+
+    // 2. 线性化协方差: Cov = s²·V·Σ⁻²·Vᵀ (奇异值过小的方向视为不可辨识)
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(Jr, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    const Eigen::VectorXd& sv = svd.singularValues();
+    double svTol = sv.size() > 0 ? sv(0) * 1e-10 : 0.0;
+    Eigen::VectorXd svInv(n);
+    int rank = 0;
+    for (int k = 0; k < n; ++k) {
+        svInv(k) = (sv(k) > svTol) ? 1.0 / sv(k) : 0.0;
+        if (sv(k) > svTol) rank++;
+    }
+    if (rank < n) {
+        result.message = "雅可比矩阵秩亏，部分参数不可辨识，请减少拟合参数。";
+        return result;
+    }
+
+    const Eigen::MatrixXd& V = svd.matrixV();
+    Eigen::MatrixXd cov = result.sigma2 * V * svInv.cwiseAbs2().asDiagonal() * V.transpose();
+    Eigen::VectorXd se = cov.diagonal().cwiseMax(0.0).cwiseSqrt();
+    result.correlation = cov;
+    for (int a = 0; a < n; ++a) {
+        for (int b = 0; b < n; ++b) {
+            double d = se(a) * se(b);
+            result.correlation(a, b) = (d > 0.0) ? cov(a, b) / d : (a == b ? 1.0 : 0.0);
+        }
+    }
+
+    const double z = twoSidedNormalQuantile(options.confidence);
+    const double qLo = 0.5 * (1.0 - options.confidence);
+    const double qHi = 1.0 - qLo;
+    for (int j = 0; j < n; ++j) {
+        int id = ids[j];
+        double v = spec.values[id];
+        ParameterInterval iv;
+        iv.id = id;
+        iv.value = v;
+        iv.logScale = ParameterSchema::usesLog(id, v);
+        iv.stdError = se(j);
+        iv.linearLower = qMax(spec.lower[id], ParameterSchema::applyStep(id, v, -z * se(j)));
+        iv.linearUpper = qMin(spec.upper[id], ParameterSchema::applyStep(id, v, z * se(j)));
+        iv.bootstrapLower = iv.linearLower;
+        iv.bootstrapUpper = iv.linearUpper;
+        result.intervals.append(iv);
+    }
+
+    const int draws = qMax(0, options.draws);
+    const int boots = qMax(0, options.bootstrapSamples);
+    const int total = draws + boots;
+    QAtomicInt done(0);
+    auto reportProgress = [&]() {
+        int k = done.fetchAndAddRelaxed(1) + 1;
+        if (progress) progress(k, total);
+    };
+
+    // 3. 蒙特卡洛传播: x = x̂ + s·V·Σ⁻¹·ξ，ξ ~ N(0, I)
+    if (!bandTime.isEmpty() && curveFn && draws > 0) {
+        const int nb = bandTime.size();
+        result.bandTime = bandTime;
+        const Eigen::MatrixXd L = std::sqrt(result.sigma2) * V * svInv.asDiagonal();
+
+        // 每个样本独占一行: pRows[s*nb + i]
+        QVector<double> pRows(draws * nb, std::numeric_limits<double>::quiet_NaN());
+        QVector<double> dRows(draws * nb, std::numeric_limits<double>::quiet_NaN());
+        QVector<int> indices(draws);
+        std::iota(indices.begin(), indices.end(), 0);
+
+        QtConcurrent::blockingMap(indices, [&](int s) {
+            if (cancel.isCancelled()) return;
+            std::mt19937 rng(options.seed + 104729u * (quint32)s + 1u);
+            std::normal_distribution<double> normal(0.0, 1.0);
+            Eigen::VectorXd xi(n);
+            for (int k = 0; k < n; ++k) xi(k) = normal(rng);
+
+            ParamVector theta;
+            applyDelta(spec, ids, L * xi, spec.values, theta);
+            ModelCurveData curve = curveFn(theta);
+            const QVector<double>& p = std::get<1>(curve);
+            const QVector<double>& d = std::get<2>(curve);
+            if (p.size() == nb && d.size() == nb) {
+                std::copy(p.constBegin(), p.constEnd(), pRows.begin() + s * nb);
+                std::copy(d.constBegin(), d.constEnd(), dRows.begin() + s * nb);
+            }
+            reportProgress();
+        });
+        if (cancel.isCancelled()) { result.message = "分析已停止。"; return result; }
+
+        result.pressureLower.resize(nb); result.pressureUpper.resize(nb);
+        result.derivativeLower.resize(nb); result.derivativeUpper.resize(nb);
+        QVector<double> column;
+        column.reserve(draws);
+        for (int i = 0; i < nb; ++i) {
+            column.clear();
+            for (int s = 0; s < draws; ++s) {
+                double v = pRows[s * nb + i];
+                if (std::isfinite(v) && v > 0.0) column.append(v);
+            }
+            result.pressureLower[i] = quantile(column, qLo);
+            result.pressureUpper[i] = quantile(column, qHi);
+            if (i == 0) result.drawsUsed = column.size();
+
+            column.clear();
+            for (int s = 0; s < draws; ++s) {
+                double v = dRows[s * nb + i];
+                if (std::isfinite(v) && v > 0.0) column.append(v);
+            }
+            result.derivativeLower[i] = quantile(column, qLo);
+            result.derivativeUpper[i] = quantile(column, qHi);
+        }
+    }
+
+    // 4. 残差自助法: r*(θ) = r(θ) + (e* - r̂)，e* 为 r̂ 在各自分组内的重抽样
+    if (boots > 0 && residualFn) {
+        const int nP = qBound(0, nPressureRows, m);
+        // 伪逆 J⁺ = V·Σ⁻¹·Uᵀ 由全部重拟合共用
+        const Eigen::MatrixXd pinv = V * svInv.asDiagonal() * svd.matrixU().transpose();
+
+        QVector<double> samples(boots * n, std::numeric_limits<double>::quiet_NaN());
+        QVector<int> indices(boots);
+        std::iota(indices.begin(), indices.end(), 0);
+
+        QtConcurrent::blockingMap(indices, [&](int b) {
+            if (cancel.isCancelled()) return;
+            std::mt19937 rng(options.seed ^ (0x9E3779B9u + 7919u * (quint32)b));
+            Eigen::VectorXd offset(m);
+            if (nP > 0) {
+                std::uniform_int_distribution<int> pick(0, nP - 1);
+                for (int i = 0; i < nP; ++i) offset(i) = residuals[pick(rng)] - residuals[i];
+            }
+            if (m > nP) {
+                std::uniform_int_distribution<int> pick(nP, m - 1);
+                for (int i = nP; i < m; ++i) offset(i) = residuals[pick(rng)] - residuals[i];
+            }
+
+            // 冻结雅可比的简化 Gauss-Newton: θ ← θ - J⁺·r*(θ)
+            ParamVector theta = spec.values;
+            bool ok = true;
+            for (int it = 0; it < qMax(1, options.refitIterations); ++it) {
+                QVector<double> r = residualFn(theta);
+                if (cancel.isCancelled() || r.size() != m) { ok = false; break; }
+                Eigen::Map<const Eigen::VectorXd> rv(r.constData(), m);
+                Eigen::VectorXd delta = -(pinv * (rv + offset));
+                ParamVector next;
+                applyDelta(spec, ids, delta, theta, next);
+                theta = next;
+                if (delta.norm() < 1e-6) break;
+            }
+            if (ok) {
+                for (int j = 0; j < n; ++j) samples[b * n + j] = theta[ids[j]];
+            }
+            reportProgress();
+        });
+        if (cancel.isCancelled()) { result.message = "分析已停止。"; return result; }
+
+        QVector<double> column;
+        column.reserve(boots);
+        for (int j = 0; j < n; ++j) {
+            column.clear();
+            for (int b = 0; b < boots; ++b) {
+                double v = samples[b * n + j];
+                if (std::isfinite(v)) column.append(v);
+            }
+            if (j == 0) result.bootstrapUsed = column.size();
+            // 有效样本过少时保留线性化区间
+            if (column.size() >= 20) {
+                result.intervals[j].bootstrapLower = quantile(column, qLo);
+                result.intervals[j].bootstrapUpper = quantile(column, qHi);
+            }
+        }
+    }
+
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,98 @@
+/*
+ * uncertaintyanalysis.h
+ * 文件作用: 拟合结果的参数不确定性分析头文件
+ * 功能描述:
+ * 1. 线性化协方差: 由最终雅可比 J 的奇异值分解得到 Cov = s²·(JᵀJ)⁻¹，
+ *    s² = SSE / (m - n)；对数参数在 log10 坐标中计算，区间换算回原值后不对称。
+ * 2. 蒙特卡洛传播: 按线性化协方差抽取大量参数样本，在线程池中并行计算理论曲线，
+ *    逐时间点取分位数得到压差与导数的置信带，绘制在双对数图上。
+ * 3. 残差自助法: 在压差、导数两组残差内分别有放回重抽样构造合成数据，
+ *    以冻结的最终雅可比做若干步简化 Gauss-Newton 重拟合 (每步一次曲线计算)，
+ *    由重拟合参数的分位数给出参数区间 (可反映非线性与残差非正态)。
+ * 4. 全部样本以 (种子, 样本序号) 决定随机数，结果与线程调度无关；支持取消令牌。
+ * 5. 裂缝条数 nf 为整数参数，不参与不确定性分析。
+ */
+
+#ifndef UNCERTAINTYANALYSIS_H
+#define UNCERTAINTYANALYSIS_H
+
+#include <QVector>
+#include <QString>
+#include <functional>
+#include <Eigen/Dense>
+
+#include "modelenums.h"
+#include "modelsolver01_06.h"
+#include "parameterschema.h"
+#include "cancellationtoken.h"
+
+// 分析设置
+struct UncertaintyOptions {
+    int draws = 500;                // 蒙特卡洛参数样本数 (曲线置信带)
+    int bootstrapSamples = 200;     // 残差自助法重拟合次数 (参数区间)
+    int refitIterations = 4;        // 每次重拟合的 Gauss-Newton 步数
+    int bandPoints = 60;            // 置信带的时间点数 (由调用方生成对数等间距时间)
+    double confidence = 0.95;       // 置信水平
+    quint32 seed = 12345;           // 随机种子
+};
+
+// 单个参数的区间估计
+struct ParameterInterval {
+    int id;                 // ParamId
+    double value;           // 拟合值
+    bool logScale;          // 是否在 log10 坐标中估计
+    double stdError;        // 迭代坐标中的标准误差 (对数参数为 log10 单位)
+    double linearLower;     // 线性化区间
+    double linearUpper;
+    double bootstrapLower;  // 自助法区间 (样本不足时等于线性化区间)
+    double bootstrapUpper;
+};
+
+// 分析结果
+struct UncertaintyResult {
+    bool valid = false;
+    QString message;                // 无法分析时的原因
+    double confidence = 0.95;
+    int nResiduals = 0;
+    int dof = 0;                    // 自由度 m - n
+    double sigma2 = 0.0;            // 残差方差估计 s²
+    QVector<ParameterInterval> intervals;
+    Eigen::MatrixXd correlation;    // 参数相关系数矩阵 (与 intervals 顺序一致)
+
+    QVector<double> bandTime;       // 置信带
+    QVector<double> pressureLower, pressureUpper;
+    QVector<double> derivativeLower, derivativeUpper;
+    int drawsUsed = 0;              // 有效的蒙特卡洛样本数
+    int bootstrapUsed = 0;          // 有效的自助法样本数
+};
+
+class UncertaintyAnalysis
+{
+public:
+    // 残差函数: 与拟合时的残差定义一致 (先压差项 nPressureRows 行，后导数项)，需可在多线程中调用
+    using ResidualFunction = std::function<QVector<double>(const ParamVector&)>;
+    // 曲线函数: 返回 bandTime 上的理论曲线 (定产量或变产量叠加)，需可在多线程中调用
+    using CurveFunction = std::function<ModelCurveData(const ParamVector&)>;
+
+    // spec.values 为拟合结果，J 与 residuals 为该点的雅可比 (列与 spec.fitIds 对应，迭代坐标) 与残差。
+    // progress(已完成样本数, 总样本数) 在工作线程中回调。
+    static UncertaintyResult analyze(const CompiledFitParams& spec,
+                                     const Eigen::MatrixXd& J,
+                                     const QVector<double>& residuals,
+                                     int nPressureRows,
+                                     const ResidualFunction& residualFn,
+                                     const CurveFunction& curveFn,
+                                     const QVector<double>& bandTime,
+                                     const UncertaintyOptions& options,
+                                     const CancellationToken& cancel = CancellationToken(),
+                                     std::function<void(int, int)> progress = nullptr);
+
+    // 标准正态分布的双侧分位点 z (P(|Z| <= z) = confidence)
+    static double twoSidedNormalQuantile(double confidence);
+
+private:
+    // 样本分位数 (线性插值)，会重排 values
+    static double quantile(QVector<double>& values, double q);
+};
+
+#endif // UNCERTAINTYANALYSIS_H
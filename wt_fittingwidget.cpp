@@ -17,6 +17,8 @@
 #include "pressurederivativecalculator.h"
 #include "pressurederivativecalculator1.h"
 #include "modelenums.h" // [新增] 引入公共枚举
+#include "initialguesssearch.h"
+#include "numericexport.h"
 
 #include <QtConcurrent>
 #include <QMessageBox>
@@ -34,8 +36,11 @@
 #include <QComboBox>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QDateTime>
-#include <QBuffer>
+#include <QMutex>
+#include <QAtomicInt>
+#include <random>
+#include <numeric>
+#include <limits>
 #include <Eigen/Dense>
 
 // ===========================================================================
@@ -49,7 +54,15 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_projectModel(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(Model_1), // [修改] 使用公共枚举值
-    m_isFitting(false)
+    m_dragMatching(false),
+    m_isFitting(false),
+    m_useInitialSearch(true),
+    m_fitMode(FitMode_LM),
+    m_randomSeed(12345),
+    m_useBroyden(true),
+    m_useGeodesic(false),
+    m_useAdaptivePrecision(true),
+    m_livePending(false)
 {
     ui->setupUi(this);
 
@@ -59,9 +72,20 @@ FittingWidget::FittingWidget(QWidget *parent) :
 
     m_paramChart = new FittingParameterChart(ui->tableParams, this);
 
+    m_livePreview = new LiveCurvePreview(this);
+    m_liveSettleTimer.setSingleShot(true);
+    m_liveSettleTimer.setInterval(LiveSettleDelay);
+    connect(m_paramChart, &FittingParameterChart::parameterSliding, this, &FittingWidget::onParameterSliding);
+    connect(m_paramChart, &FittingParameterChart::sliderReleased, this, &FittingWidget::onSliderSettled);
+    connect(&m_liveSettleTimer, &QTimer::timeout, this, &FittingWidget::onSliderSettled);
+    connect(m_livePreview, &LiveCurvePreview::curveReady, this, &FittingWidget::onLiveCurveReady);
+
     m_plot = new MouseZoom(this);
     ui->plotContainer->layout()->addWidget(m_plot);
     setupPlot();
+    connect(m_plot, &QCustomPlot::mousePress, this, &FittingWidget::onPlotMousePress);
+    connect(m_plot, &QCustomPlot::mouseMove, this, &FittingWidget::onPlotMouseMove);
+    connect(m_plot, &QCustomPlot::mouseRelease, this, &FittingWidget::onPlotMouseRelease);
 
     // 注册自定义数据类型
     qRegisterMetaType<QMap<QString,double>>("QMap<QString,double>");
@@ -69,7 +93,8 @@ FittingWidget::FittingWidget(QWidget *parent) :
     qRegisterMetaType<ModelType>("ModelType");
     qRegisterMetaType<QVector<double>>("QVector<double>");
 
-    connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
+    m_progressTimer.setInterval(ProgressPollInterval);
+    connect(&m_progressTimer, &QTimer::timeout, this, &FittingWidget::pollFitProgress);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
     connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::onSliderWeightChanged);
@@ -151,6 +176,16 @@ void FittingWidget::setupPlot() {
 
     m_plot->xAxis->setRange(1e-3, 1e3); m_plot->yAxis->setRange(1e-3, 1e2);
 
+    // 实测数据、置信带、理论曲线各占一个缓冲图层: 拟合迭代中只重绘理论曲线图层
+    // (resetAnalysis 会再次调用 setupPlot，图层只在首次创建)
+    if(!m_plot->layer(ObservedLayer)) {
+        m_plot->addLayer(ObservedLayer, m_plot->layer("main"), QCustomPlot::limAbove);
+        m_plot->addLayer(OverlayLayer, m_plot->layer(ObservedLayer), QCustomPlot::limAbove);
+        m_plot->addLayer(ModelLayer, m_plot->layer(OverlayLayer), QCustomPlot::limAbove);
+        for(const char* name : {ObservedLayer, OverlayLayer, ModelLayer})
+            m_plot->layer(name)->setMode(QCPLayer::lmBuffered);
+    }
+
     m_plot->addGraph(); m_plot->graph(0)->setPen(Qt::NoPen);
     m_plot->graph(0)->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, QColor(0, 100, 0), 6));
     m_plot->graph(0)->setName("实测压差");
@@ -165,6 +200,9 @@ void FittingWidget::setupPlot() {
     m_plot->addGraph(); m_plot->graph(3)->setPen(QPen(Qt::blue, 2));
     m_plot->graph(3)->setName("理论导数");
 
+    m_plot->graph(0)->setLayer(ObservedLayer); m_plot->graph(1)->setLayer(ObservedLayer);
+    m_plot->graph(2)->setLayer(ModelLayer); m_plot->graph(3)->setLayer(ModelLayer);
+
     m_plot->legend->setVisible(true);
     m_plot->legend->setFont(QFont("Arial", 9));
     m_plot->legend->setBrush(QBrush(QColor(255, 255, 255, 200)));
@@ -186,7 +224,7 @@ void FittingWidget::on_btnLoadData_clicked() {
         return;
     }
 
-    QVector<double> rawTime, rawPressureData, finalDeriv;
+    QVector<double> rawTime, rawPressureData, finalDeriv, rawRate;
     int skip = settings.skipRows;
     int rows = sourceModel->rowCount();
 
@@ -206,6 +244,10 @@ void FittingWidget::on_btnLoadData_clicked() {
                     if (itemD) finalDeriv.append(itemD->text().toDouble());
                     else finalDeriv.append(0.0);
                 }
+                if (settings.rateColIndex >= 0) {
+                    QStandardItem* itemQ = sourceModel->item(i, settings.rateColIndex);
+                    rawRate.append(itemQ ? itemQ->text().toDouble() : 0.0);
+                }
             }
         }
     }
@@ -243,6 +285,12 @@ void FittingWidget::on_btnLoadData_clicked() {
     }
 
     setObservedData(rawTime, finalDeltaP, finalDeriv);
+    if (settings.rateColIndex >= 0) {
+        RateHistory history = RateHistory::fromSamples(rawTime, rawRate);
+        setRateHistory(history);
+        QMessageBox::information(this, "成功", QString("观测数据已成功加载，产量历史共 %1 个阶段，将按变产量叠加计算。").arg(history.size()));
+        return;
+    }
     QMessageBox::information(this, "成功", "观测数据已成功加载。");
 }
 
@@ -250,25 +298,27 @@ void FittingWidget::setObservedData(const QVector<double>& t, const QVector<doub
     m_obsTime = t;
     m_obsDeltaP = deltaP;
     m_obsDerivative = d;
+    // 叠加算子与观测时间绑定，新数据默认定产量
+    m_rateSuperposition.reset();
 
-    QVector<double> vt, vp, vd;
-    for(int i=0; i<t.size(); ++i) {
-        if(t[i]>1e-8 && deltaP[i]>1e-8) {
-            vt << t[i];
-            vp << deltaP[i];
-            if(i < d.size() && d[i] > 1e-8) vd << d[i];
-            else vd << 1e-10;
-        }
-    }
-
-    m_plot->graph(0)->setData(vt, vp);
-    m_plot->graph(1)->setData(vt, vd);
+    // 实测散点可达百万点级，按视图抽稀显示；曲线直接引用观测数据列，非正值由过滤条件排除
+    m_plot->setLodData(m_plot->graph(0), PlotSeries::positive(m_obsTime, m_obsDeltaP));
+    m_plot->setLodData(m_plot->graph(1), PlotSeries::positive(m_obsTime, m_obsDerivative));
     m_plot->rescaleAxes();
     if(m_plot->xAxis->range().lower <= 0) m_plot->xAxis->setRangeLower(1e-3);
     if(m_plot->yAxis->range().lower <= 0) m_plot->yAxis->setRangeLower(1e-3);
     m_plot->replot();
 }
 
+void FittingWidget::setRateHistory(const RateHistory& history) {
+    m_rateSuperposition.reset();
+    if(history.isEmpty() || m_obsTime.isEmpty()) return;
+
+    QSharedPointer<RateSuperposition> op(new RateSuperposition(history, m_obsTime));
+    if(!op->isValid()) return;
+    m_rateSuperposition = op;
+}
+
 // ===========================================================================
 // 交互逻辑槽函数
 // ===========================================================================
@@ -301,8 +351,25 @@ void FittingWidget::on_btnRunFit_clicked() {
 
     m_paramChart->updateParamsFromTable();
     m_isFitting = true;
-    m_stopRequested = false;
+    m_cancelToken = CancellationToken::create();
+    m_liveSettleTimer.stop();
+    m_livePreview->cancel();
+    m_paramChart->setSlidersEnabled(false);
+    clearUncertaintyBands();
+    m_uncertainty = UncertaintyResult();
+    m_useInitialSearch = ui->checkInitialSearch->isChecked();
+    m_fitMode = ui->comboFitMode->currentIndex();
+    m_randomSeed = (quint32)ui->spinSeed->value();
+    m_useBroyden = ui->checkBroyden->isChecked();
+    m_useGeodesic = ui->checkGeodesic->isChecked();
+    m_useAdaptivePrecision = ui->checkAdaptivePrecision->isChecked();
+    m_curveEvalCount.storeRelaxed(0);
+    m_sensitivityEvalCount.storeRelaxed(0);
     ui->btnRunFit->setEnabled(false);
+    ui->label_FitStatus->clear();
+    m_fitStatusLog.clear();
+    m_progressMailbox.clear();
+    m_progressTimer.start();
 
     // 获取当前模型类型
     ModelType modelType = m_currentModelType;
@@ -317,7 +384,136 @@ void FittingWidget::on_btnRunFit_clicked() {
 }
 
 void FittingWidget::on_btnStop_clicked() {
-    m_stopRequested = true;
+    // 正在进行的曲线计算在当前时间点结束后即返回，并行任务随之排空
+    m_cancelToken.cancel();
+}
+
+void FittingWidget::on_btnUncertainty_clicked() {
+    if(m_isFitting) return;
+    if(m_obsTime.isEmpty()) {
+        QMessageBox::warning(this, "错误", "请先加载观测数据并完成拟合。");
+        return;
+    }
+
+    m_paramChart->updateParamsFromTable();
+    m_isFitting = true;
+    m_cancelToken = CancellationToken::create();
+    m_liveSettleTimer.stop();
+    m_livePreview->cancel();
+    m_paramChart->setSlidersEnabled(false);
+    ui->btnRunFit->setEnabled(false);
+    ui->btnUncertainty->setEnabled(false);
+    clearUncertaintyBands();
+
+    ModelType modelType = m_currentModelType;
+    QList<FitParameter> paramsCopy = m_paramChart->getParameters();
+    double w = ui->sliderWeight->value() / 100.0;
+    quint32 seed = (quint32)ui->spinSeed->value();
+    (void)QtConcurrent::run([this, modelType, paramsCopy, w, seed](){
+        runUncertaintyTask(modelType, paramsCopy, w, seed);
+    });
+}
+
+void FittingWidget::runUncertaintyTask(ModelType modelType, QList<FitParameter> params, double weight, quint32 seed) {
+    // 与拟合迭代使用同一精度，保证雅可比与残差一致
+    setFastModelEvaluation(true);
+
+    UncertaintyResult result;
+    CompiledFitParams spec = FittingParameterChart::compileParameters(modelType, params);
+    QVector<double> residuals = calculateResiduals(spec.values, modelType, weight);
+    if(spec.fitIds.isEmpty()) {
+        result.message = "没有勾选拟合参数。";
+    } else if(residuals.isEmpty()) {
+        result.message = m_cancelToken.isCancelled() ? "分析已停止。" : "无法计算残差。";
+    } else {
+        Eigen::MatrixXd J = computeJacobian(spec.values, residuals, spec.fitIds, modelType, weight);
+        UncertaintyOptions options;
+        options.seed = seed;
+        int nPressureRows = qMin(m_obsDeltaP.size(), m_obsTime.size());
+
+        // 置信带时间: 定产量时在观测时间范围内取对数等间距点，变产量时即观测时间
+        QVector<double> bandTime = m_obsTime;
+        if(!m_rateSuperposition) {
+            double tMin = 0.0, tMax = 0.0;
+            for(double t : m_obsTime) {
+                if(t <= 0.0) continue;
+                tMin = (tMin > 0.0) ? qMin(tMin, t) : t;
+                tMax = qMax(tMax, t);
+            }
+            bandTime.clear();
+            if(tMax > tMin) bandTime = ModelManager::generateLogTimeSteps(qMax(10, options.bandPoints), log10(tMin), log10(tMax));
+        }
+        result = UncertaintyAnalysis::analyze(spec, J, residuals, nPressureRows,
+            [this, modelType, weight](const ParamVector& p) { return calculateResiduals(p, modelType, weight); },
+            [this, modelType, bandTime](const ParamVector& p) { return calculateModelCurve(modelType, p, bandTime, m_cancelToken); },
+            bandTime, options, m_cancelToken,
+            [this](int done, int total) { emit sigProgress(done * 100 / qMax(1, total)); });
+    }
+
+    setFastModelEvaluation(false);
+    QMetaObject::invokeMethod(this, [this, result]() { onUncertaintyFinished(result); }, Qt::QueuedConnection);
+}
+
+void FittingWidget::onUncertaintyFinished(const UncertaintyResult& result) {
+    m_isFitting = false;
+    m_paramChart->setSlidersEnabled(true);
+    ui->btnRunFit->setEnabled(true);
+    ui->btnUncertainty->setEnabled(true);
+    if(!result.valid) {
+        QMessageBox::warning(this, "不确定性分析", result.message.isEmpty() ? QString("分析失败。") : result.message);
+        return;
+    }
+
+    m_uncertainty = result;
+    plotUncertaintyBands();
+
+    QString summary = QString("置信度 %1% 的参数区间 (线性化 / 自助法):\n").arg(result.confidence * 100.0, 0, 'g', 3);
+    for(const ParameterInterval& iv : result.intervals) {
+        QString displayName, symbol, uniSym, unit;
+        FittingParameterChart::getParamDisplayInfo(ParameterSchema::nameOf(iv.id), displayName, symbol, uniSym, unit);
+        summary += QString("%1 = %2: [%3, %4] / [%5, %6]\n").arg(displayName).arg(iv.value, 0, 'g', 5)
+                       .arg(iv.linearLower, 0, 'g', 4).arg(iv.linearUpper, 0, 'g', 4)
+                       .arg(iv.bootstrapLower, 0, 'g', 4).arg(iv.bootstrapUpper, 0, 'g', 4);
+    }
+    QMessageBox::information(this, "不确定性分析完成", summary);
+}
+
+void FittingWidget::plotUncertaintyBands() {
+    clearUncertaintyBands();
+    const UncertaintyResult& u = m_uncertainty;
+    if(!u.valid || u.bandTime.isEmpty()) return;
+
+    // 上下限两条曲线之间以半透明通道填充
+    auto addBand = [this, &u](const QVector<double>& lower, const QVector<double>& upper, QColor color, const QString& name) {
+        QCPGraph* gUpper = m_plot->addGraph();
+        QCPGraph* gLower = m_plot->addGraph();
+        gUpper->setData(u.bandTime, upper);
+        gLower->setData(u.bandTime, lower);
+        gUpper->setPen(QPen(color.lighter(140), 1, Qt::DashLine));
+        gLower->setPen(QPen(color.lighter(140), 1, Qt::DashLine));
+        QColor fill = color;
+        fill.setAlpha(40);
+        gUpper->setBrush(QBrush(fill));
+        gUpper->setChannelFillGraph(gLower);
+        gUpper->setName(name);
+        gLower->removeFromLegend();
+        gUpper->setLayer(OverlayLayer);
+        gLower->setLayer(OverlayLayer);
+        m_bandGraphs << gUpper << gLower;
+    };
+    QString level = QString::number(u.confidence * 100.0, 'g', 3);
+    addBand(u.pressureLower, u.pressureUpper, Qt::red, QString("压差 %1% 置信带").arg(level));
+    addBand(u.derivativeLower, u.derivativeUpper, Qt::blue, QString("导数 %1% 置信带").arg(level));
+    m_plot->replot();
+}
+
+void FittingWidget::clearUncertaintyBands() {
+    bool removed = false;
+    for(const QPointer<QCPGraph>& g : m_bandGraphs) {
+        if(g) { m_plot->removeGraph(g.data()); removed = true; }
+    }
+    m_bandGraphs.clear();
+    if(removed) m_plot->replot();
 }
 
 void FittingWidget::on_btnImportModel_clicked() {
@@ -395,14 +591,14 @@ void FittingWidget::on_btnExportData_clicked() {
             QString htmlSym, uniSym, unitStr, dummyName;
             FittingParameterChart::getParamDisplayInfo(param.name, dummyName, htmlSym, uniSym, unitStr);
             if(unitStr == "无因次" || unitStr == "小数") unitStr = "";
-            out << QString("%1,%2,%3,%4\n").arg(param.displayName).arg(uniSym).arg(param.value, 0, 'g', 10).arg(unitStr);
+            out << QString("%1,%2,%3,%4\n").arg(param.displayName).arg(uniSym).arg(NumericExport::toString(param.value)).arg(unitStr);
         }
     } else {
         for(const auto& param : params) {
             QString htmlSym, uniSym, unitStr, dummyName;
             FittingParameterChart::getParamDisplayInfo(param.name, dummyName, htmlSym, uniSym, unitStr);
             if(unitStr == "无因次" || unitStr == "小数") unitStr = "";
-            out << QString("%1 (%2): %3 %4\n").arg(param.displayName).arg(uniSym).arg(param.value, 0, 'g', 10).arg(unitStr);
+            out << QString("%1 (%2): %3 %4\n").arg(param.displayName).arg(uniSym).arg(NumericExport::toString(param.value)).arg(unitStr);
         }
     }
     file.close();
@@ -430,203 +626,504 @@ void FittingWidget::on_btnExportChart_clicked() {
 // ===========================================================================
 
 void FittingWidget::runOptimizationTask(ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+    if(m_useInitialSearch) searchInitialGuess(modelType, fitParams, weight);
+    if(m_fitMode == FitMode_MultiStart) runMultiStartOptimization(modelType, fitParams, weight, m_randomSeed);
+    else runLevenbergMarquardtOptimization(modelType, fitParams, weight);
 }
 
-void FittingWidget::runLevenbergMarquardtOptimization(ModelType modelType, QList<FitParameter> params, double weight) {
-    // 设置模型计算为低精度模式以提高迭代速度
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
+void FittingWidget::searchInitialGuess(ModelType modelType, QList<FitParameter>& params, double weight) {
+    if(!m_modelManager || m_obsTime.isEmpty()) return;
+
+    const ParameterSchema& schema = ParameterSchema::forModel(modelType);
+    CompiledFitParams spec = FittingParameterChart::compileParameters(modelType, params);
+    QMap<QString, double> startMap = schema.toMap(spec.values);
 
-    QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) {
-        if(params[i].isFit) fitIndices.append(i);
+    InitialGuessSearch::Options options;
+    QVector<InitialGuessCandidate> candidates = InitialGuessSearch::search(
+        modelType, params, startMap, m_obsTime, m_obsDeltaP, m_obsDerivative, weight,
+        m_modelManager->typeCurveAtlas(modelType), options, m_cancelToken);
+    if(candidates.isEmpty() || m_cancelToken.isCancelled()) return;
+
+    // 图版距离只是近似，候选与当前起点一起用低精度模型计算真实残差，取最优者作为 LM 起点
+    setFastModelEvaluation(true);
+    QVector<ParamVector> starts;
+    starts.append(spec.values);
+    for(const auto& c : candidates) starts.append(ParameterSchema::fromMap(c.params));
+
+    QVector<double> sse = QtConcurrent::blockingMapped<QVector<double>>(starts, [this, modelType, weight](const ParamVector& p) {
+        return calculateSumSquaredError(calculateResiduals(p, modelType, weight));
+    });
+    if(m_cancelToken.isCancelled()) return;
+
+    int best = 0;
+    for(int i = 1; i < sse.size(); ++i) {
+        if(sse[i] < sse[best]) best = i;
     }
-    int nParams = fitIndices.size();
+    postFitStatus(best > 0
+        ? QString("初值搜索: %1 组候选，采用最优候选 (SSE %2 → %3)").arg(candidates.size()).arg(sse[0], 0, 'e', 3).arg(sse[best], 0, 'e', 3)
+        : QString("初值搜索: %1 组候选，保留原起点").arg(candidates.size()));
+    if(best == 0) return;
+
+    for(auto& p : params) {
+        int id = ParameterSchema::indexOf(p.name);
+        if(p.isFit && id >= 0) p.value = starts[best][id];
+    }
+}
 
-    if(nParams == 0) {
+void FittingWidget::runLevenbergMarquardtOptimization(ModelType modelType, QList<FitParameter> params, double weight) {
+    CompiledFitParams spec = FittingParameterChart::compileParameters(modelType, params);
+    if(spec.fitIds.isEmpty()) {
+        // 多起点拟合可能已切换为低精度模式，提前返回前恢复
+        setFastModelEvaluation(false);
         QMetaObject::invokeMethod(this, "onFitFinished");
         return;
     }
 
-    double lambda = 0.01;
-    int maxIter = 50;
-    double currentSSE = 1e15;
-
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
+    // 设置模型计算为低精度模式以提高迭代速度 (自适应精度时项数由控制器逐步提高)
+    const bool adaptive = m_useAdaptivePrecision && m_modelManager;
+    setFastModelEvaluation(true, adaptive);
 
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+    const int maxIter = 50;
+    // 迭代中参数 N 为控制器的当前项数，回报界面时保留用户设置的 N
+    const double userN = spec.values[Param_N];
+    auto reported = [userN](ParamVector p) { p[Param_N] = userN; return p; };
 
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
-    currentSSE = calculateSumSquaredError(residuals);
+    StehfestPrecisionController precision([this, modelType](const ParamVector& p, const QVector<double>& t) {
+        return m_modelManager->calculateTheoreticalCurve(modelType, p, t, m_cancelToken);
+    }, m_obsTime);
 
     // [调用优化] 这里的 calculateTheoreticalCurve 会通过 Manager 调到 Solver
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    LMRunResult result = runLevenbergMarquardtCore(spec, spec.values, weight, maxIter,
+        [this](int iter) { emit sigProgress(iter * 100 / maxIter); },
+        [this, modelType, &reported, adaptive, &precision](const LMRunResult& state) {
+            // 显示曲线即本步残差计算所用的曲线，不另行计算
+            if(m_cancelToken.isCancelled()) return;
+            QString status;
+            if(adaptive) {
+                status = QString("LM 迭代 %1: Stehfest N = %2，反演误差估计 %3，目标 %4")
+                    .arg(state.iterations).arg(precision.currentN())
+                    .arg(precision.lastError() < 0.0 ? QString("-") : QString::number(precision.lastError(), 'e', 2))
+                    .arg(precision.tolerance(), 0, 'e', 2);
+            }
+            postFitProgress(modelType, state.sse / qMax(1, state.nRes), reported(state.params), state.curve, status);
+        }, adaptive ? &precision : nullptr);
+
+    setFastModelEvaluation(false);
+    // 被停止时保留最后一次接受的结果，不再做高精度重算
+    if(!m_cancelToken.isCancelled()) {
+        // 最终曲线的项数不低于用户设置，也不低于迭代末期控制器认为必要的项数
+        ParamVector finalParams = reported(result.params);
+        if(adaptive) finalParams[Param_N] = qMax((int)userN, precision.currentN());
+        ModelCurveData finalCurve = calculateModelCurve(modelType, finalParams, QVector<double>(), m_cancelToken);
+        if(!m_cancelToken.isCancelled()) {
+            postFitProgress(modelType, result.sse / qMax(1, result.nRes), reported(result.params), finalCurve);
+            postFitStatus(QString("LM 拟合结束: %1 次迭代，最终曲线 Stehfest N = %2")
+                .arg(result.iterations).arg((int)finalParams[Param_N]));
+        }
+    }
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
+
+FittingWidget::LMRunResult FittingWidget::runLevenbergMarquardtCore(const CompiledFitParams& spec, const ParamVector& startParams,
+                                                                    double weight, int maxIter,
+                                                                    std::function<void(int)> onIteration,
+                                                                    std::function<void(const LMRunResult&)> onAccepted,
+                                                                    StehfestPrecisionController* precision) {
+    const ModelType modelType = spec.type;
+    const QVector<int>& fitIds = spec.fitIds;
+    const int nParams = fitIds.size();
+
+    LMRunResult result;
+    result.params = startParams;
+    result.iterations = 0;
+    ParamVector& current = result.params;
+    ParameterSchema::applyDependencies(current);
+    if(precision) {
+        // 起点远离最优点，按最宽松目标选择初始项数
+        precision->update(current, std::numeric_limits<double>::infinity());
+        precision->apply(current);
+    }
 
+    double lambda = 0.01;
+
+    // Broyden 模式下雅可比跨迭代保留，仅在首次、每 broydenRefresh 次更新后或步长被拒绝时完整重算
+    const int broydenRefresh = 5;
+    Eigen::MatrixXd J;
+    bool jacobianFresh = false;
+    int updatesSinceRefresh = 0;
+
+    QVector<double> residuals = calculateResiduals(current, modelType, weight, &result.curve);
+    if(m_cancelToken.isCancelled()) {
+        // 起点尚未算完，不产生有效结果
+        result.sse = std::numeric_limits<double>::max();
+        result.nRes = 0;
+        return result;
+    }
+    double currentSSE = calculateSumSquaredError(residuals);
+    result.sse = currentSSE;
+    result.nRes = residuals.size();
+    if(onAccepted) onAccepted(result);
+    if(nParams == 0) return result;
+
+    // 按迭代坐标 (对数参数取 log10) 施加步长，截断到上下限，并返回实际步长
+    auto applyStep = [&](const Eigen::VectorXd& delta, ParamVector& trial, Eigen::VectorXd& step) {
+        trial = current;
+        step.setZero(nParams);
+        for(int i=0; i<nParams; ++i) {
+            int id = fitIds[i];
+            double newVal = ParameterSchema::applyStep(id, current[id], delta(i));
+            newVal = qMax(spec.lower[id], qMin(newVal, spec.upper[id]));
+            trial[id] = newVal;
+            step(i) = ParameterSchema::stepBetween(id, current[id], newVal);
+        }
+        ParameterSchema::applyDependencies(trial);
+    };
+
+    // 任一次计算被取消后立即退出，被取消的计算结果不参与比较
     for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
+        if(m_cancelToken.isCancelled()) break;
         if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
 
-        emit sigProgress(iter * 100 / maxIter);
+        if(onIteration) onIteration(iter);
+        result.iterations = iter + 1;
 
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
         int nRes = residuals.size();
+        if(!m_useBroyden || J.rows() != nRes || updatesSinceRefresh >= broydenRefresh) {
+            J = computeJacobian(current, residuals, fitIds, modelType, weight);
+            if(m_cancelToken.isCancelled()) break;
+            jacobianFresh = true;
+            updatesSinceRefresh = 0;
+        }
+        Eigen::Map<const Eigen::VectorXd> r(residuals.constData(), nRes);
 
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
+        // 每次迭代只做一次分解: 阻尼 (JᵀJ + λD²)δ = -Jᵀr，D² = diag(1 + |JᵀJ|ᵢᵢ)
+        // 令 Js = J·D⁻¹ = UΣVᵀ，则 δ = -D⁻¹·V·diag(σ/(σ²+λ))·Uᵀr，各阻尼试算只需 O(n²)
+        Eigen::VectorXd dScale = (J.colwise().squaredNorm().transpose().array() + 1.0).sqrt();
+        Eigen::MatrixXd Js = J * dScale.cwiseInverse().asDiagonal();
+        Eigen::JacobiSVD<Eigen::MatrixXd> svd(Js, Eigen::ComputeThinU | Eigen::ComputeThinV);
+        const Eigen::VectorXd& sigma = svd.singularValues();
+        const Eigen::VectorXd Utr = svd.matrixU().transpose() * r;
 
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                g[i] += J[k][i] * residuals[k];
-                for(int j=0; j<=i; ++j) {
-                    H[i][j] += J[k][i] * J[k][j];
-                }
-            }
-        }
-        for(int i=0; i<nParams; ++i) {
-            for(int j=i+1; j<nParams; ++j) {
-                H[i][j] = H[j][i];
-            }
-        }
+        auto dampedSolve = [&](const Eigen::VectorXd& UtRhs, double lam) -> Eigen::VectorXd {
+            Eigen::VectorXd w = sigma.array() / (sigma.array().square() + lam);
+            return -(svd.matrixV() * w.cwiseProduct(UtRhs)).cwiseQuotient(dScale);
+        };
 
         bool stepAccepted = false;
+        double lambdaBefore = lambda;
+        Eigen::VectorXd lastStep;
         for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) {
-                H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            }
-            QVector<double> negG(nParams);
-            for(int i=0;i<nParams;++i) negG[i] = -g[i];
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-
-            QMap<QString, double> trialMap = currentParamMap;
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
-                if(isLog) newVal = pow(10.0, log10(oldVal) + delta[i]);
-                else newVal = oldVal + delta[i];
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
+            Eigen::VectorXd delta = dampedSolve(Utr, lambda);
+
+            // 测地线加速: 沿 δ 方向的二阶方向导数 r'' ≈ 2/h·[(r(x+hδ)-r(x))/h - Jδ]，
+            // 加速度 a = -(JᵀJ+λD²)⁻¹Jᵀr''，仅当 2‖a‖/‖δ‖ ≤ 0.75 时采用 δ + a/2
+            if(m_useGeodesic) {
+                const double h = 0.1;
+                ParamVector probe;
+                Eigen::VectorXd probeStep;
+                applyStep(h * delta, probe, probeStep);
+                QVector<double> probeRes = calculateResiduals(probe, modelType, weight);
+                if(m_cancelToken.isCancelled()) break;
+                if(probeRes.size() == nRes) {
+                    Eigen::Map<const Eigen::VectorXd> rp(probeRes.constData(), nRes);
+                    Eigen::VectorXd rdd = (2.0 / h) * ((rp - r) / h - J * delta);
+                    Eigen::VectorXd accel = dampedSolve(svd.matrixU().transpose() * rdd, lambda);
+                    if(2.0 * accel.norm() <= 0.75 * delta.norm()) delta += 0.5 * accel;
+                }
             }
 
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9)
-                trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
+            ParamVector trial;
+            Eigen::VectorXd step;
+            applyStep(delta, trial, step);
+            lastStep = step;
 
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
+            ModelCurveData trialCurve;
+            QVector<double> newRes = calculateResiduals(trial, modelType, weight, &trialCurve);
+            if(m_cancelToken.isCancelled()) break;
             double newSSE = calculateSumSquaredError(newRes);
 
             if(newSSE < currentSSE) {
+                if(m_useBroyden && newRes.size() == nRes) {
+                    Eigen::Map<const Eigen::VectorXd> rNew(newRes.constData(), nRes);
+                    broydenUpdate(J, step, rNew - r);
+                    jacobianFresh = false;
+                    updatesSinceRefresh++;
+                }
                 currentSSE = newSSE;
-                currentParamMap = trialMap;
+                current = trial;
                 residuals = newRes;
+                result.curve = std::move(trialCurve);
                 lambda /= 10.0;
                 stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
+                result.sse = currentSSE;
+                result.nRes = residuals.size();
+                if(onAccepted) onAccepted(result);
                 break;
             } else {
                 lambda *= 10.0;
             }
         }
+        if(m_cancelToken.isCancelled()) break;
+        if(precision && lastStep.size() == nParams && precision->update(current, lastStep.norm())) {
+            // 项数提高后目标函数与旧值不可比: 在新精度下重算残差，下一次迭代重算雅可比
+            precision->apply(current);
+            ModelCurveData curve;
+            QVector<double> res = calculateResiduals(current, modelType, weight, &curve);
+            if(m_cancelToken.isCancelled()) break;
+            residuals = res;
+            result.curve = std::move(curve);
+            currentSSE = calculateSumSquaredError(residuals);
+            result.sse = currentSSE;
+            result.nRes = residuals.size();
+            updatesSinceRefresh = broydenRefresh;
+            if(!stepAccepted) lambda = lambdaBefore;
+            continue;
+        }
+        if(!stepAccepted && m_useBroyden && !jacobianFresh) {
+            // 近似雅可比失效导致停滞: 下一次迭代完整重算后再判断收敛
+            updatesSinceRefresh = broydenRefresh;
+            lambda = lambdaBefore;
+            continue;
+        }
         if(!stepAccepted && lambda > 1e10) break;
     }
+    return result;
+}
+
+void FittingWidget::broydenUpdate(Eigen::MatrixXd& J, const Eigen::VectorXd& dx, const Eigen::VectorXd& dr) {
+    double dxNorm2 = dx.squaredNorm();
+    if(dxNorm2 < 1e-30 || J.rows() != dr.size() || J.cols() != dx.size()) return;
+    J.noalias() += ((dr - J * dx) / dxNorm2) * dx.transpose();
+}
 
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+void FittingWidget::runMultiStartOptimization(ModelType modelType, QList<FitParameter> params, double weight, quint32 seed) {
+    setFastModelEvaluation(true);
 
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
-    QMetaObject::invokeMethod(this, "onFitFinished");
+    CompiledFitParams spec = FittingParameterChart::compileParameters(modelType, params);
+    if(spec.fitIds.isEmpty() || !m_modelManager) {
+        runLevenbergMarquardtOptimization(modelType, params, weight);
+        return;
+    }
+
+    // 1. 拉丁超立方采样: 第 0 个起点保留当前参数，其余 nStarts-1 个起点采样，
+    //    每个拟合参数的 [min, max] 等分为 nStarts-1 层，每层恰取一个样本
+    //    对数参数在对数空间采样；随机数只由 seed 决定，保证结果可复现
+    const int nStarts = MultiStartCount;
+    const int startIter = 12;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    QVector<MultiStartTask> tasks(nStarts);
+    for(int s = 0; s < nStarts; ++s) {
+        tasks[s].index = s;
+        tasks[s].start = spec.values;
+    }
+    for(int id : spec.fitIds) {
+        const int nStrata = nStarts - 1;
+        QVector<int> strata(nStrata);
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng);
+
+        double lo = spec.lower[id], hi = spec.upper[id];
+        bool isLog = ParameterSchema::usesLog(id, lo);
+        for(int s = 1; s < nStarts; ++s) {
+            double u = (strata[s - 1] + uniform(rng)) / nStrata;
+            double v = isLog ? pow(10.0, log10(lo) + u * (log10(hi) - log10(lo))) : lo + u * (hi - lo);
+            if(id == Param_nf) v = std::round(v);
+            tasks[s].start[id] = v;
+        }
+    }
+    for(auto& task : tasks) ParameterSchema::applyDependencies(task.start);
+
+    // 2. 各起点在线程池中并行运行短程 LM，实时推送当前最优曲线
+    QMutex bestMutex;
+    double bestSSE = std::numeric_limits<double>::max();
+    QAtomicInt finished(0);
+
+    QtConcurrent::blockingMap(tasks, [&](MultiStartTask& task) {
+        task.result.params = task.start;
+        task.result.sse = std::numeric_limits<double>::max();
+        task.result.nRes = 0;
+        task.result.iterations = 0;
+        if(m_cancelToken.isCancelled()) return;
+
+        task.result = runLevenbergMarquardtCore(spec, task.start, weight, startIter, nullptr, nullptr);
+
+        {
+            // 在锁内放入快照，保证邮箱中总是最优的一份
+            QMutexLocker locker(&bestMutex);
+            if(task.result.nRes > 0 && task.result.sse < bestSSE && !m_cancelToken.isCancelled()) {
+                bestSSE = task.result.sse;
+                postFitProgress(modelType, task.result.sse / task.result.nRes, task.result.params, task.result.curve);
+            }
+        }
+        emit sigProgress(finished.fetchAndAddRelaxed(1) * 100 / nStarts);
+    });
+
+    // 3. 按误差 (相同时按起点序号) 选出最优起点，与线程完成顺序无关
+    int best = 0;
+    for(int s = 1; s < nStarts; ++s) {
+        if(tasks[s].result.sse < tasks[best].result.sse) best = s;
+    }
+    postFitStatus(QString("多起点拟合: %1 个起点，种子 %2，最优起点 #%3 (SSE %4)")
+                  .arg(nStarts).arg(seed).arg(best).arg(tasks[best].result.sse, 0, 'e', 3));
+
+    // 4. 从最优起点继续完整 LM 迭代
+    for(auto& p : params) {
+        int id = ParameterSchema::indexOf(p.name);
+        if(p.isFit && id >= 0) p.value = tasks[best].result.params[id];
+    }
+    runLevenbergMarquardtOptimization(modelType, params, weight);
 }
 
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelType modelType, double weight) {
+void FittingWidget::postFitStatus(const QString& text) {
+    QMetaObject::invokeMethod(this, [this, text]() {
+        m_fitStatusLog = m_fitStatusLog.isEmpty() ? text : m_fitStatusLog + "\n" + text;
+        showFitStatus(QString());
+    }, Qt::QueuedConnection);
+}
+
+void FittingWidget::showFitStatus(const QString& liveLine) {
+    if(liveLine.isEmpty()) ui->label_FitStatus->setText(m_fitStatusLog);
+    else ui->label_FitStatus->setText(m_fitStatusLog.isEmpty() ? liveLine : m_fitStatusLog + "\n" + liveLine);
+}
+
+void FittingWidget::setFastModelEvaluation(bool fast, bool explicitN) {
+    if(!m_modelManager) return;
+    m_modelManager->setHighPrecision(!fast || explicitN);
+    m_modelManager->setEvaluationMode(fast ? ModelManager::Eval_Spline : ModelManager::Eval_Direct);
+}
+
+ModelCurveData FittingWidget::calculateModelCurve(ModelType modelType, const ParamVector& params,
+                                                  const QVector<double>& t, const CancellationToken& cancel) {
+    QSharedPointer<const RateSuperposition> op = m_rateSuperposition;
+    if(!op) return m_modelManager->calculateTheoreticalCurve(modelType, params, t, cancel);
+
+    ModelCurveData unit = m_modelManager->calculateTheoreticalCurve(modelType, op->unitParams(params), op->unitTime(), cancel);
+    if(cancel.isCancelled()) return ModelCurveData();
+    return op->apply(unit, params);
+}
+
+ModelSensitivityData FittingWidget::calculateModelSensitivity(ModelType modelType, const ParamVector& params,
+                                                              const QVector<int>& sensIds, const CancellationToken& cancel) {
+    QSharedPointer<const RateSuperposition> op = m_rateSuperposition;
+    if(!op) return m_modelManager->calculateCurveSensitivity(modelType, params, sensIds, m_obsTime, cancel);
+
+    ModelSensitivityData unit = m_modelManager->calculateCurveSensitivity(modelType, op->unitParams(params), sensIds, op->unitTime(), cancel);
+    if(cancel.isCancelled()) return ModelSensitivityData();
+    return op->apply(unit, params);
+}
+
+QVector<double> FittingWidget::calculateResiduals(const ParamVector& params, ModelType modelType, double weight,
+                                                 ModelCurveData* curve) {
     if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
+    m_curveEvalCount.fetchAndAddRelaxed(1);
+    ModelCurveData res = calculateModelCurve(modelType, params, m_obsTime, m_cancelToken);
+    if(m_cancelToken.isCancelled()) return QVector<double>();
     const QVector<double>& pCal = std::get<1>(res);
     const QVector<double>& dpCal = std::get<2>(res);
 
-    QVector<double> r;
     double wp = weight;
     double wd = 1.0 - weight;
     int count = qMin(m_obsDeltaP.size(), pCal.size());
+    int dCount = qMin(m_obsDerivative.size(), dpCal.size());
+    dCount = qMin(dCount, count);
+
+    QVector<double> r;
+    r.reserve(count + dCount);
     for(int i=0; i<count; ++i) {
         if(m_obsDeltaP[i] > 1e-10 && pCal[i] > 1e-10)
             r.append( (log(m_obsDeltaP[i]) - log(pCal[i])) * wp );
         else
             r.append(0.0);
     }
-    int dCount = qMin(m_obsDerivative.size(), dpCal.size());
-    dCount = qMin(dCount, count);
     for(int i=0; i<dCount; ++i) {
         if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10)
             r.append( (log(m_obsDerivative[i]) - log(dpCal[i])) * wd );
         else
             r.append(0.0);
     }
+    if(curve) *curve = std::move(res);
     return r;
 }
 
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
+Eigen::MatrixXd FittingWidget::computeJacobian(const ParamVector& params, const QVector<double>& baseResiduals, const QVector<int>& fitIds, ModelType modelType, double weight) {
     int nRes = baseResiduals.size();
-    int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
+    int nParams = fitIds.size();
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(nRes, nParams);
 
+    // 1. 可微参数: 一次对偶数求解得到全部解析偏导；不可微参数 (如 nf) 退回有限差分
+    QVector<int> sensIds, sensCols, fdCols;
     for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j];
-        QString pName = currentFitParams[idx].name;
-        double val = params.value(pName);
-        bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
-        double h;
-        QMap<QString, double> pPlus = params;
-        QMap<QString, double> pMinus = params;
-
-        if(isLog) {
-            h = 0.01;
-            double valLog = log10(val);
-            pPlus[pName] = pow(10.0, valLog + h);
-            pMinus[pName] = pow(10.0, valLog - h);
+        if(ModelSolver01_06::isDifferentiableParam(fitIds[j]) && sensIds.size() < DualNumber::MaxDerivs) {
+            sensIds.append(fitIds[j]);
+            sensCols.append(j);
+        } else {
+            fdCols.append(j);
+        }
+    }
+
+    if(!sensIds.isEmpty()) {
+        m_sensitivityEvalCount.fetchAndAddRelaxed(1);
+        ModelSensitivityData sens = calculateModelSensitivity(modelType, params, sensIds, m_cancelToken);
+        if(m_cancelToken.isCancelled()) return J;
+        const QVector<double>& pCal = sens.pressure;
+        const QVector<double>& dpCal = sens.derivative;
+
+        // 残差布局与 calculateResiduals 一致: 先压差项，后导数项
+        double wp = weight;
+        double wd = 1.0 - weight;
+        int count = qMin(m_obsDeltaP.size(), pCal.size());
+        int dCount = qMin(qMin(m_obsDerivative.size(), dpCal.size()), count);
+
+        if(count + dCount == nRes) {
+            for(int s = 0; s < sensCols.size(); ++s) {
+                int j = sensCols[s];
+                int id = sensIds[s];
+                double val = params[id];
+                // 对数参数在 log10 空间迭代: ∂r/∂log10(θ) = ln(10)·θ·∂r/∂θ
+                double scale = ParameterSchema::usesLog(id, val) ? std::log(10.0) * val : 1.0;
+
+                for(int i = 0; i < count; ++i) {
+                    if(m_obsDeltaP[i] > 1e-10 && pCal[i] > 1e-10)
+                        J(i, j) = -wp * scale * sens.dPressure[s][i] / pCal[i];
+                }
+                for(int i = 0; i < dCount; ++i) {
+                    if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10)
+                        J(count + i, j) = -wd * scale * sens.dDerivative[s][i] / dpCal[i];
+                }
+            }
         } else {
-            h = 1e-4;
-            pPlus[pName] = val + h;
-            pMinus[pName] = val - h;
+            // 残差长度不一致时全部改用有限差分
+            fdCols.append(sensCols);
         }
+    }
 
-        auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
-        if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
+    // 2. 有限差分列 (参数向量为定长数组，扰动副本不产生堆分配)
+    for(int j : fdCols) {
+        if(m_cancelToken.isCancelled()) break;
+        int id = fitIds[j];
+        double val = params[id];
+        double h = ParameterSchema::usesLog(id, val) ? 0.01 : 1e-4;
+        ParamVector pPlus = params;
+        ParamVector pMinus = params;
+        pPlus[id] = ParameterSchema::applyStep(id, val, h);
+        pMinus[id] = ParameterSchema::applyStep(id, val, -h);
+        ParameterSchema::applyDependencies(pPlus);
+        ParameterSchema::applyDependencies(pMinus);
 
         QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
         QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
 
         if(rPlus.size() == nRes && rMinus.size() == nRes) {
             for(int i=0; i<nRes; ++i) {
-                J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
+                J(i, j) = (rPlus[i] - rMinus[i]) / (2.0 * h);
             }
         }
     }
     return J;
 }
 
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size();
-    if (n == 0) return QVector<double>();
-    Eigen::MatrixXd matA(n, n);
-    Eigen::VectorXd vecB(n);
-    for (int i = 0; i < n; ++i) {
-        vecB(i) = b[i];
-        for (int j = 0; j < n; ++j) matA(i, j) = A[i][j];
-    }
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
-    QVector<double> res(n);
-    for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
-}
-
 double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
     double sse = 0.0;
     for(double v : residuals) sse += v*v;
@@ -639,22 +1136,21 @@ void FittingWidget::updateModelCurve() {
         return;
     }
     ui->tableParams->clearFocus();
+    // 参数改变后原有的不确定性结果不再对应当前参数
+    clearUncertaintyBands();
+    m_uncertainty = UncertaintyResult();
     m_paramChart->updateParamsFromTable();
-    QList<FitParameter> params = m_paramChart->getParameters();
-    QMap<QString,double> currentParams;
-    for(const auto& p : params) currentParams.insert(p.name, p.value);
-    if(currentParams.contains("L") && currentParams.contains("Lf") && currentParams["L"] > 1e-9)
-        currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
-    else
-        currentParams["LfD"] = 0.0;
-
     ModelType type = m_currentModelType;
+    ParamVector currentParams = FittingParameterChart::compileParameters(type, m_paramChart->getParameters()).values;
+
     QVector<double> targetT = m_obsTime;
     if(targetT.isEmpty()) {
         for(double e = -4; e <= 4; e += 0.1) targetT.append(pow(10, e));
     }
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
-    onIterationUpdate(0, currentParams, std::get<0>(res), std::get<1>(res), std::get<2>(res));
+    ModelCurveData res = m_rateSuperposition
+        ? calculateModelCurve(type, currentParams, targetT, CancellationToken())
+        : m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
+    onIterationUpdate(0, ParameterSchema::forModel(type).toMap(currentParams), std::get<0>(res), std::get<1>(res), std::get<2>(res));
 }
 
 void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
@@ -672,114 +1168,296 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
     plotCurves(t, p_curve, d_curve, true);
 }
 
+void FittingWidget::postFitProgress(ModelType type, double error, const ParamVector& params, const ModelCurveData& curve,
+                                    const QString& status) {
+    FitProgressSnapshot snapshot;
+    snapshot.type = type;
+    snapshot.error = error;
+    snapshot.params = params;
+    snapshot.status = status;
+
+    const QVector<double>& t = std::get<0>(curve);
+    const QVector<double>& p = std::get<1>(curve);
+    const QVector<double>& d = std::get<2>(curve);
+    const int n = qMin(t.size(), p.size());
+    if(n <= ProgressCurvePoints) {
+        snapshot.curve = curve;     // 隐式共享，不复制数据
+    } else {
+        QVector<double> vt, vp, vd;
+        vt.reserve(ProgressCurvePoints);
+        vp.reserve(ProgressCurvePoints);
+        vd.reserve(ProgressCurvePoints);
+        const double stride = double(n - 1) / (ProgressCurvePoints - 1);
+        for(int k = 0; k < ProgressCurvePoints; ++k) {
+            int i = qMin(n - 1, qRound(k * stride));
+            vt.append(t[i]);
+            vp.append(p[i]);
+            vd.append(i < d.size() ? d[i] : 0.0);
+        }
+        snapshot.curve = ModelCurveData(vt, vp, vd);
+    }
+    m_progressMailbox.post(std::move(snapshot));
+}
+
+void FittingWidget::pollFitProgress() {
+    FitProgressSnapshot snapshot;
+    if(!m_progressMailbox.take(snapshot)) return;
+    const ParameterSchema& schema = ParameterSchema::forModel(snapshot.type);
+    onIterationUpdate(snapshot.error, schema.toMap(snapshot.params),
+                      std::get<0>(snapshot.curve), std::get<1>(snapshot.curve), std::get<2>(snapshot.curve));
+    if(!snapshot.status.isEmpty()) showFitStatus(snapshot.status);
+}
+
 void FittingWidget::onFitFinished() {
+    // 最终结果在本槽函数排队之前已放入邮箱
+    m_progressTimer.stop();
+    pollFitProgress();
     m_isFitting = false;
+    m_paramChart->setSlidersEnabled(true);
     ui->btnRunFit->setEnabled(true);
-    QMessageBox::information(this, "完成", "拟合完成。");
+    int curveEvals = m_curveEvalCount.loadRelaxed();
+    int sensEvals = m_sensitivityEvalCount.loadRelaxed();
+    bool stopped = m_cancelToken.isCancelled();
+    QMessageBox::information(this, stopped ? "已停止" : "完成",
+                             QString("%1\n理论曲线计算 %2 次，解析偏导计算 %3 次。")
+                             .arg(stopped ? "拟合已停止，保留最后一次接受的参数。" : "拟合完成。")
+                             .arg(curveEvals).arg(sensEvals));
 }
 
 void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
-    QVector<double> vt, vp, vd;
-    for(int i=0; i<t.size(); ++i) {
-        if(t[i]>1e-8 && p[i]>1e-8) {
-            vt<<t[i]; vp<<p[i];
-            if(i<d.size() && d[i]>1e-8) vd<<d[i]; else vd<<1e-10;
-        }
-    }
     if(isModel) {
-        m_plot->graph(2)->setData(vt, vp);
-        m_plot->graph(3)->setData(vt, vd);
-        if (m_obsTime.isEmpty() && !vt.isEmpty()) {
+        m_modelCurve = ModelCurveData(t, p, d);
+        // 理论曲线每次迭代都不同，不经缓存直接生成容器
+        QSharedPointer<QCPGraphDataContainer> pData = PlotDataSource::createContainer(PlotSeries::positive(t, p));
+        m_plot->graph(2)->setData(pData);
+        m_plot->graph(3)->setData(PlotDataSource::createContainer(PlotSeries::positive(t, d)));
+        if (m_obsTime.isEmpty() && !pData->isEmpty()) {
             m_plot->rescaleAxes();
             if(m_plot->xAxis->range().lower<=0) m_plot->xAxis->setRangeLower(1e-3);
             if(m_plot->yAxis->range().lower<=0) m_plot->yAxis->setRangeLower(1e-3);
+            m_plot->requestReplot();
+        } else {
+            // 坐标范围不变: 只重绘理论曲线图层，迭代再频繁每帧也只重绘一次
+            m_plot->requestReplot(m_plot->layer(ModelLayer));
         }
-        m_plot->replot();
     }
 }
 
-void FittingWidget::on_btnExportReport_clicked()
-{
+void FittingWidget::on_btnDragMatch_toggled(bool checked) {
+    if(checked && m_rateSuperposition) {
+        // 变产量叠加后的曲线不是单位响应的平移，不能按平移换算参数
+        QMessageBox::information(this, "拖动匹配", "变产量数据的理论曲线不能按平移匹配，请使用自动拟合。");
+        ui->btnDragMatch->setChecked(false);
+    }
+}
+
+void FittingWidget::dragOffset(const QPointF& pos, double& dx, double& dy) const {
+    dx = log10(m_plot->xAxis->pixelToCoord(pos.x()) / m_plot->xAxis->pixelToCoord(m_dragStart.x()));
+    dy = log10(m_plot->yAxis->pixelToCoord(pos.y()) / m_plot->yAxis->pixelToCoord(m_dragStart.y()));
+}
+
+void FittingWidget::onPlotMousePress(QMouseEvent* event) {
+    if(!ui->btnDragMatch->isChecked() || m_isFitting || event->button() != Qt::LeftButton) return;
+    if(std::get<0>(m_modelCurve).isEmpty() || m_rateSuperposition) return;
+
+    // 只有按在理论压差或导数曲线附近才开始拖动，否则仍为平移视图
+    const double tolerance = 8.0;
+    bool nearCurve = false;
+    for(int g : {2, 3}) {
+        double dist = m_plot->graph(g)->selectTest(event->position(), false);
+        if(dist >= 0.0 && dist < tolerance) nearCurve = true;
+    }
+    if(!nearCurve) return;
+
+    m_dragMatching = true;
+    m_dragStart = event->position();
+    // 鼠标事件信号先于坐标轴处理，此时关闭视图拖动，本次按下不会平移坐标
+    m_plot->setInteraction(QCP::iRangeDrag, false);
+    m_plot->setCursor(Qt::ClosedHandCursor);
+}
+
+void FittingWidget::onPlotMouseMove(QMouseEvent* event) {
+    if(!m_dragMatching) return;
+    double dx, dy;
+    dragOffset(event->position(), dx, dy);
+    showShiftedModelCurve(dx, dy);
+}
+
+void FittingWidget::onPlotMouseRelease(QMouseEvent* event) {
+    if(!m_dragMatching) return;
+    m_dragMatching = false;
+    m_plot->setInteraction(QCP::iRangeDrag, true);
+    m_plot->unsetCursor();
+
+    double dx, dy;
+    dragOffset(event->position(), dx, dy);
+    if(!std::isfinite(dx) || !std::isfinite(dy) || (qAbs(dx) < 1e-4 && qAbs(dy) < 1e-4)) {
+        showShiftedModelCurve(0.0, 0.0);
+        return;
+    }
+    applyDragMatch(dx, dy);
+}
+
+void FittingWidget::showShiftedModelCurve(double dx, double dy) {
+    const QVector<double>& t = std::get<0>(m_modelCurve);
+    const QVector<double>& p = std::get<1>(m_modelCurve);
+    const QVector<double>& d = std::get<2>(m_modelCurve);
+    const double sx = pow(10.0, dx), sy = pow(10.0, dy);
+    const int n = qMin(t.size(), p.size());
+
+    QVector<double> ts(n), ps(n), ds(n);
+    for(int i = 0; i < n; ++i) {
+        ts[i] = t[i] * sx;
+        ps[i] = p[i] * sy;
+        ds[i] = (i < d.size()) ? d[i] * sy : 0.0;
+    }
+    m_plot->graph(2)->setData(PlotDataSource::createContainer(PlotSeries::positive(ts, ps)));
+    m_plot->graph(3)->setData(PlotDataSource::createContainer(PlotSeries::positive(ts, ds)));
+    // 每帧最多重绘一次理论曲线图层
+    m_plot->requestReplot(m_plot->layer(ModelLayer));
+}
+
+void FittingWidget::applyDragMatch(double dx, double dy) {
     m_paramChart->updateParamsFromTable();
     QList<FitParameter> params = m_paramChart->getParameters();
+    const double kScale = pow(10.0, -dy);
+    const double lScale = pow(10.0, 0.5 * (dx - dy));
+    for(FitParameter& p : params) {
+        double scale = 1.0;
+        if(p.name == "kf" || p.name == "km") scale = kScale;
+        else if(p.name == "L" || p.name == "Lf") scale = lScale;
+        else continue;
+        p.value = qBound(p.min, p.value * scale, p.max);
+    }
+    m_paramChart->setParameters(params);
+    // 以新参数精确重算一次 (截断到上下限时曲线与拖动位置会有差别)
+    updateModelCurve();
+}
+
+void FittingWidget::configureLivePreview() {
+    const ModelType type = m_currentModelType;
+    QSharedPointer<const RateSuperposition> op = m_rateSuperposition;
+
+    // 细化阶段的时间点与 updateModelCurve 相同，预览阶段在其正值范围内对数等分取少量点
+    QVector<double> t = m_obsTime;
+    if(t.isEmpty()) {
+        for(double e = -4; e <= 4; e += 0.1) t.append(pow(10, e));
+    }
+    double tMin = 0.0, tMax = 0.0;
+    for(double v : t) {
+        if(v <= 0.0) continue;
+        tMin = (tMin > 0.0) ? qMin(tMin, v) : v;
+        tMax = qMax(tMax, v);
+    }
+    QVector<double> tCoarse = (tMax > tMin)
+        ? ModelManager::generateLogTimeSteps(LivePreviewPoints, log10(tMin), log10(tMax)) : t;
+
+    // 预览优先用图版插值 (不调用求解器)，无图版或变产量时用低阶反演
+    QSharedPointer<TypeCurveAtlas> atlas = (op || !m_modelManager) ? QSharedPointer<TypeCurveAtlas>() : m_modelManager->typeCurveAtlas(type);
+    const ParameterSchema* schema = &ParameterSchema::forModel(type);
+    LiveCurvePreview::Stage preview = [type, tCoarse, atlas, schema, op](const ParamVector& params, const CancellationToken& cancel) {
+        ModelCurveData out;
+        if(atlas && atlas->isValid() && atlas->evaluate(schema->toMap(params), tCoarse, out)) return out;
+        return evaluateLiveCurve(type, params, tCoarse, false, op, cancel);
+    };
+    // 细化: 先低阶反演全部时间点，再按参数 N 全精度计算
+    QVector<LiveCurvePreview::Stage> refinements;
+    for(bool highPrecision : {false, true}) {
+        refinements.append([type, t, highPrecision, op](const ParamVector& params, const CancellationToken& cancel) {
+            return evaluateLiveCurve(type, params, t, highPrecision, op, cancel);
+        });
+    }
+    m_livePreview->setStages(preview, refinements);
+}
+
+ModelCurveData FittingWidget::evaluateLiveCurve(ModelType type, const ParamVector& params, const QVector<double>& t,
+                                                bool highPrecision, QSharedPointer<const RateSuperposition> op,
+                                                const CancellationToken& cancel) {
+    if(op) {
+        ModelCurveData unit = ModelSolver01_06::calculateTheoreticalCurve(type, op->unitParams(params), op->unitTime(), highPrecision, cancel);
+        if(cancel.isCancelled()) return ModelCurveData();
+        return op->apply(unit, params);
+    }
+    auto solve = [&](const QVector<double>& tt) {
+        return ModelSolver01_06::calculateTheoreticalCurve(type, params, tt, highPrecision, cancel);
+    };
+    const SplineEvalOptions options;
+    int gridSize = SplineCurveEvaluator::baseGridSize(t, options.pointsPerDecade);
+    if(gridSize >= 4 && t.size() > 2 * gridSize) return SplineCurveEvaluator::evaluate(solve, t, options);
+    return solve(t);
+}
+
+void FittingWidget::onParameterSliding() {
+    if(m_isFitting || !m_modelManager) return;
+    // 参数已改变，原有的不确定性结果不再对应当前参数
+    clearUncertaintyBands();
+    m_uncertainty = UncertaintyResult();
+
+    configureLivePreview();
+    CompiledFitParams spec = FittingParameterChart::compileParameters(m_currentModelType, m_paramChart->getParameters());
+    m_livePreview->preview(spec.values);
+    m_livePending = true;
+    m_liveSettleTimer.start();
+}
+
+void FittingWidget::onSliderSettled() {
+    m_liveSettleTimer.stop();
+    if(!m_livePending || m_isFitting || !m_modelManager) return;
+    m_livePending = false;
+
+    configureLivePreview();
+    CompiledFitParams spec = FittingParameterChart::compileParameters(m_currentModelType, m_paramChart->getParameters());
+    m_livePreview->refine(spec.values);
+}
+
+void FittingWidget::onLiveCurveReady(const ParamVector& params, const ModelCurveData& curve, int stage, bool isFinal) {
+    Q_UNUSED(params);
+    Q_UNUSED(stage);
+    Q_UNUSED(isFinal);
+    if(m_isFitting) return;
+    plotCurves(std::get<0>(curve), std::get<1>(curve), std::get<2>(curve), true);
+}
+
+void FittingWidget::on_btnExportReport_clicked()
+{
     QString defaultDir = ModelParameter::instance()->getProjectPath();
     if(defaultDir.isEmpty()) defaultDir = ".";
     QString fileName = QFileDialog::getSaveFileName(this, "导出试井分析报告", defaultDir + "/WellTestReport.doc", "Word 文档 (*.doc);;HTML 文件 (*.html)");
     if(fileName.isEmpty()) return;
 
-    ModelParameter* mp = ModelParameter::instance();
-    QString html = "<html><head><style>";
-    html += "body { font-family: 'Times New Roman', 'SimSun', serif; }";
-    html += "h1 { text-align: center; font-size: 24px; font-weight: bold; margin-bottom: 20px; }";
-    html += "h2 { font-size: 18px; font-weight: bold; background-color: #f2f2f2; padding: 5px; border-left: 5px solid #2d89ef; margin-top: 20px; }";
-    html += "table { width: 100%; border-collapse: collapse; margin-bottom: 15px; font-size: 14px; }";
-    html += "td, th { border: 1px solid #888; padding: 6px; text-align: center; }";
-    html += "th { background-color: #e0e0e0; font-weight: bold; }";
-    html += ".param-table td { text-align: left; padding-left: 10px; }";
-    html += "</style></head><body>";
-
-    html += "<h1>试井解释分析报告</h1>";
-    html += "<p style='text-align:right;'>生成日期: " + QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm") + "</p>";
-
-    html += "<h2>1. 基础信息</h2>";
-    html += "<table class='param-table'>";
-    html += "<tr><td width='30%'>项目路径</td><td>" + mp->getProjectPath() + "</td></tr>";
-    html += "<tr><td>测试产量 (q)</td><td>" + QString::number(mp->getQ()) + " m³/d</td></tr>";
-    html += "<tr><td>有效厚度 (h)</td><td>" + QString::number(mp->getH()) + " m</td></tr>";
-    html += "<tr><td>孔隙度 (φ)</td><td>" + QString::number(mp->getPhi()) + "</td></tr>";
-    html += "<tr><td>井筒半径 (rw)</td><td>" + QString::number(mp->getRw()) + " m</td></tr>";
-    html += "</table>";
-
-    html += "<h2>2. 流体高压物性 (PVT)</h2>";
-    html += "<table class='param-table'>";
-    html += "<tr><td width='30%'>原油粘度 (μ)</td><td>" + QString::number(mp->getMu()) + " mPa·s</td></tr>";
-    html += "<tr><td>体积系数 (B)</td><td>" + QString::number(mp->getB()) + "</td></tr>";
-    html += "<tr><td>综合压缩系数 (Ct)</td><td>" + QString::number(mp->getCt()) + " MPa⁻¹</td></tr>";
-    html += "</table>";
-
-    html += "<h2>3. 解释模型选择</h2>";
-    html += "<p><strong>当前模型:</strong> " + ModelManager::getModelTypeName(m_currentModelType) + "</p>";
-
-    html += "<h2>4. 拟合结果参数</h2>";
-    html += "<table>";
-    html += "<tr><th>参数名称</th><th>符号</th><th>拟合结果</th><th>单位</th></tr>";
-    for(const auto& p : params) {
-        QString dummy, symbol, uniSym, unit;
-        FittingParameterChart::getParamDisplayInfo(p.name, dummy, symbol, uniSym, unit);
-        if(unit == "无因次" || unit == "小数") unit = "-";
-        html += "<tr><td>" + p.displayName + "</td><td>" + uniSym + "</td>";
-        if(p.isFit) html += "<td><strong>" + QString::number(p.value, 'g', 6) + "</strong></td>";
-        else html += "<td>" + QString::number(p.value, 'g', 6) + "</td>";
-        html += "<td>" + unit + "</td></tr>";
-    }
-    html += "</table>";
-
-    html += "<h2>5. 拟合曲线图</h2>";
-    QString imgBase64 = getPlotImageBase64();
-    if(!imgBase64.isEmpty()) html += "<div style='text-align:center;'><img src='data:image/png;base64," + imgBase64 + "' width='600' /></div>";
-    else html += "<p>图像导出失败。</p>";
-    html += "</body></html>";
-
-    QFile file(fileName);
-    if(file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out.setEncoding(QStringConverter::Utf8);
-        out << html;
-        file.close();
-        QMessageBox::information(this, "导出成功", "报告已保存至:\n" + fileName);
-    } else {
-        QMessageBox::critical(this, "错误", "无法写入文件，请检查权限或文件是否被占用。");
-    }
+    // 报告内容在界面线程取快照，绘图、编码与写文件在后台进行
+    QList<ReportAnalysis> analyses;
+    analyses.append(reportSnapshot());
+    ui->btnExportReport->setEnabled(false);
+    QFutureWatcher<QString>* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, fileName]() {
+        watcher->deleteLater();
+        ui->btnExportReport->setEnabled(true);
+        const QString error = watcher->result();
+        if(error.isEmpty()) QMessageBox::information(this, "导出成功", "报告已保存至:\n" + fileName);
+        else QMessageBox::critical(this, "错误", "无法写入文件，请检查权限或文件是否被占用。\n" + error);
+    });
+    watcher->setFuture(ReportGenerator::writeAsync(fileName, ReportProjectInfo::fromModelParameter(), analyses));
 }
 
-QString FittingWidget::getPlotImageBase64() {
-    if(!m_plot) return "";
-    QPixmap pixmap = m_plot->toPixmap(800, 600);
-    QByteArray byteArray;
-    QBuffer buffer(&byteArray);
-    buffer.open(QIODevice::WriteOnly);
-    pixmap.save(&buffer, "PNG");
-    return QString::fromLatin1(byteArray.toBase64().data());
+ReportAnalysis FittingWidget::reportSnapshot() const {
+    const_cast<FittingWidget*>(this)->m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+
+    ReportAnalysis a;
+    a.modelType = m_currentModelType;
+    for(const auto& p : params) a.addParameter(p.name, p.displayName, p.value, p.isFit);
+    a.uncertainty = m_uncertainty;
+    a.obsTime = m_obsTime;
+    a.obsDeltaP = m_obsDeltaP;
+    a.obsDerivative = m_obsDerivative;
+    a.modelCurve = m_modelCurve;
+    a.params = FittingParameterChart::compileParameters(m_currentModelType, params).values;
+    if(m_rateSuperposition) {
+        a.rateHistory = m_rateSuperposition->history();
+        a.rateStages = a.rateHistory.size();
+    }
+    return a;
 }
 
 void FittingWidget::on_btnSaveFit_clicked() {
@@ -824,6 +1502,17 @@ QJsonObject FittingWidget::getJsonState() const {
     obsData["pressure"] = pressArr;
     obsData["derivative"] = derivArr;
     root["observedData"] = obsData;
+
+    if(m_rateSuperposition) {
+        const RateHistory& history = m_rateSuperposition->history();
+        QJsonArray startArr, rateArr;
+        for(double v : history.startTime) startArr.append(v);
+        for(double v : history.rate) rateArr.append(v);
+        QJsonObject rateObj;
+        rateObj["startTime"] = startArr;
+        rateObj["rate"] = rateArr;
+        root["rateHistory"] = rateObj;
+    }
     return root;
 }
 
@@ -879,6 +1568,14 @@ void FittingWidget::loadFittingState(const QJsonObject& root) {
         setObservedData(t, p, d);
     }
 
+    if (root.contains("rateHistory")) {
+        QJsonObject rateObj = root["rateHistory"].toObject();
+        RateHistory history;
+        for(auto v : rateObj["startTime"].toArray()) history.startTime.append(v.toDouble());
+        for(auto v : rateObj["rate"].toArray()) history.rate.append(v.toDouble());
+        if(history.startTime.size() == history.rate.size()) setRateHistory(history);
+    }
+
     updateModelCurve();
 
     if (root.contains("plotView")) {
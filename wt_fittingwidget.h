@@ -5,6 +5,11 @@
  * 1. 负责拟合界面的整体布局和交互。
  * 2. 包含图表显示、参数调整、数据导入导出等功能。
  * 3. 使用 QtConcurrent 进行后台拟合计算。
+ * 4. 拟合进度经单槽邮箱传给界面，界面按固定频率轮询并绘制最新一份快照；
+ *    显示曲线直接取自已完成的残差计算 (观测时间上的理论曲线)，不为显示另算曲线。
+ * 5. 拖动匹配: 在双对数图上拖动理论曲线时只平移已算好的曲线 (不调用求解器)，
+ *    松开后把平移量换算为参数写回参数表，再精确重算一次。
+ * 6. 参数滑块: 拖动时在后台先算粗略预览，停止拖动后逐级细化到全精度；新的参数使旧的计算作废。
  */
 
 #ifndef WT_FITTINGWIDGET_H
@@ -16,12 +21,24 @@
 #include <QMap>
 #include <QVector>
 #include <QJsonObject>
+#include <QAtomicInt>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QTimer>
+#include <functional>
+#include <Eigen/Dense>
 
 #include "modelmanager.h"
 #include "fittingparameterchart.h"
 #include "mousezoom.h"
 #include "chartsetting1.h"
 #include "paramselectdialog.h"
+#include "uncertaintyanalysis.h"
+#include "ratesuperposition.h"
+#include "stehfestprecision.h"
+#include "progressmailbox.h"
+#include "livecurvepreview.h"
+#include "reportgenerator.h"
 #include "modelenums.h" // [新增] 引入公共枚举
 
 namespace Ui {
@@ -49,6 +66,9 @@ public:
     QJsonObject getJsonState() const;
     void loadFittingState(const QJsonObject& root);
 
+    // 当前分析的报告内容快照 (参数、置信区间、实测数据与理论曲线)，供后台报告生成使用
+    ReportAnalysis reportSnapshot() const;
+
     // 设置当前观测数据
     void setObservedDataToCurrent(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d) {
         setObservedData(t, p, d);
@@ -60,16 +80,14 @@ public:
     // 重置分析
     void resetAnalysis() {
         m_obsTime.clear(); m_obsDeltaP.clear(); m_obsDerivative.clear();
+        m_rateSuperposition.reset();
         m_plot->clearGraphs();
+        m_uncertainty = UncertaintyResult();
         setupPlot();
         initializeDefaultModel();
     }
 
 signals:
-    // 拟合迭代更新信号 (用于更新界面曲线)
-    void sigIterationUpdated(double error, const QMap<QString, double>& currentParams,
-                             const QVector<double>& t, const QVector<double>& p, const QVector<double>& d);
-
     // 进度信号
     void sigProgress(int percent);
 
@@ -86,10 +104,12 @@ private slots:
     void on_btnSelectParams_clicked();  // 选择参数
     void on_btnRunFit_clicked();        // 开始拟合
     void on_btnStop_clicked();          // 停止拟合
+    void on_btnUncertainty_clicked();   // 参数不确定性分析
     void on_btnImportModel_clicked();   // 刷新/生成曲线
     void on_btnResetParams_clicked();   // 重置参数
     void on_btnResetView_clicked();     // 重置视图
     void on_btnChartSettings_clicked(); // 图表设置
+    void on_btnDragMatch_toggled(bool checked); // 拖动匹配模式
     void on_btn_modelSelect_clicked();  // 选择模型
     void on_btnExportData_clicked();    // 导出参数
     void on_btnExportChart_clicked();   // 导出图表
@@ -99,6 +119,18 @@ private slots:
     void onSliderWeightChanged(int value);
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
     void onFitFinished();
+    // 定时取出拟合进度邮箱中的最新快照并显示
+    void pollFitProgress();
+
+    // 拖动匹配: 按下理论曲线开始拖动，移动时平移显示，松开时写回参数
+    void onPlotMousePress(QMouseEvent* event);
+    void onPlotMouseMove(QMouseEvent* event);
+    void onPlotMouseRelease(QMouseEvent* event);
+
+    // 参数滑块: 拖动中请求预览，停止拖动 (松开或静止片刻) 后请求细化
+    void onParameterSliding();
+    void onSliderSettled();
+    void onLiveCurveReady(const ParamVector& params, const ModelCurveData& curve, int stage, bool isFinal);
 
 private:
     void initUi();
@@ -106,25 +138,130 @@ private:
     void initializeDefaultModel();
 
     void setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& d);
+    // 设置变产量历史 (须在 setObservedData 之后调用，叠加算子按当前观测时间构造)；空历史恢复定产量
+    void setRateHistory(const RateHistory& history);
     void updateModelCurve();
     void plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel);
 
-    QString getPlotImageBase64();
+    // --- 拖动匹配 ---
+    // 双对数图上理论曲线的平移与参数的对应关系 (无因次曲线不变):
+    //   纵向 Δlog p = dy: 压力系数 1.842e-3·qμB/(kf·h) 乘 10^dy，kf 与 km 同乘 10^(-dy) (渗透率比不变)
+    //   横向 Δlog t = dx: 时间系数 14.4·kf/(φμCtL²) 乘 10^(-dx)，kf 已由纵向确定，
+    //   L 与 Lf 同乘 10^((dx-dy)/2) (无因次缝长不变)
+    // 按平移量显示最近一次的理论曲线 (不调用求解器)
+    void showShiftedModelCurve(double dx, double dy);
+    // 把平移量换算为参数写回参数表 (截断到参数上下限)，并精确重算一次
+    void applyDragMatch(double dx, double dy);
+    // 鼠标位置相对拖动起点的对数平移量
+    void dragOffset(const QPointF& pos, double& dx, double& dy) const;
+
+    // --- 参数滑块实时预览 ---
+    // 预览阶段的时间点数 (对数等分) 与停止拖动的判定时间 (毫秒)
+    static constexpr int LivePreviewPoints = 40;
+    static constexpr int LiveSettleDelay = 150;
+    // 按当前模型、观测时间与产量历史设置实时预览的各计算阶段
+    void configureLivePreview();
+    // 实时预览使用的曲线计算: 直接调用求解器 (不改变 ModelManager 的精度设置)，
+    // 有变产量历史时在单位响应网格上计算后叠加，观测点密集时用样条插值方式
+    static ModelCurveData evaluateLiveCurve(ModelType type, const ParamVector& params, const QVector<double>& t,
+                                            bool highPrecision, QSharedPointer<const RateSuperposition> op,
+                                            const CancellationToken& cancel);
+
+    // --- 不确定性分析 ---
+    // 后台任务: 在当前参数处计算残差与雅可比，再做线性化协方差、蒙特卡洛与自助法分析
+    void runUncertaintyTask(ModelType modelType, QList<FitParameter> params, double weight, quint32 seed);
+    void onUncertaintyFinished(const UncertaintyResult& result);
+    // 在双对数图上绘制 / 移除置信带 (参数改变后置信带随之作废)
+    void plotUncertaintyBands();
+    void clearUncertaintyBands();
 
     // --- 拟合算法相关 ---
+    // 拟合方式
+    enum FitMode {
+        FitMode_LM = 0,         // 单起点局部 LM
+        FitMode_MultiStart = 1  // 拉丁超立方多起点 LM (并行)
+    };
+
+    // 一次 LM 运行的状态/结果
+    struct LMRunResult {
+        ParamVector params;
+        double sse;
+        int nRes;
+        int iterations;
+        ModelCurveData curve;   // params 在观测时间上的理论曲线 (残差计算的副产品)
+    };
+
+    // 拟合进度快照 (工作线程放入邮箱，界面线程取出)
+    struct FitProgressSnapshot {
+        ModelType type = Model_1;
+        double error = 0.0;     // MSE
+        ParamVector params;
+        ModelCurveData curve;
+        QString status;         // 拟合状态栏末行的实时说明 (为空时不改动状态栏)
+    };
+    // 界面轮询间隔 (毫秒) 与快照曲线的最大点数 (观测点更密时等间隔抽取)
+    static constexpr int ProgressPollInterval = 40;
+    static constexpr int ProgressCurvePoints = 2000;
+    // 放入快照 (任意线程)；curve 超过 ProgressCurvePoints 点时抽稀后放入
+    void postFitProgress(ModelType type, double error, const ParamVector& params, const ModelCurveData& curve,
+                         const QString& status = QString());
+    // 在拟合状态栏追加一行说明 (任意线程，排队到界面线程显示；每次拟合开始时清空)
+    void postFitStatus(const QString& text);
+    // 状态栏 = 已追加的说明 + 最近一个快照的实时说明
+    void showFitStatus(const QString& liveLine);
+
+    // 多起点拟合的起点数: 固定值，与机器核数无关 (线程池只决定各起点的调度)，同一种子结果可复现
+    static constexpr int MultiStartCount = 24;
+    // 多起点拟合中的单个起点
+    struct MultiStartTask {
+        int index;
+        ParamVector start;
+        LMRunResult result;
+    };
+
     // [修改] 参数类型改为 ModelType
     void runOptimizationTask(ModelType modelType, QList<FitParameter> fitParams, double weight);
 
+    // 拟合前全局初值搜索: 图版匹配得到前 k 组候选，取精确误差最小者写回 params
+    void searchInitialGuess(ModelType modelType, QList<FitParameter>& params, double weight);
+
     // [修改] 参数类型改为 ModelType
     void runLevenbergMarquardtOptimization(ModelType modelType, QList<FitParameter> params, double weight);
 
+    // LM 迭代核心 (不直接操作界面): onIteration 在每次迭代开始时回调，onAccepted 在初始点及每次接受步长后回调
+    // spec 为编译后的拟合问题 (模型类型、参数上下限与拟合参数下标)，迭代中只操作稠密参数向量
+    // precision 非空时每次迭代后按步长调整 Stehfest 项数 (写入参数 N)，并记录每次迭代所用项数
+    LMRunResult runLevenbergMarquardtCore(const CompiledFitParams& spec,
+                                          const ParamVector& startParams, double weight, int maxIter,
+                                          std::function<void(int)> onIteration,
+                                          std::function<void(const LMRunResult&)> onAccepted,
+                                          StehfestPrecisionController* precision = nullptr);
+
+    // 全局拟合: 拉丁超立方采样多个起点，在线程池中并行运行短程 LM，再从最优起点完整迭代
+    void runMultiStartOptimization(ModelType modelType, QList<FitParameter> params, double weight, quint32 seed);
+
+    // 理论曲线与解析偏导的统一入口: 有变产量历史时在单位响应网格上计算后叠加到观测时间
+    // (此时忽略 t，输出时间即观测时间)，否则直接按定产量计算
+    ModelCurveData calculateModelCurve(ModelType modelType, const ParamVector& params,
+                                       const QVector<double>& t, const CancellationToken& cancel);
+    ModelSensitivityData calculateModelSensitivity(ModelType modelType, const ParamVector& params,
+                                                   const QVector<int>& sensIds, const CancellationToken& cancel);
+
+    // 迭代期间的快速计算: 低精度 Stehfest + 样条插值计算方式 (观测点密集时反演次数与点数无关)
+    // explicitN 时 Stehfest 项数取参数 N (由自适应精度控制逐步提高)，否则固定为低阶
+    void setFastModelEvaluation(bool fast, bool explicitN = false);
+
     // [修改] 参数类型改为 ModelType
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelType modelType, double weight);
+    // curve 非空时同时返回计算残差所用的理论曲线 (观测时间上)
+    QVector<double> calculateResiduals(const ParamVector& params, ModelType modelType, double weight,
+                                       ModelCurveData* curve = nullptr);
 
     // [修改] 参数类型改为 ModelType
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
+    Eigen::MatrixXd computeJacobian(const ParamVector& params, const QVector<double>& residuals, const QVector<int>& fitIds, ModelType modelType, double weight);
+
+    // Broyden 秩一更新: J += (Δr - J·Δx)·Δxᵀ / (Δxᵀ·Δx)，Δx 为迭代空间 (对数参数取 log10) 中的实际步长
+    static void broydenUpdate(Eigen::MatrixXd& J, const Eigen::VectorXd& dx, const Eigen::VectorXd& dr);
 
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
     double calculateSumSquaredError(const QVector<double>& residuals);
 
 private:
@@ -135,17 +272,52 @@ private:
     FittingParameterChart* m_paramChart;
     MouseZoom* m_plot;
     QCPTextElement* m_plotTitle;
+    // 绘图图层名: 实测数据 / 置信带等叠加曲线 / 理论曲线 (均为缓冲图层)
+    static constexpr const char* ObservedLayer = "observedData";
+    static constexpr const char* OverlayLayer = "fitOverlays";
+    static constexpr const char* ModelLayer = "modelCurves";
 
     // [修改] 参数类型改为 ModelType
     ModelType m_currentModelType;
 
+    // 最近一次显示的理论曲线 (拖动匹配的平移基准) 与拖动状态
+    ModelCurveData m_modelCurve;
+    bool m_dragMatching;
+    QPointF m_dragStart;
+
     QVector<double> m_obsTime;
     QVector<double> m_obsDeltaP;
     QVector<double> m_obsDerivative;
+    // 变产量叠加算子 (构造后只读，拟合线程共享)；为空时按参数 q 定产量计算
+    QSharedPointer<const RateSuperposition> m_rateSuperposition;
 
     bool m_isFitting;
-    bool m_stopRequested;
+    // 本次拟合的取消令牌: 每次开始拟合时重新生成，工作线程在每次曲线计算及雅可比列之间检查
+    CancellationToken m_cancelToken;
+    bool m_useInitialSearch;    // 拟合前是否进行图版初值搜索
+    int m_fitMode;              // 拟合方式 (FitMode)
+    quint32 m_randomSeed;       // 全局拟合随机种子
+    bool m_useBroyden;          // LM 中是否用 Broyden 秩一更新代替每步重算雅可比
+    bool m_useGeodesic;         // LM 步长是否叠加测地线加速修正
+    bool m_useAdaptivePrecision; // LM 中是否随步长自适应提高 Stehfest 项数
+    QString m_fitStatusLog;     // postFitStatus 追加的说明 (界面线程)
+
+    // 本次拟合的模型计算次数统计 (多线程累加)
+    QAtomicInt m_curveEvalCount;        // 理论曲线计算次数 (残差及有限差分)
+    QAtomicInt m_sensitivityEvalCount;  // 对偶数解析偏导计算次数
     QFutureWatcher<void> m_watcher;
+    // 拟合进度: 工作线程只覆盖最新快照，界面定时轮询
+    ProgressMailbox<FitProgressSnapshot> m_progressMailbox;
+    QTimer m_progressTimer;
+
+    // 参数滑块的后台渐进计算与停止拖动判定
+    LiveCurvePreview* m_livePreview;
+    QTimer m_liveSettleTimer;
+    bool m_livePending;     // 预览之后尚未细化
+
+    // 最近一次不确定性分析结果及其置信带曲线
+    UncertaintyResult m_uncertainty;
+    QVector<QPointer<QCPGraph>> m_bandGraphs;
 };
 
 #endif // WT_FITTINGWIDGET_H
@@ -13,6 +13,8 @@
 #include "modelsolver01_06.h" // 引入计算核心
 #include "modelmanager.h"     // 可能需要用到其中的通用工具函数
 #include "modelparameter.h"   // 用于获取默认参数
+#include "plotdatasource.h"
+#include "numericexport.h"
 
 #include <QDebug>
 #include <QMessageBox>
@@ -27,6 +29,9 @@ WT_ModelWidget::WT_ModelWidget(ModelType type, QWidget *parent)
     , ui(new Ui::WT_ModelWidget)
     , m_type(type)
     , m_highPrecision(true)
+    , m_modelManager(nullptr)
+    , m_engine(new SensitivityEngine(this))
+    , m_isSensitivity(false)
 {
     ui->setupUi(this);
     m_colorList = { Qt::red, Qt::blue, QColor(0,180,0), Qt::magenta, QColor(255,140,0), Qt::cyan };
@@ -46,7 +51,12 @@ WT_ModelWidget::WT_ModelWidget(ModelType type, QWidget *parent)
     onResetParameters();
 }
 
-WT_ModelWidget::~WT_ModelWidget() { delete ui; }
+WT_ModelWidget::~WT_ModelWidget() {
+    // 引擎随本对象析构时会等待工作线程退出，先断开信号并停止计算
+    m_engine->disconnect(this);
+    m_engine->cancel();
+    delete ui;
+}
 
 QString WT_ModelWidget::getModelName() const {
     switch(m_type) {
@@ -133,12 +143,30 @@ void WT_ModelWidget::setupConnections() {
     connect(ui->LfEdit, &QLineEdit::editingFinished, this, &WT_ModelWidget::onDependentParamsChanged);
     connect(ui->checkShowPoints, &QCheckBox::toggled, this, &WT_ModelWidget::onShowPointsToggled);
 
+    // 敏感性引擎: 曲线逐条完成即绘制
+    connect(m_engine, &SensitivityEngine::curveReady, this, &WT_ModelWidget::onSensitivityCurveReady);
+    connect(m_engine, &SensitivityEngine::progress, this, &WT_ModelWidget::onSensitivityProgress);
+    connect(m_engine, &SensitivityEngine::finished, this, &WT_ModelWidget::onSensitivityFinished);
+
     // 转发模型选择按钮信号
     connect(ui->btnSelectModel, &QPushButton::clicked, this, &WT_ModelWidget::requestModelSelection);
+
+    // 参数编辑完成后，若有类型曲线图版则即时显示插值预览
+    QList<QLineEdit*> paramEdits = {
+        ui->kfEdit, ui->kmEdit, ui->LEdit, ui->LfEdit, ui->nfEdit, ui->rmDEdit,
+        ui->omga1Edit, ui->omga2Edit, ui->remda1Edit, ui->gamaDEdit, ui->reDEdit,
+        ui->cDEdit, ui->sEdit, ui->phiEdit, ui->hEdit, ui->muEdit, ui->BEdit,
+        ui->CtEdit, ui->qEdit, ui->tEdit, ui->pointsEdit
+    };
+    for (QLineEdit* edit : paramEdits) {
+        connect(edit, &QLineEdit::editingFinished, this, &WT_ModelWidget::onParamEditFinished);
+    }
 }
 
 void WT_ModelWidget::setHighPrecision(bool high) { m_highPrecision = high; }
 
+void WT_ModelWidget::setModelManager(ModelManager* manager) { m_modelManager = manager; }
+
 QVector<double> WT_ModelWidget::parseInput(const QString& text) {
     QVector<double> values;
     QString cleanText = text;
@@ -213,19 +241,16 @@ void WT_ModelWidget::onShowPointsToggled(bool checked) {
 }
 
 void WT_ModelWidget::onCalculateClicked() {
-    ui->calculateButton->setEnabled(false);
-    ui->calculateButton->setText("计算中...");
-    QCoreApplication::processEvents();
+    // 计算进行中再次点击即为停止: 正在计算的曲线在当前时间点结束后返回
+    if (m_engine->isRunning()) {
+        m_engine->cancel();
+        ui->calculateButton->setEnabled(false);
+        return;
+    }
     runCalculation();
-    ui->calculateButton->setEnabled(true);
-    ui->calculateButton->setText("开始计算");
 }
 
-void WT_ModelWidget::runCalculation() {
-    MouseZoom* plot = ui->chartWidget->getPlot();
-    plot->clearGraphs();
-
-    // 1. 收集界面参数
+QMap<QString, QVector<double>> WT_ModelWidget::collectRawParams() {
     QMap<QString, QVector<double>> rawParams;
     rawParams["phi"] = parseInput(ui->phiEdit->text());
     rawParams["h"] = parseInput(ui->hEdit->text());
@@ -256,21 +281,10 @@ void WT_ModelWidget::runCalculation() {
         rawParams["cD"] = {0.0};
         rawParams["S"] = {0.0};
     }
+    return rawParams;
+}
 
-    // 2. 检查是否有敏感性参数（输入了多个值）
-    QString sensitivityKey = "";
-    QVector<double> sensitivityValues;
-    for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
-        if(it.key() == "t") continue; // 时间不作为敏感性参数
-        if(it.value().size() > 1) {
-            sensitivityKey = it.key();
-            sensitivityValues = it.value();
-            break;
-        }
-    }
-    bool isSensitivity = !sensitivityKey.isEmpty();
-
-    // 3. 准备基准参数
+QMap<QString, double> WT_ModelWidget::buildBaseParams(const QMap<QString, QVector<double>>& rawParams) const {
     QMap<QString, double> baseParams;
     for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
         baseParams[it.key()] = it.value().isEmpty() ? 0.0 : it.value().first();
@@ -278,67 +292,170 @@ void WT_ModelWidget::runCalculation() {
     baseParams["N"] = m_highPrecision ? 8.0 : 4.0;
 
     // 计算无因次缝长
-    if(baseParams["L"] > 1e-9) baseParams["LfD"] = baseParams["Lf"] / baseParams["L"];
-    else baseParams["LfD"] = 0;
+    ParameterSchema::applyDependencies(baseParams);
+    return baseParams;
+}
 
-    // 4. 准备时间步长
+QVector<double> WT_ModelWidget::buildTimeSteps(const QMap<QString, double>& baseParams) const {
     int nPoints = ui->pointsEdit->text().toInt();
     if(nPoints < 5) nPoints = 5;
     double maxTime = baseParams.value("t", 1000.0);
     if(maxTime < 1e-3) maxTime = 1000.0;
     // 使用 ModelManager 工具函数或自行实现对数时间生成
-    QVector<double> t = ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
-
-    int iterations = isSensitivity ? sensitivityValues.size() : 1;
-    iterations = qMin(iterations, (int)m_colorList.size());
-
-    QString resultTextHeader = QString("计算完成 (%1)\n").arg(getModelName());
-    if(isSensitivity) resultTextHeader += QString("敏感性参数: %1\n").arg(sensitivityKey);
-
-    // 5. 循环计算
-    for(int i = 0; i < iterations; ++i) {
-        QMap<QString, double> currentParams = baseParams;
-        double val = 0;
-        if (isSensitivity) {
-            val = sensitivityValues[i];
-            currentParams[sensitivityKey] = val;
-            // 如果修改了 L 或 Lf，重新计算 LfD
-            if (sensitivityKey == "L" || sensitivityKey == "Lf") {
-                if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
-            }
-        }
+    return ModelManager::generateLogTimeSteps(nPoints, -3.0, log10(maxTime));
+}
+
+void WT_ModelWidget::runCalculation() {
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->clearGraphs();
 
-        // 调用 ModelSolver 计算核心 (替代原有的内部计算逻辑)
-        ModelCurveData res = ModelSolver01_06::calculateTheoreticalCurve(m_type, currentParams, t, m_highPrecision);
+    // 1. 收集界面参数
+    QMap<QString, QVector<double>> rawParams = collectRawParams();
 
-        // 保存最后一次结果用于显示
-        res_tD = std::get<0>(res);
-        res_pD = std::get<1>(res);
-        res_dpD = std::get<2>(res);
+    // 2. 输入了多个值的参数均作为变化参数 (时间除外)
+    QMap<QString, QVector<double>> variations;
+    for(auto it = rawParams.begin(); it != rawParams.end(); ++it) {
+        if(it.key() == "t") continue; // 时间不作为敏感性参数
+        if(it.value().size() > 1) variations.insert(it.key(), it.value());
+    }
+    m_isSensitivity = !variations.isEmpty();
+    m_variedNames = variations.keys();
 
-        QColor curveColor = isSensitivity ? m_colorList[i] : Qt::red;
-        QString legendName;
-        if (isSensitivity) legendName = QString("%1 = %2").arg(sensitivityKey).arg(val);
-        else legendName = "理论曲线";
+    // 3. 准备基准参数 (多值参数取首值)
+    QMap<QString, double> baseParams = buildBaseParams(rawParams);
+    m_lastBaseParams = baseParams;
 
-        plotCurve(res, legendName, curveColor, isSensitivity);
+    // 4. 准备时间步长
+    QVector<double> t = buildTimeSteps(baseParams);
+
+    // 5. 生成工况并启动异步并行计算
+    SensitivityEngine::StudyMode mode = (SensitivityEngine::StudyMode)ui->comboStudyMode->currentIndex();
+    bool truncated = false;
+    QVector<SensitivityCase> cases = SensitivityEngine::buildCases(mode, baseParams, variations,
+                                                                   SensitivityEngine::MaxCases, &truncated);
+    if (truncated) {
+        QMessageBox::warning(this, "提示", QString("工况数超过 %1，仅计算前 %1 个工况。").arg(SensitivityEngine::MaxCases));
     }
 
-    // 6. 显示结果文本
-    QString resultText = resultTextHeader;
-    resultText += "t(h)\t\tDp(MPa)\t\tdDp(MPa)\n";
-    for(int i=0; i<res_pD.size(); ++i) {
-        resultText += QString("%1\t%2\t%3\n").arg(res_tD[i],0,'e',4).arg(res_pD[i],0,'e',4).arg(res_dpD[i],0,'e',4);
+    ui->calculateButton->setText(QString("停止计算 (0/%1)").arg(cases.size()));
+    ui->resultTextEdit->setText(QString("计算中 (%1 个工况)...").arg(cases.size()));
+    m_engine->start(m_type, cases, t, m_highPrecision);
+}
+
+void WT_ModelWidget::onSensitivityCurveReady(int caseIndex) {
+    const SensitivityResultTable& table = m_engine->results();
+    const int n = table.pointCount();
+    QVector<double> p(table.pressure(caseIndex), table.pressure(caseIndex) + n);
+    QVector<double> d(table.derivative(caseIndex), table.derivative(caseIndex) + n);
+    plotCurve(std::make_tuple(table.time(), p, d), table.caseAt(caseIndex).label, curveColor(caseIndex), m_isSensitivity);
+
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    if (ui->checkShowPoints->isChecked()) {
+        for (int i = plot->graphCount() - 2; i < plot->graphCount(); ++i)
+            plot->graph(i)->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 5));
+    }
+    // 首条曲线到达时确定坐标范围，此后只追加曲线；重绘合并到下一次事件循环
+    if (table.completedCount() == 1) {
+        plot->rescaleAxes();
+        if(plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
+        if(plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
     }
-    ui->resultTextEdit->setText(resultText);
+    plot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+void WT_ModelWidget::onSensitivityProgress(int done, int total) {
+    if (ui->calculateButton->isEnabled())
+        ui->calculateButton->setText(QString("停止计算 (%1/%2)").arg(done).arg(total));
+}
+
+void WT_ModelWidget::onSensitivityFinished(bool cancelled) {
+    ui->calculateButton->setEnabled(true);
+    ui->calculateButton->setText("开始计算");
+
+    // 6. 显示结果文本 (停止时保留已完成的曲线)
+    ui->resultTextEdit->setText(buildResultText(cancelled));
 
-    ui->chartWidget->getPlot()->rescaleAxes();
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->rescaleAxes();
     if(plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
     if(plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
     plot->replot();
 
     onShowPointsToggled(ui->checkShowPoints->isChecked());
-    emit calculationCompleted(getModelName(), baseParams);
+    if (!cancelled) emit calculationCompleted(getModelName(), m_lastBaseParams);
+}
+
+QString WT_ModelWidget::buildResultText(bool cancelled) const {
+    const SensitivityResultTable& table = m_engine->results();
+    QString text = QString("%1 (%2)\n").arg(cancelled ? "计算已停止" : "计算完成").arg(getModelName());
+    if (m_isSensitivity) {
+        text += QString("敏感性参数: %1\n").arg(m_variedNames.join(", "));
+        text += QString("分析方式: %1, 已完成工况 %2/%3\n")
+                    .arg(ui->comboStudyMode->currentText()).arg(table.completedCount()).arg(table.caseCount());
+
+        QVector<TornadoEntry> tornado = table.tornado();
+        if (!tornado.isEmpty()) {
+            text += "\n末时刻压差相对基准的变化 (按影响幅度排序):\n";
+            for (const TornadoEntry& e : tornado) {
+                text += QString("%1\t%2% (%1=%3) ~ %4% (%1=%5)\n").arg(e.name)
+                            .arg(e.lowChange * 100.0, 0, 'f', 2).arg(e.lowValue, 0, 'g', 6)
+                            .arg(e.highChange * 100.0, 0, 'f', 2).arg(e.highValue, 0, 'g', 6);
+            }
+        }
+        text += "\n全部工况的数据请使用\"导出数据\"。\n";
+    }
+
+    // 数据表: 第一个已完成的工况 (单因素分析即基准工况)
+    int shown = -1;
+    for (int c = 0; c < table.caseCount() && shown < 0; ++c) {
+        if (table.isComplete(c)) shown = c;
+    }
+    if (shown < 0) return text;
+    if (m_isSensitivity) text += QString("\n工况: %1\n").arg(table.caseAt(shown).label);
+
+    QVector<NumericExport::Column> columns;
+    columns.append({"t", table.time().constData()});
+    columns.append({"Dp", table.pressure(shown)});
+    columns.append({"dDp", table.derivative(shown)});
+    text += "t(h)\t\tDp(MPa)\t\tdDp(MPa)\n";
+    text += QString::fromLatin1(NumericExport::formatRows(columns, table.pointCount(), '\t', 4));
+    return text;
+}
+
+QColor WT_ModelWidget::curveColor(int index) const {
+    if (index < m_colorList.size()) return m_colorList[index];
+    return QColor::fromHsv((index * 47) % 360, 220, 200);
+}
+
+void WT_ModelWidget::onParamEditFinished() {
+    if (!m_modelManager || m_engine->isRunning()) return;
+    QSharedPointer<TypeCurveAtlas> atlas = m_modelManager->typeCurveAtlas(m_type);
+    if (!atlas || !atlas->isValid()) return;
+
+    // 只预览基准参数 (敏感性分析的多值输入取首值)，精确结果仍需点击计算
+    QMap<QString, double> baseParams = buildBaseParams(collectRawParams());
+    QVector<double> t = buildTimeSteps(baseParams);
+
+    ModelCurveData preview;
+    if (!m_modelManager->calculatePreviewCurve(m_type, baseParams, t, preview)) return;
+
+    MouseZoom* plot = ui->chartWidget->getPlot();
+    plot->clearGraphs();
+
+    QCPGraph* graphP = plot->addGraph();
+    PlotDataSource::setGraphData(graphP, PlotSeries(std::get<0>(preview), std::get<1>(preview)));
+    graphP->setPen(QPen(Qt::red, 2, Qt::DashLine));
+    graphP->setName("压力 (图版预览)");
+
+    QCPGraph* graphD = plot->addGraph();
+    PlotDataSource::setGraphData(graphD, PlotSeries(std::get<0>(preview), std::get<2>(preview)));
+    graphD->setPen(QPen(Qt::blue, 2, Qt::DashLine));
+    graphD->setName("压力导数 (图版预览)");
+
+    plot->rescaleAxes();
+    if(plot->xAxis->range().lower <= 0) plot->xAxis->setRangeLower(1e-3);
+    if(plot->yAxis->range().lower <= 0) plot->yAxis->setRangeLower(1e-3);
+    plot->replot();
 }
 
 void WT_ModelWidget::plotCurve(const ModelCurveData& data, const QString& name, QColor color, bool isSensitivity) {
@@ -349,11 +466,11 @@ void WT_ModelWidget::plotCurve(const ModelCurveData& data, const QString& name,
     const QVector<double>& d = std::get<2>(data);
 
     QCPGraph* graphP = plot->addGraph();
-    graphP->setData(t, p);
+    PlotDataSource::setGraphData(graphP, PlotSeries(t, p));
     graphP->setPen(QPen(color, 2, Qt::SolidLine));
 
     QCPGraph* graphD = plot->addGraph();
-    graphD->setData(t, d);
+    PlotDataSource::setGraphData(graphD, PlotSeries(t, d));
 
     if (isSensitivity) {
         graphD->setPen(QPen(color, 2, Qt::DashLine));
@@ -368,20 +485,16 @@ void WT_ModelWidget::plotCurve(const ModelCurveData& data, const QString& name,
 }
 
 void WT_ModelWidget::onExportData() {
-    if (res_tD.isEmpty()) return;
+    const SensitivityResultTable& table = m_engine->results();
+    if (table.completedCount() == 0) return;
     QString defaultDir = ModelParameter::instance()->getProjectPath();
     if(defaultDir.isEmpty()) defaultDir = ".";
-    QString path = QFileDialog::getSaveFileName(this, "导出CSV数据", defaultDir + "/CalculatedData.csv", "CSV Files (*.csv)");
+    QString path = QFileDialog::getSaveFileName(this, "导出数据", defaultDir + "/CalculatedData.csv", NumericExport::fileFilter());
     if (path.isEmpty()) return;
-    QFile f(path);
-    if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&f);
-        out << "t,Dp,dDp\n";
-        for (int i = 0; i < res_tD.size(); ++i) {
-            double dp = (i < res_dpD.size()) ? res_dpD[i] : 0.0;
-            out << res_tD[i] << "," << res_pD[i] << "," << dp << "\n";
-        }
-        f.close();
+    QString error;
+    if (table.write(path, NumericExport::formatForFile(path), &error)) {
         QMessageBox::information(this, "导出成功", "数据文件已保存");
+    } else {
+        QMessageBox::critical(this, "错误", "导出失败: " + error);
     }
 }
@@ -18,12 +18,15 @@
 #include <tuple>
 #include "modelenums.h"
 #include "modelsolver01_06.h" // 引用模型求解器类型
+#include "sensitivityengine.h"
 #include "chartwidget.h"
 
 namespace Ui {
 class WT_ModelWidget;
 }
 
+class ModelManager;
+
 class WT_ModelWidget : public QWidget
 {
     Q_OBJECT
@@ -36,6 +39,9 @@ public:
     // 设置是否使用高精度计算(更多的Stehfest项数)
     void setHighPrecision(bool high);
 
+    // 设置模型管理器 (用于查询类型曲线图版，实现参数修改后的即时预览)
+    void setModelManager(ModelManager* manager);
+
     // 获取当前模型名称（用于显示）
     QString getModelName() const;
 
@@ -53,6 +59,12 @@ public slots:
     void onDependentParamsChanged();    // 相关参数变更(如 L, Lf -> LfD)
     void onShowPointsToggled(bool checked); // 切换显示数据点
     void onExportData();                // 导出数据
+    void onParamEditFinished();         // 参数编辑完成: 用图版插值即时预览
+
+private slots:
+    void onSensitivityCurveReady(int caseIndex);    // 一个工况计算完成: 立即绘制
+    void onSensitivityProgress(int done, int total);
+    void onSensitivityFinished(bool cancelled);     // 全部工况完成或已停止
 
 private:
     // 初始化界面控件状态
@@ -61,8 +73,18 @@ private:
     void initChart();
     // 建立信号槽连接
     void setupConnections();
-    // 执行计算流程
+    // 执行计算流程 (生成工况并交给敏感性引擎异步计算)
     void runCalculation();
+    // 收集界面参数 (逗号分隔的多个值用于敏感性分析)
+    QMap<QString, QVector<double>> collectRawParams();
+    // 由原始参数表组装基准参数 (取首值，并计算 LfD)
+    QMap<QString, double> buildBaseParams(const QMap<QString, QVector<double>>& rawParams) const;
+    // 按界面设置生成计算时间序列
+    QVector<double> buildTimeSteps(const QMap<QString, double>& baseParams) const;
+    // 生成结果文本 (基准曲线数据表，单因素分析附影响排序)
+    QString buildResultText(bool cancelled) const;
+    // 第 index 条曲线的颜色 (超出预设颜色表时按色相均匀生成)
+    QColor curveColor(int index) const;
 
     // 辅助工具函数
     QVector<double> parseInput(const QString& text);
@@ -73,12 +95,14 @@ private:
     Ui::WT_ModelWidget *ui;
     ModelType m_type;
     bool m_highPrecision;
+    ModelManager* m_modelManager;
     QList<QColor> m_colorList; // 曲线颜色列表
 
-    // 缓存计算结果
-    QVector<double> res_tD;
-    QVector<double> res_pD;
-    QVector<double> res_dpD;
+    // 敏感性分析引擎 (计算结果保存在其结果表中)
+    SensitivityEngine* m_engine;
+    bool m_isSensitivity;                   // 本次计算是否为多工况
+    QStringList m_variedNames;              // 本次的变化参数
+    QMap<QString, double> m_lastBaseParams; // 本次的基准参数
 };
 
 #endif // WT_MODELWIDGET_H
@@ -9,6 +9,7 @@
  * - 压力产量/导数分析：坐标轴标签恢复为标准默认值 ("Time", "Pressure" 等)。
  * - 新建曲线：坐标轴标签继续使用列名。
  * 4. 新建窗口修复：确保新建窗口中的图表也能正确显示线型和标签。
+ * 5. 反褶积分析：选中压力产量曲线后在线程池中计算，结果以双对数图显示并加入曲线列表。
  */
 
 #include "wt_plottingwidget.h"
@@ -20,6 +21,9 @@
 #include "chartwindow.h"
 #include "modelparameter.h"
 #include "chartsetting1.h"
+#include "deconvolutiondialog.h"
+#include "plotdatasource.h"
+#include "numericexport.h"
 
 #include <QMessageBox>
 #include <QFileDialog>
@@ -31,6 +35,7 @@
 #include <QtMath>
 #include <QDebug>
 #include <QSplitter>
+#include <QtConcurrent>
 
 // ============================================================================
 // 辅助函数与 CurveInfo 实现
@@ -159,6 +164,8 @@ WT_PlottingWidget::WT_PlottingWidget(QWidget *parent) :
 
 WT_PlottingWidget::~WT_PlottingWidget()
 {
+    m_deconvCancel.cancel();
+    m_deconvFuture.waitForFinished();
     qDeleteAll(m_openedWindows);
     delete ui;
 }
@@ -278,7 +285,7 @@ void WT_PlottingWidget::on_btn_NewCurve_clicked()
 
             QCPGraph* graph = cw->getPlot()->addGraph();
             graph->setName(info.legendName);
-            graph->setData(info.xData, info.yData);
+            PlotDataSource::setGraphData(graph, PlotSeries(info.xData, info.yData));
             graph->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
             // 【修复】尊重弹窗选择的线型
@@ -357,7 +364,7 @@ void WT_PlottingWidget::on_btn_PressureRate_clicked()
                 bottom->axis(QCPAxis::atBottom)->setLabel(timeLabel);
 
                 QCPGraph* gPress = plot->addGraph(top->axis(QCPAxis::atBottom), top->axis(QCPAxis::atLeft));
-                gPress->setData(info.xData, info.yData);
+                PlotDataSource::setGraphData(gPress, PlotSeries(info.xData, info.yData));
                 gPress->setName(info.legendName);
                 gPress->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
@@ -368,10 +375,10 @@ void WT_PlottingWidget::on_btn_PressureRate_clicked()
                 QCPGraph* gProd = plot->addGraph(bottom->axis(QCPAxis::atBottom), bottom->axis(QCPAxis::atLeft));
                 gProd->setName(info.prodLegendName);
                 if(info.prodGraphType == 0) {
-                    gProd->setData(info.x2Data, info.y2Data);
+                    PlotDataSource::setGraphData(gProd, PlotSeries(info.x2Data, info.y2Data));
                     gProd->setLineStyle(QCPGraph::lsStepLeft); // 阶梯图
                 } else {
-                    gProd->setData(info.x2Data, info.y2Data);
+                    PlotDataSource::setGraphData(gProd, PlotSeries(info.x2Data, info.y2Data));
                     gProd->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, info.prodColor, info.prodColor, 6));
                     gProd->setLineStyle(QCPGraph::lsNone); // 散点图
                 }
@@ -482,7 +489,7 @@ void WT_PlottingWidget::on_btn_Derivative_clicked()
             cw->getPlot()->yAxis->setLabel("Pressure & Derivative");
 
             QCPGraph* g1 = cw->getPlot()->addGraph();
-            g1->setData(info.xData, info.yData);
+            PlotDataSource::setGraphData(g1, PlotSeries(info.xData, info.yData));
             g1->setName(info.legendName);
             g1->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
             // 【修复】尊重弹窗线型
@@ -490,7 +497,7 @@ void WT_PlottingWidget::on_btn_Derivative_clicked()
             g1->setLineStyle(info.lineStyle == Qt::NoPen ? QCPGraph::lsNone : QCPGraph::lsLine);
 
             QCPGraph* g2 = cw->getPlot()->addGraph();
-            g2->setData(info.xData, info.derivData);
+            PlotDataSource::setGraphData(g2, PlotSeries(info.xData, info.derivData));
             g2->setName(info.prodLegendName);
             g2->setScatterStyle(QCPScatterStyle(info.derivShape, info.derivPointColor, info.derivPointColor, 6));
             // 【修复】尊重弹窗线型
@@ -513,6 +520,155 @@ void WT_PlottingWidget::on_btn_Derivative_clicked()
     }
 }
 
+// 4. 反褶积分析 (基于选中的压力产量曲线)
+void WT_PlottingWidget::on_btn_Deconvolution_clicked()
+{
+    if(m_deconvProgress) return;
+
+    QListWidgetItem* item = getCurrentSelectedItem();
+    if(!item || !m_curves.contains(item->text()) || m_curves[item->text()].type != 1) {
+        QMessageBox::warning(this, "提示", "请先在列表中选择一条压力产量曲线。");
+        return;
+    }
+    const CurveInfo source = m_curves[item->text()];
+
+    DeconvolutionDialog dlg(source.yData.isEmpty() ? 0.0 : source.yData.first(), this);
+    applyDialogStyle(&dlg);
+    if(dlg.exec() != QDialog::Accepted) return;
+
+    RateHistory rates = dlg.isDurationColumn() ? RateHistory::fromDurations(source.x2Data, source.y2Data)
+                                               : RateHistory::fromSamples(source.x2Data, source.y2Data);
+    if(rates.isEmpty()) {
+        QMessageBox::warning(this, "错误", "产量数据无效，无法构造产量历史。");
+        return;
+    }
+    DeconvolutionOptions options = dlg.getOptions();
+
+    m_deconvCancel = CancellationToken::create();
+    m_deconvProgress = new QProgressDialog("正在进行反褶积计算...", "停止", 0, options.maxIterations, this);
+    m_deconvProgress->setWindowTitle("反褶积分析");
+    m_deconvProgress->setWindowModality(Qt::WindowModal);
+    m_deconvProgress->setMinimumDuration(0);
+    applyDialogStyle(m_deconvProgress);
+    CancellationToken cancel = m_deconvCancel;
+    connect(m_deconvProgress, &QProgressDialog::canceled, this, [cancel]() { cancel.cancel(); });
+    m_deconvProgress->show();
+
+    QString sourceName = source.name;
+    QVector<double> t = source.xData, p = source.yData;
+    m_deconvFuture = QtConcurrent::run([this, sourceName, t, p, rates, options, cancel]() {
+        DeconvolutionResult result = Deconvolution::run(t, p, rates, options, cancel, [this](int done, int) {
+            QMetaObject::invokeMethod(this, [this, done]() {
+                if(m_deconvProgress) m_deconvProgress->setValue(done);
+            }, Qt::QueuedConnection);
+        });
+        QMetaObject::invokeMethod(this, [this, sourceName, result]() {
+            onDeconvolutionFinished(sourceName, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void WT_PlottingWidget::onDeconvolutionFinished(const QString& sourceName, const DeconvolutionResult& result)
+{
+    if(m_deconvProgress) m_deconvProgress->deleteLater();
+    m_deconvProgress = nullptr;
+
+    if(!result.valid) {
+        QMessageBox::warning(this, "反褶积分析", result.message.isEmpty() ? QString("计算失败。") : result.message);
+        return;
+    }
+
+    // 结果按导数类曲线保存: x 为时滞，y 为参考产量下的压差，导数列为对数导数
+    CurveInfo info;
+    info.name = sourceName + "_反褶积";
+    for(int k = 2; m_curves.contains(info.name); ++k) info.name = sourceName + QString("_反褶积%1").arg(k);
+    info.legendName = "反褶积压差";
+    info.prodLegendName = "反褶积导数";
+    info.type = 2;
+    info.xCol = -1; info.yCol = -1;
+    info.xData = result.lag;
+    info.yData = result.pressure;
+    info.derivData = result.derivative;
+    info.testType = 0;
+    info.initialPressure = result.initialPressure;
+    info.LSpacing = 0.0;
+    info.isSmooth = false;
+    info.smoothFactor = 0;
+    info.pointShape = QCPScatterStyle::ssCircle; info.pointColor = Qt::red;
+    info.lineStyle = Qt::SolidLine; info.lineColor = Qt::red;
+    info.derivShape = QCPScatterStyle::ssTriangle; info.derivPointColor = Qt::blue;
+    info.derivLineStyle = Qt::SolidLine; info.derivLineColor = Qt::blue;
+
+    m_curves.insert(info.name, info);
+    ui->listWidget_Curves->addItem(info.name);
+
+    // 双对数响应图
+    QSharedPointer<QCPAxisTickerLog> logTicker(new QCPAxisTickerLog);
+    ChartWindow* w = new ChartWindow();
+    w->setWindowTitle(info.name);
+    ChartWidget* cw = w->getChartWidget();
+    cw->setChartMode(ChartWidget::Mode_Single);
+    cw->setTitle(info.name);
+    MouseZoom* plot = cw->getPlot();
+    plot->xAxis->setLabel("Time");
+    plot->yAxis->setLabel(QString("Pressure & Derivative (q = %1)").arg(result.referenceRate, 0, 'g', 5));
+    plot->xAxis->setScaleType(QCPAxis::stLogarithmic); plot->xAxis->setTicker(logTicker);
+    plot->yAxis->setScaleType(QCPAxis::stLogarithmic); plot->yAxis->setTicker(logTicker);
+
+    QCPGraph* g1 = plot->addGraph();
+    PlotDataSource::setGraphData(g1, PlotSeries(info.xData, info.yData));
+    g1->setName(info.legendName);
+    g1->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 5));
+    g1->setPen(QPen(info.lineColor, 2, info.lineStyle));
+
+    QCPGraph* g2 = plot->addGraph();
+    PlotDataSource::setGraphData(g2, PlotSeries(info.xData, info.derivData));
+    g2->setName(info.prodLegendName);
+    g2->setScatterStyle(QCPScatterStyle(info.derivShape, info.derivPointColor, info.derivPointColor, 5));
+    g2->setPen(QPen(info.derivLineColor, 2, info.derivLineStyle));
+
+    plot->rescaleAxes();
+    plot->replot();
+    w->show();
+    m_openedWindows.append(w);
+
+    // 重构压力与实测压力对比 (质量检查)
+    ChartWindow* wq = new ChartWindow();
+    wq->setWindowTitle(info.name + " - 压力重构");
+    ChartWidget* cq = wq->getChartWidget();
+    cq->setChartMode(ChartWidget::Mode_Single);
+    cq->setTitle(info.name + " - 压力重构");
+    MouseZoom* qcPlot = cq->getPlot();
+    qcPlot->xAxis->setLabel("Time");
+    qcPlot->yAxis->setLabel("Pressure");
+
+    QCPGraph* gObs = qcPlot->addGraph();
+    PlotDataSource::setGraphData(gObs, PlotSeries(result.fitTime, result.fitPressure));
+    gObs->setName("实测压力");
+    gObs->setLineStyle(QCPGraph::lsNone);
+    gObs->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, Qt::gray, Qt::gray, 4));
+
+    QCPGraph* gModel = qcPlot->addGraph();
+    PlotDataSource::setGraphData(gModel, PlotSeries(result.fitTime, result.modelPressure));
+    gModel->setName("重构压力");
+    gModel->setPen(QPen(Qt::red, 2));
+
+    qcPlot->rescaleAxes();
+    qcPlot->replot();
+    wq->show();
+    m_openedWindows.append(wq);
+
+    QMessageBox::information(this, "反褶积分析",
+        QString("反褶积完成。\n参考产量: %1\n初始压力: %2\n压力拟合均方根误差: %3\n"
+                "产量最大修正: %4%\n迭代次数: %5，参与计算点数: %6")
+            .arg(result.referenceRate, 0, 'g', 6)
+            .arg(result.initialPressure, 0, 'f', 3)
+            .arg(result.rmsError, 0, 'g', 4)
+            .arg(result.maxRateChange * 100.0, 0, 'f', 2)
+            .arg(result.iterations)
+            .arg(result.pointsUsed));
+}
+
 // ---------------- 绘图具体实现 ----------------
 
 void WT_PlottingWidget::addCurveToPlot(const CurveInfo& info)
@@ -521,7 +677,7 @@ void WT_PlottingWidget::addCurveToPlot(const CurveInfo& info)
 
     QCPGraph* graph = plot->addGraph();
     graph->setName(info.legendName);
-    graph->setData(info.xData, info.yData);
+    PlotDataSource::setGraphData(graph, PlotSeries(info.xData, info.yData));
     graph->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
     // 【修复】尊重弹窗中选择的线型 (info.lineStyle)
@@ -541,7 +697,7 @@ void WT_PlottingWidget::drawStackedPlot(const CurveInfo& info)
     if (!topRect || !bottomRect) return;
 
     m_graphPress = plot->addGraph(topRect->axis(QCPAxis::atBottom), topRect->axis(QCPAxis::atLeft));
-    m_graphPress->setData(info.xData, info.yData);
+    PlotDataSource::setGraphData(m_graphPress, PlotSeries(info.xData, info.yData));
     m_graphPress->setName(info.legendName);
     m_graphPress->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
@@ -573,7 +729,7 @@ void WT_PlottingWidget::drawStackedPlot(const CurveInfo& info)
         m_graphProd->setPen(QPen(info.prodColor, 2));
         m_graphProd->setLineStyle(QCPGraph::lsNone);
     }
-    m_graphProd->setData(px, py);
+    PlotDataSource::setGraphData(m_graphProd, PlotSeries(px, py));
     m_graphProd->setName(info.prodLegendName);
 
     m_graphPress->rescaleAxes();
@@ -585,14 +741,15 @@ void WT_PlottingWidget::drawDerivativePlot(const CurveInfo& info)
 {
     MouseZoom* plot = ui->customPlot->getPlot();
 
+    // 长时间压力计数据点数很多，按视图抽稀显示 (坐标轴类型改变时自动重建)
     QCPGraph* g1 = plot->addGraph();
     g1->setName(info.legendName);
-    g1->setData(info.xData, info.yData);
+    plot->setLodData(g1, info.xData, info.yData);
     g1->setScatterStyle(QCPScatterStyle(info.pointShape, info.pointColor, info.pointColor, 6));
 
     QCPGraph* g2 = plot->addGraph();
     g2->setName(info.prodLegendName);
-    g2->setData(info.xData, info.derivData);
+    plot->setLodData(g2, info.xData, info.derivData);
     g2->setScatterStyle(QCPScatterStyle(info.derivShape, info.derivPointColor, info.derivPointColor, 6));
 
     // 【修复】尊重弹窗线型
@@ -705,37 +862,52 @@ void WT_PlottingWidget::onGraphClicked(QCPAbstractPlottable *plottable, int data
 void WT_PlottingWidget::executeExport(bool fullRange, double start, double end)
 {
     QString name = m_projectPath + "/export.csv";
-    QString file = QFileDialog::getSaveFileName(this, "保存", name, "CSV Files (*.csv);;Excel Files (*.xls);;Text Files (*.txt)");
+    QString file = QFileDialog::getSaveFileName(this, "保存", name, "CSV Files (*.csv);;Excel Files (*.xls);;Text Files (*.txt);;Binary Files (*.bin)");
     if(file.isEmpty()) return;
-    QFile f(file);
-    if(!f.open(QIODevice::WriteOnly | QIODevice::Text)) return;
-    QTextStream out(&f);
-    QString sep = ",";
-    if(file.endsWith(".txt") || file.endsWith(".xls")) sep = "\t";
 
     CurveInfo& info = m_curves[m_currentDisplayedCurve];
-
-    if(ui->customPlot->getChartMode() == ChartWidget::Mode_Stacked) {
-        out << (fullRange ? "Time,P,Q\n" : "AdjTime,P,Q,OrigTime\n");
-        for(int i=0; i<info.xData.size(); ++i) {
-            double t = info.xData[i];
-            if(!fullRange && (t < start || t > end)) continue;
-            double p = info.yData[i];
-            double q = getProductionValueAt(t, info);
-            if(fullRange) out << t << sep << p << sep << q << "\n";
-            else out << (t-start) << sep << p << sep << q << sep << t << "\n";
-        }
-    } else {
-        out << (fullRange ? "Time,Value\n" : "AdjTime,Value,OrigTime\n");
-        for(int i=0; i<info.xData.size(); ++i) {
+    const bool stacked = (ui->customPlot->getChartMode() == ChartWidget::Mode_Stacked);
+    const int n = qMin(info.xData.size(), info.yData.size());
+
+    // 全范围导出直接引用曲线数据；按时间段导出时先筛出范围内的行
+    const double* tData = info.xData.constData();
+    const double* vData = info.yData.constData();
+    qint64 rows = n;
+    QVector<double> adjTime, origTime, value, prod;
+    if(!fullRange) {
+        for(int i=0; i<n; ++i) {
             double t = info.xData[i];
-            if(!fullRange && (t < start || t > end)) continue;
-            double val = info.yData[i];
-            if(fullRange) out << t << sep << val << "\n";
-            else out << (t-start) << sep << val << sep << t << "\n";
+            if(t < start || t > end) continue;
+            adjTime.append(t - start);
+            origTime.append(t);
+            value.append(info.yData[i]);
         }
+        tData = origTime.constData();
+        vData = value.constData();
+        rows = origTime.size();
+    }
+
+    QVector<NumericExport::Column> columns;
+    columns.append({fullRange ? "Time" : "AdjTime", fullRange ? tData : adjTime.constData()});
+    columns.append({stacked ? "P" : "Value", vData});
+    if(stacked) {
+        prod.resize(rows);
+        for(qint64 i=0; i<rows; ++i) prod[i] = getProductionValueAt(tData[i], info);
+        columns.append({"Q", prod.constData()});
+    }
+    if(!fullRange) columns.append({"OrigTime", origTime.constData()});
+
+    QString error;
+    if(!NumericExport::write(file, NumericExport::formatForFile(file), columns, rows, &error)) {
+        QMessageBox msg(this);
+        msg.setWindowTitle("错误");
+        msg.setText("导出失败: " + error);
+        msg.setIcon(QMessageBox::Critical);
+        msg.setStandardButtons(QMessageBox::Ok);
+        applyDialogStyle(&msg);
+        msg.exec();
+        return;
     }
-    f.close();
     QMessageBox msg(this);
     msg.setWindowTitle("成功");
     msg.setText("导出完成。");
@@ -5,6 +5,7 @@
  * 1. 管理试井分析曲线的创建、显示、修改和删除。
  * 2. 与 ChartWidget 交互，管理绘图逻辑。
  * 3. 强制黑字白底样式，优化左侧功能布局。
+ * 4. 反褶积分析: 对选中的压力产量曲线在后台求取定产量响应，结果作为导数类曲线保存。
  */
 
 #ifndef WT_PLOTTINGWIDGET_H
@@ -14,8 +15,12 @@
 #include <QStandardItemModel>
 #include <QMap>
 #include <QListWidgetItem>
+#include <QPointer>
+#include <QProgressDialog>
+#include <QFuture>
 #include "chartwidget.h"
 #include "chartwindow.h"
+#include "deconvolution.h"
 
 // 曲线配置结构体
 struct CurveInfo {
@@ -76,6 +81,7 @@ private slots:
     void on_btn_NewCurve_clicked();
     void on_btn_PressureRate_clicked();
     void on_btn_Derivative_clicked();
+    void on_btn_Deconvolution_clicked();
 
     void on_listWidget_Curves_itemDoubleClicked(QListWidgetItem *item);
 
@@ -104,9 +110,15 @@ private:
     QCPGraph* m_graphPress;
     QCPGraph* m_graphProd;
 
+    // 反褶积后台计算 (析构时取消并等待结束，后台任务不再访问已销毁的界面)
+    CancellationToken m_deconvCancel;
+    QFuture<void> m_deconvFuture;
+    QPointer<QProgressDialog> m_deconvProgress;
+
     void addCurveToPlot(const CurveInfo& info);
     void drawStackedPlot(const CurveInfo& info);
     void drawDerivativePlot(const CurveInfo& info);
+    void onDeconvolutionFinished(const QString& sourceName, const DeconvolutionResult& result);
 
     void executeExport(bool fullRange, double start = 0, double end = 0);
     double getProductionValueAt(double t, const CurveInfo& info);
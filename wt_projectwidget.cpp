@@ -6,12 +6,14 @@
  * 2. 实现"新建"、"打开"、"关闭"、"退出"的详细交互逻辑。
  * 3. 修复了双重弹窗问题：操作成功后不在此处弹窗，而是发送信号由主界面统一提示。
  * 4. 统一了所有交互弹窗的样式为白底黑字。
+ * 5. "监测" 入口打开实时监测窗口 (LiveGaugeWidget)，不依赖项目是否打开。
  */
 
 #include "wt_projectwidget.h"
 #include "ui_wt_projectwidget.h"
 #include "newprojectdialog.h"
 #include "modelparameter.h" // 全局参数管理类
+#include "livegaugewidget.h"
 
 #include <QDebug>
 #include <QFileDialog>
@@ -121,6 +123,16 @@ void WT_ProjectWidget::init()
     QPalette pal4 = ui->MonitState4->palette(); pal4.setColor(QPalette::Window, backgroundColor); ui->MonitState4->setPalette(pal4);
     ui->MonitState4->setFont(bigFont);
     connect(ui->MonitState4, SIGNAL(sigClicked()), this, SLOT(onExitClicked()));
+
+    // 5. 配置 "监测" 按钮 (实时数据采集，不依赖项目状态)
+    QString centerPicStyle5 = "border-image: url(:/new/prefix1/Resource/X3.png);";
+    ui->MonitState5->setTextInfo(centerPicStyle5, topPicStyle, topName, "监测");
+    ui->MonitState5->setFixedSize(128, 160);
+    ui->MonitState5->setStyleSheet(forceStyle);
+    ui->MonitState5->setAutoFillBackground(true);
+    QPalette pal5 = ui->MonitState5->palette(); pal5.setColor(QPalette::Window, backgroundColor); ui->MonitState5->setPalette(pal5);
+    ui->MonitState5->setFont(bigFont);
+    connect(ui->MonitState5, SIGNAL(sigClicked()), this, SLOT(onMonitorClicked()));
 }
 
 void WT_ProjectWidget::setProjectState(bool isOpen, const QString& filePath)
@@ -350,6 +362,19 @@ void WT_ProjectWidget::onLoadFileClicked()
     msgBox.exec();
 }
 
+// 实时监测窗口: 以独立窗口显示，随主界面一同关闭
+void WT_ProjectWidget::onMonitorClicked()
+{
+    if (!m_liveWindow) {
+        m_liveWindow = new LiveGaugeWidget(this);
+        m_liveWindow->setWindowFlag(Qt::Window);
+        m_liveWindow->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    m_liveWindow->show();
+    m_liveWindow->raise();
+    m_liveWindow->activateWindow();
+}
+
 // ============================================================================
 // 私有辅助函数
 // ============================================================================
@@ -6,6 +6,7 @@
  * 2. 维护当前项目的打开状态 (m_isProjectOpen) 和项目路径信息。
  * 3. 声明各个按钮点击后的槽函数，实现基于状态的交互逻辑判断。
  * 4. 提供统一的弹窗样式获取函数。
+ * 5. "监测" 入口打开实时数据采集窗口。
  */
 
 #ifndef WT_PROJECTWIDGET_H
@@ -13,6 +14,9 @@
 
 #include <QWidget>
 #include <QString>
+#include <QPointer>
+
+class LiveGaugeWidget;
 
 // 前向声明 UI 类
 namespace Ui {
@@ -63,6 +67,9 @@ private slots:
     // 槽函数：点击"读取"按钮 (备用功能)
     void onLoadFileClicked();
 
+    // 槽函数：点击"监测"按钮，打开实时监测窗口 (已打开时切换到前台)
+    void onMonitorClicked();
+
 private:
     Ui::WT_ProjectWidget *ui;
 
@@ -72,6 +79,9 @@ private:
     // 变量：当前打开的项目文件完整路径
     QString m_currentProjectFilePath;
 
+    // 实时监测窗口 (独立窗口，关闭时自动释放)
+    QPointer<LiveGaugeWidget> m_liveWindow;
+
     // 辅助函数：执行保存项目的逻辑
     // 返回值 true 表示保存成功，false 表示失败
     bool saveCurrentProject();